@@ -0,0 +1,212 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_BIT_BOARD_H_
+#define VT_BIT_BOARD_H_
+
+#include <Boundary.h>
+#include <LifeKernel.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BITBOARD_WORD_BITS  64
+#define BITBOARD_TILE_ROWS  64 // 64 rows x 16 words = 8KB per tile per buffer
+#define BITBOARD_TILE_WORDS 16
+
+// NOTE: the k-row halo of a temporally blocked tile must lie within its neighbor tiles (and within one word)
+#define BITBOARD_MAX_BLOCK_GENERATIONS BITBOARD_TILE_ROWS
+
+namespace vt {
+
+class ThreadPool;
+
+// bit-packed Conway board; 64 cells per word, stepped with a bit-sliced adder (see LifeKernel.h)
+// NOTE: each row has one zero guard word on either side and the board has one zero guard row above and below,
+//       so the kernel never branches on borders; other boundary modes fill them in before each generation
+class BitBoard
+{
+public:
+    explicit BitBoard(glm::ivec2 dim);
+    virtual ~BitBoard();
+
+    // accessors
+    glm::ivec2 get_dim() const       { return m_dim; }
+    int get_words_per_row() const    { return m_words_per_row; }
+    int get_stride() const           { return m_stride; }
+    long get_generation() const      { return m_generation; }
+    double get_elapsed_time() const  { return m_elapsed_time; } // seconds spent in step()
+    double get_generations_per_sec() const;
+    size_t get_population() const;
+
+    // first data word of row y; y == -1 and y == height are the guard rows
+    uint64_t* get_row(int y) const
+    {
+        return m_words + (y + 1) * m_stride + 1;
+    }
+    // cells born (neighbor sum == 3) in the last step; needed to tell GROW_COLOR from LIVE_COLOR
+    uint64_t* get_grow_row(int y) const
+    {
+        return m_grow_words + (y + 1) * m_stride + 1;
+    }
+
+    // cursor in texture space; glm::ivec2(-1) to disable seeding
+    void set_cursor_pos(glm::ivec2 cursor_pos)
+    {
+        m_cursor_pos = cursor_pos;
+    }
+    glm::ivec2 get_cursor_pos() const
+    {
+        return m_cursor_pos;
+    }
+
+    // for a board that is one strip of a larger one (see StripBoard): the rows just above and below it, copied into
+    // the guard rows before the next step; NULL for dead cells
+    // NOTE: edge tiles whose halo changed since the last call are re-evaluated, as if a neighbor tile had changed
+    void set_guard_rows(const uint64_t* above, const uint64_t* below);
+
+    // basic modifiers
+    bool get_cell(glm::ivec2 pos) const;
+    void set_cell(glm::ivec2 pos, bool alive);
+    void clear();
+
+    // texture interop (Texture::RED layout, see Texture::get_pixel_r32f/set_pixel_r32f)
+    void load_r32f(const float* pixels);
+    void store_r32f(float* pixels) const;
+
+    // simd variant; defaults to the best one the cpu supports
+    life_kernel_type_t get_kernel_type() const
+    {
+        return m_kernel_type;
+    }
+    bool set_kernel_type(life_kernel_type_t kernel_type);
+
+    // life-like rule (see LifeRule.h); known rules get a kernel specialized at compile time
+    life_rule_t get_rule() const
+    {
+        return m_rule;
+    }
+    void set_rule(life_rule_t rule);
+
+    // what off-board neighbors read as (see Boundary.h); defaults to dead
+    // NOTE: torus and mirror copy the edge cells into the guard words and rows before each generation (and take the
+    //       column halo back out after it), and step one generation per tile pass; a board given its guard rows
+    //       by set_guard_rows must stay dead
+    void set_boundary_mode(boundary_mode_t boundary_mode);
+    boundary_mode_t get_boundary_mode() const
+    {
+        return m_boundary_mode;
+    }
+
+    // cache-sized tiles stepped in parallel, one barrier per generation; NULL for single-threaded
+    void set_thread_pool(ThreadPool* thread_pool)
+    {
+        m_thread_pool = thread_pool;
+    }
+    ThreadPool* get_thread_pool() const
+    {
+        return m_thread_pool;
+    }
+    int get_tile_count() const
+    {
+        return m_tile_dim.x * m_tile_dim.y;
+    }
+
+    // only step tiles that changed in the last generation, and their neighbors
+    // NOTE: an unchanged tile's output buffer already holds the same cells (ping-pong stays valid)
+    void set_skip_stable_tiles(bool skip_stable_tiles);
+    bool get_skip_stable_tiles() const
+    {
+        return m_skip_stable_tiles;
+    }
+    bool is_tile_changed(int tile_index) const
+    {
+        return m_tile_changed[tile_index];
+    }
+    int get_active_tile_count() const  { return m_active_tiles.size(); } // stepped in the last generation
+    long get_tiles_stepped() const     { return m_tiles_stepped; } // one per tile per generation
+
+    // temporal blocking; each tile pass copies the tile plus a k-cell halo into a per-thread scratch buffer,
+    // advances k generations in cache and writes back once (1 steps straight between the board buffers)
+    void set_block_generations(int block_generations);
+    int get_block_generations() const
+    {
+        return m_block_generations;
+    }
+    double get_bytes_per_generation() const; // board buffer reads + writes (excluding scratch)
+
+    // hash of the live cells (grow bits excluded), for cycle detection (see CycleDetector.h)
+    // NOTE: xor of per-tile hashes; only tiles that changed since the last call are rehashed
+    uint64_t get_hash();
+
+    // core functionality
+    void step(int iters = 1);
+    void skip_generations(long generations, int period); // board known to repeat every period generations
+    void reset_stats();
+
+private:
+    glm::ivec2         m_dim;
+    int                m_words_per_row;
+    int                m_stride;
+    uint64_t           m_last_word_mask;
+    uint64_t*          m_words;      // input
+    uint64_t*          m_words2;     // output
+    uint64_t*          m_grow_words; // output
+    life_kernel_type_t m_kernel_type;
+    life_kernel_t      m_kernel;
+    life_rule_t        m_rule;
+    boundary_mode_t    m_boundary_mode;
+    ThreadPool*        m_thread_pool;
+    glm::ivec2         m_tile_dim; // in tiles
+    bool               m_skip_stable_tiles;
+    std::vector<char>  m_tile_changed;  // input
+    std::vector<char>  m_tile_changed2; // output
+    std::vector<uint64_t> m_tile_hash;
+    std::vector<char>  m_tile_hash_dirty;
+    uint64_t           m_hash;
+    std::vector<int>   m_active_tiles;
+    long               m_tiles_stepped;
+    int                m_block_generations;
+    int                m_prev_block_generations;
+    std::vector<std::vector<uint64_t> > m_scratch; // per thread
+    double             m_bytes_moved;
+    glm::ivec2         m_cursor_pos;
+    std::vector<uint64_t> m_guard_rows[2]; // last halo given to set_guard_rows (above, below)
+    long               m_generation;
+    double             m_elapsed_time;
+
+    uint64_t* get_row2(int y) const
+    {
+        return m_words2 + (y + 1) * m_stride + 1;
+    }
+    void step_generation();
+    void step_block(int generations);
+    void step_tile(int tile_index);
+    void step_tile_block(int tile_index, int generations, int thread_index);
+    double get_tile_bytes(int tile_index, int halo_rows) const;
+    uint64_t get_tile_hash(int tile_index) const;
+    void mark_all_tiles_changed();
+    void update_active_tiles();
+    void fill_halo();
+    void clear_halo();
+};
+
+}
+
+#endif
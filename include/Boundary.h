@@ -0,0 +1,43 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_BOUNDARY_H_
+#define VT_BOUNDARY_H_
+
+namespace vt {
+
+// what a cell just off the board reads as
+// NOTE: engines resolve the mode once per row (halo rows and columns), never per neighbor fetch; on the gpu it is
+//       the sampler wrap state of the cell texture (see Texture::set_boundary_mode)
+enum boundary_mode_t {
+    BOUNDARY_DEAD,   // dead cells (GL_CLAMP_TO_BORDER with a zero border)
+    BOUNDARY_TORUS,  // the opposite edge (GL_REPEAT)
+    BOUNDARY_MIRROR, // the edge cell itself (GL_MIRRORED_REPEAT)
+    BOUNDARY_COUNT
+};
+
+const char* get_boundary_mode_name(boundary_mode_t mode);
+bool find_boundary_mode(const char* name, boundary_mode_t* mode); // out
+
+// board row (or column) read for index -1 or dim; -1 for a dead cell
+int get_boundary_index(boundary_mode_t mode, int index, int dim);
+
+}
+
+#endif
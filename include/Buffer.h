@@ -27,10 +27,16 @@ namespace vt {
 class Buffer : public IdentObject, public BindableObjectBase
 {
 public:
-    Buffer(GLenum target, size_t size, void* data);
+    Buffer(GLenum target, size_t size, void* data, GLenum usage = GL_STATIC_DRAW);
     virtual ~Buffer();
     void update();
     void bind();
+    void unbind();
+
+    // NOTE: for pixel pack buffers (GL_STREAM_READ); blocks until the gpu has written the buffer, so map it a
+    //       frame or two after the read was issued
+    const void* map_read();
+    void unmap();
     size_t size() const
     {
         return m_size;
@@ -0,0 +1,71 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_CHANGE_COUNTER_H_
+#define VT_CHANGE_COUNTER_H_
+
+#include <GL/glew.h>
+
+#define CHANGE_COUNTER_QUERIES 4 // ring of occlusion queries; a result is read at most this many passes late
+
+namespace vt {
+
+// tells when an iterated ping-pong pass has reached a fixed point
+// after each pass, draw a pass that discards the texels the pass left unchanged between begin() and end(); the
+// samples that pass are counted by an asynchronous GL_SAMPLES_PASSED query and read back passes later without
+// stalling. Once a pass begun after the last reset() is counted with no changed texels the field is settled:
+// further passes would reproduce it, so they can be skipped until an input the passes do not see changes
+// NOTE: a result arrives a few passes late, so up to CHANGE_COUNTER_QUERIES passes are issued past the fixed point;
+//       that is harmless since they change nothing
+// NOTE: requires a current GL context
+class ChangeCounter
+{
+public:
+    ChangeCounter();
+    ~ChangeCounter();
+
+    // bracket the pass that draws only changed texels; the pass goes uncounted if every query is still pending
+    void begin();
+    void end();
+
+    // inputs changed outside the passes (cursor, walls); passes begun before this no longer count
+    void reset();
+
+    // read back finished queries without waiting; returns is_settled()
+    bool poll();
+
+    bool is_settled() const  { return m_settled; }
+    long get_changed() const { return m_changed; } // texels changed by the latest counted pass, -1 if none yet
+    long get_passes() const  { return m_passes; }  // passes begun since the last reset()
+
+private:
+    GLuint m_query_ids[CHANGE_COUNTER_QUERIES];
+    long   m_query_serials[CHANGE_COUNTER_QUERIES]; // pass counted in each query, 0 if no result pending
+    int    m_next_query;
+    bool   m_query_open;
+    long   m_serial;         // passes begun so far
+    long   m_reset_serial;   // first pass begun after the last reset()
+    long   m_result_serial;  // pass of the latest result read
+    long   m_changed;
+    long   m_passes;
+    bool   m_settled;
+};
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_CONWAY_BATCH_H_
+#define VT_CONWAY_BATCH_H_
+
+#include <BitBoard.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace vt {
+
+// many independent boards of the same size packed into one atlas, so one step advances all of them
+// NOTE: universes sit on a grid with one dead gutter cell between neighbors; gutter cells are cleared after every
+//       generation, so cells never see across a gutter and each universe behaves as if it had its own dead border.
+//       Same layout as "src/shaders/overlay_conway_batch.f.glsl"
+class ConwayBatch
+{
+public:
+    ConwayBatch(glm::ivec2 universe_dim, int universe_count);
+    virtual ~ConwayBatch();
+
+    // layout
+    glm::ivec2 get_universe_dim() const { return m_universe_dim; }
+    int get_universe_count() const      { return m_universe_count; }
+    glm::ivec2 get_grid_dim() const     { return m_grid_dim; } // in universes
+    glm::ivec2 get_atlas_dim() const    { return get_atlas_dim(m_universe_dim, m_universe_count); }
+    glm::ivec2 get_universe_origin(int universe_index) const;
+    static glm::ivec2 get_grid_dim(int universe_count);
+    static glm::ivec2 get_atlas_dim(glm::ivec2 universe_dim, int universe_count);
+
+    // accessors
+    BitBoard* get_board() const     { return m_board; }
+    long get_generation() const     { return m_board->get_generation(); }
+    double get_elapsed_time() const { return m_elapsed_time; } // seconds spent in step()
+    double get_generations_per_sec() const;
+
+    // basic modifiers
+    bool get_cell(int universe_index, glm::ivec2 pos) const;
+    void set_cell(int universe_index, glm::ivec2 pos, bool alive);
+
+    // texture interop; one universe (universe_dim) or the whole atlas (atlas_dim), Texture::RED layout
+    void load_r32f(int universe_index, const float* pixels);
+    void load_r32f(const float* pixels);
+    void store_r32f(float* pixels) const;
+
+    // live cells per universe, in one pass over the atlas
+    void get_populations(std::vector<size_t>* populations) const; // out
+
+    // core functionality
+    void step(int iters = 1);
+    void reset_stats();
+
+private:
+    glm::ivec2            m_universe_dim;
+    int                   m_universe_count;
+    glm::ivec2            m_grid_dim;
+    BitBoard*             m_board;
+    std::vector<uint64_t> m_gutter_mask; // one row; zero bits at gutter columns
+    double                m_elapsed_time;
+
+    void clear_gutters();
+};
+
+}
+
+#endif
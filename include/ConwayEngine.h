@@ -0,0 +1,110 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_CONWAY_ENGINE_H_
+#define VT_CONWAY_ENGINE_H_
+
+#include <Boundary.h>
+#include <LifeRule.h>
+#include <glm/glm.hpp>
+#include <stddef.h>
+
+// NOTE: must match "src/shaders/overlay_conway.f.glsl"
+#define CONWAY_GROW_COLOR 1.0f
+#define CONWAY_LIVE_COLOR 0.5f
+#define CONWAY_DIE_COLOR  0.0f
+
+namespace vt {
+
+// cpu equivalent of "src/shaders/overlay_conway.f.glsl"
+// NOTE: pixels are in Texture::RED layout (one float per texel, row-major, origin at bottom-left)
+class ConwayEngine
+{
+public:
+    explicit ConwayEngine(glm::ivec2 dim);
+    virtual ~ConwayEngine();
+
+    // accessors
+    glm::ivec2 get_dim() const      { return m_dim; }
+    float* get_pixels() const       { return m_pixels; }
+    long get_generation() const     { return m_generation; }
+    double get_elapsed_time() const { return m_elapsed_time; } // seconds spent in step()
+    double get_generations_per_sec() const;
+    size_t get_population() const;
+
+    // cursor in texture space; glm::ivec2(-1) to disable seeding
+    void set_cursor_pos(glm::ivec2 cursor_pos)
+    {
+        m_cursor_pos = cursor_pos;
+    }
+    glm::ivec2 get_cursor_pos() const
+    {
+        return m_cursor_pos;
+    }
+
+    // life-like rule (see LifeRule.h); defaults to B3/S23
+    void set_rule(life_rule_t rule)
+    {
+        m_rule = rule;
+    }
+    life_rule_t get_rule() const
+    {
+        return m_rule;
+    }
+
+    // what off-board neighbors read as (see Boundary.h); defaults to dead
+    void set_boundary_mode(boundary_mode_t boundary_mode)
+    {
+        m_boundary_mode = boundary_mode;
+    }
+    boundary_mode_t get_boundary_mode() const
+    {
+        return m_boundary_mode;
+    }
+
+    // basic modifiers
+    void set_color(float color);
+    void draw_x();
+    void randomize();
+
+    // texture interop (no gl context required)
+    void load(const float* pixels);
+    void store(float* pixels) const;
+
+    // core functionality
+    void step(int iters = 1);
+    void reset_stats();
+
+private:
+    glm::ivec2      m_dim;
+    float*          m_pixels;   // input
+    float*          m_pixels2;  // output
+    float*          m_zero_row; // dead border
+    glm::ivec2      m_cursor_pos;
+    life_rule_t     m_rule;
+    boundary_mode_t m_boundary_mode;
+    long            m_generation;
+    double          m_elapsed_time;
+
+    void step_row(int y);
+    const float* get_halo_row(int y) const; // row y, or the row standing in for it off the board
+};
+
+}
+
+#endif
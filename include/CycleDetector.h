@@ -0,0 +1,83 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_CYCLE_DETECTOR_H_
+#define VT_CYCLE_DETECTOR_H_
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CYCLE_DETECTOR_DEFAULT_MAX_PERIOD 64
+
+namespace vt {
+
+// 64-bit finalizer (splitmix64); spreads every input bit over the whole word
+inline uint64_t hash_mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// one word into a running hash lane; cheap enough to run once per board word
+inline uint64_t hash_step(uint64_t lane, uint64_t word)
+{
+    lane = (lane ^ word) * 0x9E3779B97F4A7C15ULL;
+    return (lane << 31) | (lane >> 33);
+}
+
+// hash of a raw buffer (e.g. a downloaded texture)
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0);
+
+// finds period-p repetition in a sequence of board hashes, one per step, kept in a small history ring
+// NOTE: boards are compared by 64-bit hash only; a false match is possible but vanishingly unlikely.
+//       Once a board repeats, it repeats forever (same rule, same cursor), so a detected cycle stays detected
+//       until a hash breaks the pattern (e.g. the board was edited)
+class CycleDetector
+{
+public:
+    explicit CycleDetector(int max_period = CYCLE_DETECTOR_DEFAULT_MAX_PERIOD);
+
+    int get_max_period() const        { return m_hashes.size() - 1; }
+    int get_period() const            { return m_period; }           // in generations, 0 if not cycling
+    long get_cycle_generation() const { return m_cycle_generation; } // first generation found to repeat
+
+    // record the hash of the board after generation; true only on the step a new cycle is found
+    bool update(long generation, uint64_t hash);
+    void reset();
+
+    // generations a cycling board still has to be stepped to look like it was stepped to target_generation
+    long get_remaining_generations(long generation, long target_generation) const;
+
+private:
+    std::vector<uint64_t> m_hashes;      // ring
+    std::vector<long>     m_generations; // ring
+    int                   m_count;
+    int                   m_next;
+    int                   m_period;
+    long                  m_cycle_generation;
+};
+
+}
+
+#endif
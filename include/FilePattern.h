@@ -0,0 +1,101 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_FILE_PATTERN_H_
+#define VT_FILE_PATTERN_H_
+
+#include <LifeRule.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PATTERN_READ_BUFFER_SIZE (1 << 16) // bytes per read() of a streaming decode
+
+namespace vt {
+
+class BitBoard;
+class HashLife;
+class TiledBoard;
+
+enum pattern_format_t {
+    PATTERN_FORMAT_UNKNOWN,
+    PATTERN_FORMAT_RLE,       // run-length encoded ("x = 3, y = 3, rule = B3/S23" then "bo$2bo$3o!")
+    PATTERN_FORMAT_PLAINTEXT, // one line per row, '.' dead and 'O' alive, '!' comments
+    PATTERN_FORMAT_MACROCELL  // Golly's quadtree dump ("[M2]"), one node per line
+};
+
+struct pattern_info_t
+{
+    pattern_format_t format;
+    int64_t          width;  // bounding box of the live cells (Macrocell), header (RLE) or longest line (plaintext)
+    int64_t          height;
+    bool             has_rule;
+    life_rule_t      rule;
+    int              states;
+    uint64_t         population;
+    size_t           bytes;        // read from the file
+    double           elapsed_time; // seconds to decode and store
+};
+
+// receives a pattern while it is decoded; nothing dense is ever built in between
+// NOTE: pattern coordinates start at the top-left corner of the bounding box and rows go down (the files' order),
+//       the other way around from Texture rows
+class PatternSink
+{
+public:
+    virtual ~PatternSink() {}
+
+    // called once the size (and rule) is known, before the first run
+    virtual void begin(const pattern_info_t& info) {}
+
+    // whether any cell of the square is wanted (lets a Macrocell walk skip whole subtrees)
+    virtual bool is_visible(int64_t x, int64_t y, int64_t size) const { return true; }
+
+    // length live cells starting at (x, y)
+    virtual void add_run(int64_t x, int64_t y, int64_t length) = 0;
+};
+
+pattern_format_t find_pattern_format(const std::string& filename); // by extension, then by the first line
+const char* get_pattern_format_name(pattern_format_t format);
+
+// format, and size and rule if the header has them (plaintext has neither); stops before the first cell
+bool read_pattern_header(const std::string& filename, pattern_info_t* info); // out
+
+// streaming decode; RLE and Macrocell are read once, plaintext twice (once for its size)
+bool read_pattern(const std::string& filename, PatternSink* sink, pattern_info_t* info = NULL); // out
+
+// centered on the board (cells outside are dropped); the rule is only reported in info, not applied
+bool load_pattern(const std::string& filename, BitBoard* board, pattern_info_t* info = NULL);   // out
+bool load_pattern(const std::string& filename, TiledBoard* board, pattern_info_t* info = NULL); // out
+bool load_pattern_r32f(const std::string& filename, float* pixels, glm::ivec2 dim, pattern_info_t* info = NULL); // out
+bool load_pattern_r8(const std::string& filename,
+                     uint8_t*           pixels,
+                     glm::ivec2         dim,
+                     uint8_t            alive, // e.g. GENERATIONS_ALIVE
+                     pattern_info_t*    info = NULL); // out
+
+// a Macrocell file becomes the quadtree as-is (shared subtrees stay shared, and its root is centered on the
+// origin), so a huge sparse pattern never becomes dense
+// NOTE: RLE and plaintext are centered on the origin and go through HashLife::set_cell, one cell at a time
+bool load_pattern(const std::string& filename, HashLife* engine, pattern_info_t* info = NULL); // out
+
+}
+
+#endif
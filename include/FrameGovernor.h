@@ -0,0 +1,109 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_FRAME_GOVERNOR_H_
+#define VT_FRAME_GOVERNOR_H_
+
+#include <GL/glew.h>
+#include <chrono>
+
+#define FRAME_GOVERNOR_DEFAULT_FPS 60
+#define FRAME_GOVERNOR_MAX_ITERATIONS 1024
+#define FRAME_GOVERNOR_QUERIES 4 // ring of timer queries; a result is read at most this many frames late
+#define FRAME_GOVERNOR_SMOOTHING 0.25 // weight of the newest sample in the running averages
+#define FRAME_GOVERNOR_MAX_BUDGET 0.9 // of the target frame time; the rest is for the display pass and the swap
+#define FRAME_GOVERNOR_OVERRUN 1.25 // frame time over target frame time that counts as a missed frame
+#define FRAME_GOVERNOR_MAX_GAP 0.25 // seconds between frames beyond which the animation is taken to have paused
+
+namespace vt {
+
+// picks how many simulation passes (iterations) to issue per displayed frame so frames keep to a target rate
+// while as many iterations as possible are run
+// each frame's batch of iterations is timed twice: on the cpu (submission plus any synchronous downloads) and on
+// the gpu (an asynchronous GL_TIME_ELAPSED query, read back frames later without stalling). The slower of the
+// two, per iteration and smoothed, is the cost of one iteration, and the next batch is budget / cost, changing by
+// at most 2x per frame. The budget itself is fed back from the frame time: cut by a quarter on a missed frame,
+// otherwise grown back to just under the budget that missed it and then, slowly, past it (up to
+// FRAME_GOVERNOR_MAX_BUDGET) in case the display pass got cheaper
+// NOTE: the display pass and the swap are not timed; with vsync the frame time is the refresh interval however
+//       short the batch, so only missed frames say anything about them
+// NOTE: requires a current GL context; without ARB_timer_query only cpu time is used
+class FrameGovernor
+{
+public:
+    enum decision_t {
+        HOLD,
+        GROW,
+        SHRINK,
+        OVERRUN
+    };
+
+    FrameGovernor(double target_fps = FRAME_GOVERNOR_DEFAULT_FPS, int max_iterations = FRAME_GOVERNOR_MAX_ITERATIONS);
+    ~FrameGovernor();
+
+    // call once per frame, before the first iteration; returns the iterations to issue this frame
+    int begin_frame();
+
+    // call after the last iteration of the frame, before the display pass; iterations as actually issued
+    void end_frame(int iterations);
+
+    void reset();
+
+    void set_target_fps(double target_fps) { m_target_frame_time = 1.0 / target_fps; }
+    double get_target_fps() const          { return 1.0 / m_target_frame_time; }
+    bool has_gpu_timer() const             { return m_gpu_timer; }
+
+    // metrics, times in seconds
+    int get_iterations() const                { return m_iterations; }
+    decision_t get_decision() const           { return m_decision; }
+    double get_gpu_time_per_iteration() const { return m_gpu_time_per_iteration; } // 0 until the first query result
+    double get_cpu_time_per_iteration() const { return m_cpu_time_per_iteration; }
+    double get_frame_time() const             { return m_frame_time; }             // smoothed, begin to begin
+    double get_budget() const                 { return m_budget; }                 // for the next batch
+    long get_overruns() const                 { return m_overruns; }
+
+    static const char* get_decision_name(decision_t decision);
+
+private:
+    typedef std::chrono::steady_clock clock_t;
+
+    double                m_target_frame_time;
+    int                   m_max_iterations;
+    bool                  m_gpu_timer;
+    GLuint                m_query_ids[FRAME_GOVERNOR_QUERIES];
+    int                   m_query_iterations[FRAME_GOVERNOR_QUERIES]; // 0 if no result pending
+    int                   m_next_query;
+    bool                  m_query_open;
+    int                   m_iterations;
+    decision_t            m_decision;
+    double                m_gpu_time_per_iteration;
+    double                m_cpu_time_per_iteration;
+    double                m_frame_time;
+    double                m_budget;
+    double                m_budget_ceiling; // budget when a frame was last missed
+    long                  m_overruns;
+    long                  m_frames;
+    clock_t::time_point   m_frame_begin;
+    clock_t::time_point   m_batch_begin;
+
+    void read_queries();
+};
+
+}
+
+#endif
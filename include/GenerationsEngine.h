@@ -0,0 +1,115 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_GENERATIONS_ENGINE_H_
+#define VT_GENERATIONS_ENGINE_H_
+
+#include <Boundary.h>
+#include <LifeRule.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+// NOTE: must match "src/shaders/overlay_generations.f.glsl"
+#define GENERATIONS_DEAD  0
+#define GENERATIONS_ALIVE 1 // 2 .. states - 1 are dying (refractory)
+
+namespace vt {
+
+// cpu equivalent of "src/shaders/overlay_generations.f.glsl"; "Generations" family of multi-state rules
+// NOTE: one byte per cell holding the state, in Texture::R8 layout (row-major, origin at bottom-left)
+class GenerationsEngine
+{
+public:
+    explicit GenerationsEngine(glm::ivec2 dim);
+    virtual ~GenerationsEngine();
+
+    // accessors
+    glm::ivec2 get_dim() const      { return m_dim; }
+    uint8_t* get_cells() const      { return m_cells; }
+    long get_generation() const     { return m_generation; }
+    double get_elapsed_time() const { return m_elapsed_time; } // seconds spent in step()
+    double get_generations_per_sec() const;
+    size_t get_population() const; // alive cells, not dying ones
+
+    // cursor in texture space; glm::ivec2(-1) to disable seeding
+    void set_cursor_pos(glm::ivec2 cursor_pos)
+    {
+        m_cursor_pos = cursor_pos;
+    }
+    glm::ivec2 get_cursor_pos() const
+    {
+        return m_cursor_pos;
+    }
+
+    // life-like rule plus state count (see LifeRule.h); defaults to B3/S23 with 2 states
+    void set_rule(life_rule_t rule, int states);
+    life_rule_t get_rule() const
+    {
+        return m_rule;
+    }
+    int get_states() const
+    {
+        return m_states;
+    }
+
+    // what off-board neighbors read as (see Boundary.h); defaults to dead
+    void set_boundary_mode(boundary_mode_t boundary_mode)
+    {
+        m_boundary_mode = boundary_mode;
+    }
+    boundary_mode_t get_boundary_mode() const
+    {
+        return m_boundary_mode;
+    }
+
+    // basic modifiers
+    void clear();
+    void draw_x();
+    void randomize();
+
+    // texture interop (no gl context required)
+    void load_r8(const uint8_t* pixels);
+    void store_r8(uint8_t* pixels) const;
+    void load_r32f(const float* pixels); // Texture::RED layout; any positive value is alive
+
+    // core functionality
+    void step(int iters = 1);
+    void reset_stats();
+
+private:
+    glm::ivec2           m_dim;
+    uint8_t*             m_cells;    // input
+    uint8_t*             m_cells2;   // output
+    uint8_t*             m_zero_row; // dead border
+    life_rule_t          m_rule;
+    int                  m_states;
+    std::vector<uint8_t> m_next; // [state * LIFE_RULE_COUNTS + live neighbor count]
+    glm::ivec2           m_cursor_pos;
+    boundary_mode_t      m_boundary_mode;
+    long                 m_generation;
+    double               m_elapsed_time;
+
+    void step_row(int y);
+    const uint8_t* get_halo_row(int y) const; // row y, or the row standing in for it off the board
+};
+
+}
+
+#endif
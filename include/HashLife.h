@@ -0,0 +1,135 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_HASH_LIFE_H_
+#define VT_HASH_LIFE_H_
+
+#include <LifeRule.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define HASHLIFE_DEFAULT_MAX_NODES (1 << 22)
+#define HASHLIFE_MAX_LEVEL         62
+
+namespace vt {
+
+// canonical quadtree node; level n covers 2^n x 2^n cells
+// NOTE: y points up (same as Texture), so north is +y
+struct HashLifeNode
+{
+    HashLifeNode* m_nw;
+    HashLifeNode* m_ne;
+    HashLifeNode* m_sw;
+    HashLifeNode* m_se;
+    HashLifeNode* m_result; // center 2^(n-1) square, 2^min(step_log2, n-2) generations later (memoized)
+    HashLifeNode* m_next;   // hash chain
+    uint64_t      m_population;
+    int           m_level;
+    bool          m_marked; // gc
+};
+
+// Gosper's HashLife; each step() advances 2^step_log2 generations
+// NOTE: simulates the unbounded plane (no dead border, no cursor seeding); a Texture-sized board maps to
+//       cells [0, dim) of the plane
+class HashLife
+{
+public:
+    explicit HashLife(size_t max_nodes = HASHLIFE_DEFAULT_MAX_NODES);
+    virtual ~HashLife();
+
+    // accessors
+    uint64_t get_generation() const   { return m_generation; }
+    uint64_t get_population() const   { return m_root->m_population; }
+    size_t get_node_count() const     { return m_node_count; }
+    size_t get_max_nodes() const      { return m_max_nodes; }
+    long get_gc_count() const         { return m_gc_count; }
+    long get_result_hits() const      { return m_result_hits; }
+    long get_result_misses() const    { return m_result_misses; }
+    double get_elapsed_time() const   { return m_elapsed_time; } // seconds spent in step()
+    double get_generations_per_sec() const;
+    int get_step_log2() const
+    {
+        return m_step_log2;
+    }
+    void set_step_log2(int step_log2);
+    life_rule_t get_rule() const
+    {
+        return m_rule;
+    }
+    bool set_rule(life_rule_t rule); // false for B0 rules (empty space would not stay empty)
+    HashLifeNode* get_root() const
+    {
+        return m_root;
+    }
+
+    // basic modifiers
+    void clear();
+    bool get_cell(int64_t x, int64_t y) const;
+    void set_cell(int64_t x, int64_t y, bool alive);
+
+    // texture interop (Texture::RED layout); live cells are stored as LIVE_COLOR
+    void load_r32f(const float* pixels, glm::ivec2 dim);
+    void store_r32f(float* pixels, glm::ivec2 dim) const;
+
+    // quadtree construction (canonical)
+    HashLifeNode* get_leaf(bool alive) const
+    {
+        return m_leaves[alive ? 1 : 0];
+    }
+    HashLifeNode* get_empty(int level);
+    HashLifeNode* create(HashLifeNode* nw, HashLifeNode* ne, HashLifeNode* sw, HashLifeNode* se);
+    void set_root(HashLifeNode* root, uint64_t generation = 0);
+
+    // core functionality
+    void step(int iters = 1);
+    void gc();
+    void reset_stats();
+
+private:
+    std::vector<HashLifeNode*> m_buckets;
+    size_t                     m_node_count;
+    size_t                     m_max_nodes;
+    HashLifeNode*              m_leaves[2];
+    std::vector<HashLifeNode*> m_empty; // by level
+    HashLifeNode*              m_root;
+    int                        m_step_log2;
+    life_rule_t                m_rule;
+    uint64_t                   m_generation;
+    long                       m_gc_count;
+    long                       m_result_hits;
+    long                       m_result_misses;
+    double                     m_elapsed_time;
+
+    HashLifeNode* expand(HashLifeNode* node);
+    HashLifeNode* center(HashLifeNode* node);
+    HashLifeNode* result(HashLifeNode* node);
+    HashLifeNode* result_level2(HashLifeNode* node);
+    HashLifeNode* set_cell(HashLifeNode* node, int64_t x, int64_t y, bool alive);
+    HashLifeNode* build_r32f(const float* pixels, glm::ivec2 dim, int64_t x, int64_t y, int level);
+    void store_r32f(const HashLifeNode* node, float* pixels, glm::ivec2 dim, int64_t x, int64_t y) const;
+    void rehash(size_t bucket_count);
+    void clear_results();
+    void mark(HashLifeNode* node, bool with_results);
+    void sweep();
+};
+
+}
+
+#endif
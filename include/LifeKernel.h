@@ -0,0 +1,58 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_LIFE_KERNEL_H_
+#define VT_LIFE_KERNEL_H_
+
+#include <LifeRule.h>
+#include <stdint.h>
+
+namespace vt {
+
+enum life_kernel_type_t {
+    LIFE_KERNEL_SCALAR,
+    LIFE_KERNEL_SSE2,
+    LIFE_KERNEL_AVX2,
+    LIFE_KERNEL_AVX512,
+    LIFE_KERNEL_COUNT
+};
+
+// one row of one generation on bit-packed words; above/row/below/out/out_grow point at the first data word of
+// their rows, out_grow receives cells alive next generation by a birth count (neighbor sum == 3 for Conway)
+// NOTE: reads one word before and after each input row (guard words); rule is only read by the generic kernel,
+//       specialized kernels have it baked in
+typedef void (*life_kernel_t)(const uint64_t*   above,
+                              const uint64_t*   row,
+                              const uint64_t*   below,
+                                    uint64_t*   out,
+                                    uint64_t*   out_grow,
+                                    int         words,
+                                    uint64_t    last_word_mask,
+                                    life_rule_t rule);
+
+// runtime dispatch (cpuid)
+bool life_kernel_supported(life_kernel_type_t type);
+life_kernel_type_t life_kernel_best();
+life_kernel_t get_life_kernel(life_kernel_type_t type, life_rule_t rule = LIFE_RULE_CONWAY);
+bool is_life_kernel_specialized(life_rule_t rule); // false if rule falls back to the generic kernel
+const char* get_life_kernel_name(life_kernel_type_t type);
+bool find_life_kernel(const char* name, life_kernel_type_t* type); // out
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_LIFE_RULE_H_
+#define VT_LIFE_RULE_H_
+
+#include <string>
+#include <stdint.h>
+
+#define LIFE_RULE_COUNTS 9 // neighbor counts 0..8
+
+// known rules get their own template-specialized kernels (see LifeKernel.cpp); any other rule runs the generic kernel
+// NOTE: X(name, birth digits, survival digits)
+#define LIFE_RULE_TABLE(X) \
+        X("life",               "3",     "23") \
+        X("highlife",           "36",    "23") \
+        X("daynight",           "3678",  "34678") \
+        X("seeds",              "2",     "") \
+        X("life_without_death", "3",     "012345678") \
+        X("maze",               "3",     "12345") \
+        X("replicator",         "1357",  "1357") \
+        X("2x2",                "36",    "125") \
+        X("morley",             "368",   "245") \
+        X("diamoeba",           "35678", "5678") \
+        X("anneal",             "4678",  "35678")
+
+// "Generations" rules: a cell that fails to survive decays through (states - 2) refractory states before it dies;
+// only live cells count as neighbors
+// NOTE: X(name, birth digits, survival digits, states)
+#define GENERATIONS_RULE_TABLE(X) \
+        X("brians_brain",       "2",     "",      3) \
+        X("star_wars",          "2",     "345",   4) \
+        X("frogs",              "34",    "12",    3) \
+        X("swirl",              "34",    "23",    8)
+#define GENERATIONS_MAX_STATES 256 // one byte per cell
+
+#define LIFE_RULE(birth_digits, survival_digits) \
+        vt::make_life_rule(vt::life_rule_digits(birth_digits), vt::life_rule_digits(survival_digits))
+#define LIFE_RULE_CONWAY LIFE_RULE("3", "23")
+
+namespace vt {
+
+// life-like rule in B/S notation ("B36/S23" is HighLife)
+// NOTE: bit (alive * 9 + neighbor count) is whether the cell is alive next generation, so a rule is its own lookup
+//       table and can be used as a template argument
+typedef uint32_t life_rule_t;
+
+constexpr life_rule_t make_life_rule(uint32_t birth_mask, uint32_t survival_mask)
+{
+    return (birth_mask & 0x1FF) | ((survival_mask & 0x1FF) << LIFE_RULE_COUNTS);
+}
+
+// "23" -> (1 << 2) | (1 << 3)
+constexpr uint32_t life_rule_digits(const char* digits)
+{
+    return *digits ? ((1u << (*digits - '0')) | life_rule_digits(digits + 1)) : 0;
+}
+
+constexpr uint32_t get_life_rule_birth(life_rule_t rule)    { return rule & 0x1FF; }
+constexpr uint32_t get_life_rule_survival(life_rule_t rule) { return (rule >> LIFE_RULE_COUNTS) & 0x1FF; }
+
+constexpr bool life_rule_lookup(life_rule_t rule, bool alive, int count)
+{
+    return (rule >> ((alive ? LIFE_RULE_COUNTS : 0) + count)) & 1;
+}
+
+// B/S notation ("B36/S23"), S/B notation ("23/36") or a known rule name ("highlife")
+bool find_life_rule(const char* str, life_rule_t* rule); // out
+std::string get_life_rule_string(life_rule_t rule);       // B/S notation
+const char* get_life_rule_name(life_rule_t rule);         // NULL if not a known rule
+int get_known_life_rule_count();
+life_rule_t get_known_life_rule(int index);
+
+// B/S/C notation ("B2/S/C3"), S/B/C notation ("/2/3"), a known generations rule name ("brians_brain") or any
+// life-like rule (2 states)
+bool find_generations_rule(const char* str, life_rule_t* rule, int* states); // out
+std::string get_generations_rule_string(life_rule_t rule, int states);        // B/S/C notation
+const char* get_generations_rule_name(life_rule_t rule, int states);          // NULL if not a known rule
+int get_known_generations_rule_count();
+life_rule_t get_known_generations_rule(int index, int* states); // out
+
+// copy of a rule shader template ("src/shaders/overlay_conway.f.glsl" or "src/shaders/overlay_generations.f.glsl")
+// with the rule baked in as constants (no uniforms)
+bool write_life_rule_shader(const std::string& template_filename,
+                            const std::string& output_filename,
+                            life_rule_t        rule,
+                            int                states = 2);
+
+}
+
+#endif
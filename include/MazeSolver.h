@@ -0,0 +1,144 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_MAZE_SOLVER_H_
+#define VT_MAZE_SOLVER_H_
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+// NOTE: must match "src/shaders/overlay_maze_distfield.f.glsl"
+#define MAZE_EMPTY_COLOR  0.0f
+#define MAZE_SPRITE_COLOR 0.25f
+#define MAZE_WALL_COLOR   0.5f
+#define MAZE_SEED_COLOR   1.0f
+#define MAZE_DECAY_FACTOR 0.99f
+
+#define MAZE_SOLVER_PARALLEL_FRONTIER 4096 // cells; smaller wavefronts are expanded on the calling thread
+#define MAZE_SOLVER_TASK_CELLS        1024 // frontier cells per parallel_for task
+
+namespace vt {
+
+class ThreadPool;
+
+// maze by Prim's algorithm (Texture::RED layout): cells on odd coordinates, walls everywhere else
+// NOTE: uses rand(); a WIDTH x HEIGHT maze has (WIDTH - 1) / 2 x (HEIGHT - 1) / 2 cells
+void gen_maze_r32f(float* pixels, glm::ivec2 dim);
+
+// maze tree for the distfield tree pass (Texture::RGBA32F layout, one texel per cell): each free cell's parent in a
+// breadth-first spanning tree of the 4-connected free cells (one tree per connected region, its root pointing to
+// itself), the cost of the hop to the parent and the hop count (1, or 0 for a root)
+// the cost is 1, or 0 where the path to the root turns at the parent and the parent is on odd coordinates (a cell
+// of gen_maze_r32f): the 8-connected distfield pass cuts that corner with one diagonal step. Two neighbors are never
+// both on odd coordinates, so the cuts never share a step, and for a maze from gen_maze_r32f (which has no loops)
+// the costs along a path add up to the shader's distance
+// NOTE: walls point to themselves at no cost
+void gen_maze_tree_rgba32f(const float* pixels, glm::ivec2 dim, float* tree_pixels);
+
+// exact distance field to one goal cell by breadth-first search over the 8-connected grid, the fixed point the
+// distfield shader converges to (see "src/shaders/overlay_maze_distfield.f.glsl")
+// the search is frontier-synchronous: each wavefront (all cells one step further out) is expanded in parallel
+// tasks that claim cells by clearing their bit in a bitmap of open cells with an atomic and, then the tasks' next
+// wavefronts are joined
+// NOTE: walls and sprites block; diagonal moves squeeze between two blocked cells, as in the shader
+// NOTE: the bitmaps have a closed border of one cell all around, so a cell's 3x3 neighborhood is three 3-bit
+//       reads without a border test; at 1 bit per cell the open bitmap of an 8k x 8k maze is 8 MB, where a
+//       visited test on the distances would touch 256 MB
+class MazeSolver
+{
+public:
+    explicit MazeSolver(glm::ivec2 dim);
+
+    // accessors
+    glm::ivec2 get_dim() const           { return m_dim; }
+    glm::ivec2 get_goal() const          { return m_goal; }
+    void set_goal(glm::ivec2 goal)       { m_goal = goal; }
+    int get_max_distance() const         { return m_max_distance; } // -1 if the goal is blocked or off the board
+    size_t get_reached() const           { return m_reached; }      // cells with a distance, the goal included
+    int get_parallel_wavefronts() const  { return m_parallel_wavefronts; }
+    double get_elapsed_time() const      { return m_elapsed_time; } // seconds spent in the last solve()
+
+    // steps to the goal, -1 if blocked or unreachable
+    // NOTE: distances are only written when a cell is reached; a cell that is free but still open has none
+    int get_distance(glm::ivec2 pos) const
+    {
+        int bit = get_bit(pos);
+        uint64_t mask = 1ULL << (bit & 63);
+        bool reached = (m_free[bit >> 6] & mask) && !(m_open[bit >> 6].load(std::memory_order_relaxed) & mask);
+        return reached ? m_distance[pos.y * m_dim.x + pos.x] : -1;
+    }
+
+    // wavefronts of at least MAZE_SOLVER_PARALLEL_FRONTIER cells expanded in parallel; NULL for single-threaded
+    void set_thread_pool(ThreadPool* thread_pool) { m_thread_pool = thread_pool; }
+    ThreadPool* get_thread_pool() const           { return m_thread_pool; }
+
+    // texture interop (Texture::RED layout, as the maze shaders see it)
+    // load: MAZE_WALL_COLOR and MAZE_SPRITE_COLOR block, a MAZE_SEED_COLOR cell becomes the goal
+    // store: walls, sprites and the goal as loaded, reachable cells as the shader's field value (see
+    //        get_distance_color), the rest MAZE_EMPTY_COLOR
+    void load_r32f(const float* pixels);
+    void store_r32f(float* pixels) const;
+
+    void solve();
+
+    // the shader's value after distance decay steps from MAZE_SEED_COLOR, evaluated the same way in float;
+    // distance up to get_max_distance()
+    // NOTE: the value tends to MAZE_WALL_COLOR and reaches it in float after ~1700 steps, where the shader would
+    //       read the cell as a wall; it is held one ulp above it instead
+    float get_distance_color(int distance) const { return m_colors[distance]; }
+
+private:
+    enum cell_t {
+        CELL_EMPTY,
+        CELL_WALL,
+        CELL_SPRITE
+    };
+
+    glm::ivec2                         m_dim;
+    int                                m_words_per_row; // of the bitmaps, border included
+    glm::ivec2                         m_goal;
+    std::vector<uint8_t>               m_cells;    // cell_t
+    std::vector<uint64_t>              m_free;     // bitmap, 1 for empty cells; border 0
+    std::vector<std::atomic<uint64_t>> m_open;     // bitmap, 1 for free cells not reached yet; border 0
+    std::vector<int32_t>               m_distance; // valid where free and not open
+    std::vector<float>                 m_colors;   // by distance, up to m_max_distance
+    std::vector<glm::ivec2>            m_frontier;
+    std::vector<glm::ivec2>            m_next_frontier;
+    std::vector<std::vector<glm::ivec2>> m_task_frontiers;
+    ThreadPool*                        m_thread_pool;
+    int                                m_max_distance;
+    size_t                             m_reached;
+    int                                m_parallel_wavefronts;
+    double                             m_elapsed_time;
+
+    // bit index in the bitmaps
+    int get_bit(glm::ivec2 pos) const
+    {
+        return (pos.y + 1) * m_words_per_row * 64 + pos.x + 1;
+    }
+    template<bool ATOMIC>
+    void expand(const glm::ivec2* cells, size_t count, int32_t distance, std::vector<glm::ivec2>* next_frontier); // out
+};
+
+}
+
+#endif
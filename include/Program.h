@@ -59,6 +59,7 @@ public:
         var_uniform_type_color_texture,
         var_uniform_type_color_texture2,
         var_uniform_type_cursor_pos,
+        var_uniform_type_decay_texture,
         var_uniform_type_env_map_texture,
         var_uniform_type_frontface_depth_overlay_texture,
         var_uniform_type_glow_cutoff_threshold,
@@ -73,11 +74,14 @@ public:
         var_uniform_type_model_transform,
         var_uniform_type_mvp_transform,
         var_uniform_type_normal_transform,
+        var_uniform_type_occupancy_texture,
+        var_uniform_type_random_seed,
         var_uniform_type_random_texture,
         var_uniform_type_reflect_to_refract_ratio,
-        var_uniform_type_sprite_pos,
         var_uniform_type_sprite_count,
+        var_uniform_type_sprite_texture,
         var_uniform_type_ssao_sample_kernel_pos,
+        var_uniform_type_universe_dim,
         var_uniform_type_viewport_dim,
         var_uniform_type_view_proj_transform,
         var_uniform_type_count
@@ -0,0 +1,180 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_RECORDING_H_
+#define VT_RECORDING_H_
+
+#include <Snapshot.h>
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+
+#define RECORDING_MAGIC                     "VTREC\r\n" // 8 bytes with the terminator
+#define RECORDING_VERSION                   1
+#define RECORDING_DEFAULT_KEYFRAME_INTERVAL 64 // frames; bounds the deltas a seek has to apply
+#define RECORDING_QUEUE_SIZE                4  // frames captured but not yet encoded before record() waits
+
+namespace vt {
+
+enum recording_frame_type_t {
+    RECORDING_FRAME_KEY,  // every non-empty tile, as in a snapshot
+    RECORDING_FRAME_DELTA // only the tiles that changed, xor-ed with the previous frame
+};
+
+// on disk: header, then frames back to back, each a frame header followed by its tile records
+// NOTE: a tile record is a varint gap in tile index (row-major) since the last record, a varint
+//       snapshot_encoding_t, a varint payload size and the payload (see Snapshot::encode_tile); there is no index,
+//       so a recording cut short by a crash still replays up to its last whole frame
+struct recording_header_t
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t cells;             // snapshot_cells_t
+    int32_t  width;
+    int32_t  height;
+    uint32_t tile_dim;
+    uint32_t rule;              // life_rule_t
+    int32_t  states;
+    uint32_t keyframe_interval;
+};
+
+struct recording_frame_t
+{
+    uint64_t generation;
+    uint32_t type;       // recording_frame_type_t
+    uint32_t tile_count; // tile records that follow
+    uint64_t size;       // bytes of tile records that follow
+};
+
+// records one board per generation, storing only what changed
+// NOTE: each frame is xor-ed against the previous one in memory and only tiles with a nonzero difference are
+//       encoded, so a frame costs in proportion to the activity on the board; a full keyframe every
+//       keyframe_interval frames lets Replayer seek without replaying from the start. Encoding and writing
+//       run on a background thread; unlike SnapshotWriter, frames are never dropped, so record() waits once
+//       RECORDING_QUEUE_SIZE frames are queued
+class Recorder
+{
+public:
+    Recorder();
+    virtual ~Recorder(); // close()
+
+    // the first frame fixes the board size, cell type and rule for the whole recording
+    bool open(const std::string& filename, int keyframe_interval = RECORDING_DEFAULT_KEYFRAME_INTERVAL);
+    void close(); // writes the queued frames first
+    bool is_open() const { return m_file != NULL; }
+
+    // queues a frame by swapping it with a spent buffer (nothing is copied)
+    void record(Snapshot* frame); // IN/OUT
+
+    long get_frames() const;
+    long get_keyframes() const;
+    long get_tiles() const;      // tile records written
+    uint64_t get_bytes() const;  // file size so far
+    bool is_failed() const;      // write error or a frame that does not match the first
+    double get_stall_time() const; // seconds record() spent waiting for the writer
+    double get_write_time() const; // seconds spent encoding and writing, off the simulation thread
+
+private:
+    FILE*                   m_file;
+    int                     m_keyframe_interval;
+    std::thread             m_thread;
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_queue_cond;
+    std::condition_variable m_done_cond;
+    std::vector<Snapshot>   m_queue;      // ring of RECORDING_QUEUE_SIZE frames
+    int                     m_queue_head;
+    int                     m_queue_count;
+    bool                    m_quit;
+    Snapshot                m_prev;       // last frame written, turned into the delta in place
+    std::vector<uint8_t>    m_buffer;     // tile records of the frame being written
+    std::vector<uint8_t>    m_payload;
+    long                    m_frames;
+    long                    m_keyframes;
+    long                    m_tiles;
+    uint64_t                m_bytes;
+    bool                    m_failed;
+    double                  m_stall_time;
+    double                  m_write_time;
+
+    void run();
+    bool write_frame(Snapshot* frame, recording_frame_t* header); // IN/OUT, out; encodes against m_prev and
+                                                                  // swaps the frame in as the new m_prev
+};
+
+// plays a recording back frame by frame, or seeks to any recorded generation
+class Replayer
+{
+public:
+    Replayer();
+    virtual ~Replayer();
+
+    bool open(const std::string& filename); // reads only the frame headers, to index them
+    void close();
+
+    // accessors
+    glm::ivec2 get_dim() const          { return m_dim; }
+    snapshot_cells_t get_cells() const  { return m_cells; }
+    life_rule_t get_rule() const        { return m_rule; }
+    int get_states() const              { return m_states; }
+    int get_keyframe_interval() const   { return m_keyframe_interval; }
+    long get_frame_count() const        { return m_frames.size(); }
+    long get_keyframe_count() const;
+    uint64_t get_first_generation() const;
+    uint64_t get_last_generation() const;
+    long get_frame() const              { return m_frame; } // -1 before the first seek
+
+    // the board at the current frame, with its generation counter and rule (see Snapshot::restore)
+    const Snapshot& get_snapshot() const { return m_snapshot; }
+
+    // decodes the nearest keyframe at or before the generation, then the deltas up to it; false if not recorded
+    bool seek(uint64_t generation);
+    bool next(); // one frame on; false at the end
+    long get_frames_decoded() const     { return m_frames_decoded; } // by the last seek or next
+
+private:
+    struct frame_entry_t
+    {
+        recording_frame_t frame;
+        uint64_t          offset; // of the tile records
+    };
+
+    FILE*                      m_file;
+    glm::ivec2                 m_dim;
+    snapshot_cells_t           m_cells;
+    life_rule_t                m_rule;
+    int                        m_states;
+    int                        m_keyframe_interval;
+    std::vector<frame_entry_t> m_frames;
+    long                       m_frame;
+    long                       m_frames_decoded;
+    Snapshot                   m_snapshot;
+    std::vector<uint8_t>       m_buffer;
+    std::vector<uint8_t>       m_cells_buffer;
+
+    bool decode_frame(long index);
+};
+
+}
+
+#endif
@@ -26,6 +26,7 @@
 
 namespace vt {
 
+class Buffer;
 class Camera;
 class Light;
 class Material;
@@ -150,25 +151,79 @@ public:
     }
 
     void set_cursor_pos(glm::ivec2 cursor_pos);
+    glm::ivec2 get_cursor_pos() const
+    {
+        return m_cursor_pos;
+    }
 
-    void set_sprite_pos(int index, glm::vec2 sprite_pos);
-    glm::vec2 get_sprite_pos(int index) const;
-
-    void set_sprite_angle(int index, float angle);
-    float get_sprite_angle(int index) const;
-
-    void set_sprite_velocity(int index, float velocity);
-    float get_sprite_velocity(int index) const;
-
-    void set_sprite_angle_velocity(int index, float angle_velocity);
-    float get_sprite_angle_velocity(int index) const;
+    // size of one universe in a batched atlas (see ConwayBatch)
+    void set_universe_dim(glm::ivec2 universe_dim)
+    {
+        m_universe_dim = universe_dim;
+    }
+    glm::ivec2 get_universe_dim() const
+    {
+        return m_universe_dim;
+    }
 
+    // sprite state itself lives in the sprite texture; the count only bounds the shaders' sprite loops
     void set_sprite_count(int count);
     int get_sprite_count() const
     {
         return m_sprite_count;
     }
 
+    // sprite state kept on the gpu, one texel per sprite (see main_maze); must be one of the overlay material's
+    // textures when its shader reads sprite_texture
+    void set_sprite_texture(Texture* sprite_texture)
+    {
+        m_sprite_texture = sprite_texture;
+    }
+    Texture* get_sprite_texture() const
+    {
+        return m_sprite_texture;
+    }
+
+    // sprites splatted into a texture at field resolution, so a field pass finds them with one lookup (see main_maze);
+    // must be one of the overlay material's textures when its shader reads occupancy_texture
+    void set_occupancy_texture(Texture* occupancy_texture)
+    {
+        m_occupancy_texture = occupancy_texture;
+    }
+    Texture* get_occupancy_texture() const
+    {
+        return m_occupancy_texture;
+    }
+
+    // field value by path length, so a field pass can look up a distance's value (see main_maze); must be one of the
+    // overlay material's textures when its shader reads decay_texture
+    void set_decay_texture(Texture* decay_texture)
+    {
+        m_decay_texture = decay_texture;
+    }
+    Texture* get_decay_texture() const
+    {
+        return m_decay_texture;
+    }
+
+    // when set, the overlay is drawn as point_count points from vbo_point_coords instead of the viewport quad (see
+    // ShaderContext::render_points); set to NULL to go back
+    void set_overlay_points(Buffer* vbo_point_coords, int point_count)
+    {
+        m_overlay_point_coords = vbo_point_coords;
+        m_overlay_point_count  = point_count;
+    }
+
+    // per-pass seed for hash-based random numbers in shaders
+    void set_random_seed(int random_seed)
+    {
+        m_random_seed = random_seed;
+    }
+    int get_random_seed() const
+    {
+        return m_random_seed;
+    }
+
     void reset();
     void use_program();
     void render(bool                clear_canvas      = true,
@@ -206,11 +261,14 @@ private:
     GLfloat* m_ssao_sample_kernel_pos;
 
     glm::ivec2 m_cursor_pos;
-    glm::vec2* m_sprite_pos;
-    float*     m_sprite_angle;
-    float*     m_sprite_velocity;
-    float*     m_sprite_angle_velocity;
+    glm::ivec2 m_universe_dim;
     int        m_sprite_count;
+    Texture*   m_sprite_texture;
+    Texture*   m_occupancy_texture;
+    Texture*   m_decay_texture;
+    Buffer*    m_overlay_point_coords;
+    int        m_overlay_point_count;
+    int        m_random_seed;
 
     Scene();
     ~Scene();
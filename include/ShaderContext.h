@@ -47,6 +47,9 @@ public:
         return m_material;
     }
     void render();
+
+    // one point per vertex in vbo_point_coords (2 floats each), instead of the overlay's viewport quad
+    void render_points(Buffer* vbo_point_coords, GLsizei point_count);
     void set_ambient_color(const float* ambient_color);
     void set_backface_depth_overlay_texture_index(GLint texture_id);
     void set_backface_normal_overlay_texture_index(GLint texture_id);
@@ -78,8 +81,12 @@ public:
     void set_viewport_dim(const GLint* viewport_dim_arr);
     void set_image_res(const GLint* image_res_arr);
     void set_cursor_pos(const GLint* cursor_pos_arr);
-    void set_sprite_pos(size_t num_sprites, const float* sprite_pos_arr);
+    void set_universe_dim(const GLint* universe_dim_arr);
     void set_sprite_count(GLint sprite_count);
+    void set_sprite_texture_index(GLint texture_id);
+    void set_occupancy_texture_index(GLint texture_id);
+    void set_decay_texture_index(GLint texture_id);
+    void set_random_seed(GLint random_seed);
 
 private:
     Material *m_material;
@@ -0,0 +1,201 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_SNAPSHOT_H_
+#define VT_SNAPSHOT_H_
+
+#include <LifeRule.h>
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SNAPSHOT_MAGIC    "VTSNAP\r\n" // 8 bytes; the line break catches text-mode mangling
+#define SNAPSHOT_VERSION  1
+#define SNAPSHOT_TILE_DIM 64 // cells per side; a bit-packed tile row is one word
+
+namespace vt {
+
+class BitBoard;
+
+enum snapshot_cells_t {
+    SNAPSHOT_CELLS_BIT   = 1,  // alive or dead; restored as CONWAY_LIVE_COLOR or GENERATIONS_ALIVE
+    SNAPSHOT_CELLS_BYTE  = 8,  // Texture::R8 texels (Generations states)
+    SNAPSHOT_CELLS_FLOAT = 32  // Texture::RED texels, bit for bit (e.g. GROW_COLOR, or the maze textures)
+};
+
+enum snapshot_encoding_t {
+    SNAPSHOT_ENCODING_EMPTY, // every cell zero, no payload
+    SNAPSHOT_ENCODING_RAW,   // packed rows
+    SNAPSHOT_ENCODING_RUNS   // varint run lengths (alternating dead/alive) for bits, (varint run, value) otherwise
+};
+
+// on disk: header, tile payloads, then the tile index (row-major, written last so payloads stream straight out)
+// NOTE: fixed-size little-endian fields; the version is bumped whenever the layout changes
+struct snapshot_header_t
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t cells;    // snapshot_cells_t
+    int32_t  width;
+    int32_t  height;
+    uint32_t tile_dim;
+    uint32_t rule;     // life_rule_t
+    int32_t  states;
+    uint32_t reserved;
+    uint64_t generation;
+    uint64_t index_offset;
+};
+
+struct snapshot_tile_t
+{
+    uint64_t offset;   // from the start of the file
+    uint32_t size;     // bytes
+    uint32_t encoding; // snapshot_encoding_t
+};
+
+// board captured for a checkpoint, plus its generation counter and rule
+// NOTE: cells are kept raw in memory (row-major, bottom row first like Texture, bit rows padded to whole words),
+//       so a capture is a plain copy; tiles are only encoded on save(), each on its own so any tile can be read
+//       back without the rest
+class Snapshot
+{
+public:
+    Snapshot();
+
+    // accessors
+    glm::ivec2 get_dim() const        { return m_dim; }
+    glm::ivec2 get_tile_dim() const; // in tiles
+    snapshot_cells_t get_cells() const { return m_cells; }
+    size_t get_size() const           { return m_row_size * m_dim.y; } // bytes of cells in memory
+    uint64_t get_generation() const   { return m_generation; }
+    void set_generation(uint64_t generation)
+    {
+        m_generation = generation;
+    }
+    life_rule_t get_rule() const      { return m_rule; }
+    int get_states() const            { return m_states; }
+    void set_rule(life_rule_t rule, int states = 2)
+    {
+        m_rule   = rule;
+        m_states = states;
+    }
+    size_t get_population() const; // cells that are not zero
+
+    // capture (a copy; the board can keep stepping right after)
+    void capture(const BitBoard& board);
+    void capture_r32f(const float* pixels, glm::ivec2 dim, snapshot_cells_t cells = SNAPSHOT_CELLS_BIT); // or FLOAT
+    void capture_r8(const uint8_t* pixels, glm::ivec2 dim);
+
+    // restore; false if the size does not match
+    bool restore(BitBoard* board) const;
+    bool restore_r32f(float* pixels, glm::ivec2 dim) const;
+    bool restore_r8(uint8_t* pixels, glm::ivec2 dim) const;
+
+    // file i/o; save() writes filename + ".tmp" and renames it over filename, so a crash mid-write never leaves a
+    // torn checkpoint behind
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    // random access: only the tiles overlapping [pos, pos + dim) of the saved board are read and decoded
+    bool load_region(const std::string& filename, glm::ivec2 pos, glm::ivec2 dim);
+
+    void swap(Snapshot& other);
+
+private:
+    friend class Recorder; // the tile codec, on frame deltas
+    friend class Replayer;
+
+    glm::ivec2            m_dim;
+    snapshot_cells_t      m_cells;
+    size_t                m_row_size; // bytes
+    uint64_t              m_generation;
+    life_rule_t           m_rule;
+    int                   m_states;
+    std::vector<uint64_t> m_data;     // word-aligned, so bit rows can be read as words
+
+    const uint8_t* get_row(int y) const
+    {
+        return reinterpret_cast<const uint8_t*>(&m_data[0]) + y * m_row_size;
+    }
+    uint8_t* get_row(int y)
+    {
+        return reinterpret_cast<uint8_t*>(&m_data[0]) + y * m_row_size;
+    }
+    int get_cell_size() const; // bytes, 0 for bits
+    void resize(glm::ivec2 dim, snapshot_cells_t cells);
+    void xor_cells(const Snapshot& other); // same dim and cells; zero wherever the two agree
+    static void put_varint(std::vector<uint8_t>* out, uint64_t value); // out
+    static bool get_varint(const uint8_t** p, const uint8_t* end, uint64_t* value); // IN/OUT, out
+    bool load(const std::string& filename, glm::ivec2 pos, glm::ivec2 dim, bool whole);
+    snapshot_encoding_t encode_tile(glm::ivec2 tile_pos, std::vector<uint8_t>* payload) const; // out
+    bool decode_tile(snapshot_encoding_t   encoding,
+                     const uint8_t*        payload,
+                     size_t                size,
+                     glm::ivec2            tile_dim, // in cells, clipped to the board
+                     std::vector<uint8_t>* cells) const; // out; tile rows, one word each for bits
+    void blit_tile(const std::vector<uint8_t>& cells,
+                   glm::ivec2                  tile_dim,
+                   glm::ivec2                  pos,                // in this board
+                   bool                        apply_xor = false); // xor into the board instead of or/copy
+};
+
+// saves snapshots on a background thread, so a checkpoint costs the simulation one capture and not the encode or
+// the disk write
+class SnapshotWriter
+{
+public:
+    SnapshotWriter();
+    virtual ~SnapshotWriter(); // finishes the pending write
+
+    // hands the snapshot over by swapping it with the last one written (buffers are reused, nothing is copied);
+    // false if the previous write is still running, in which case this checkpoint is skipped
+    bool submit(Snapshot* snapshot, const std::string& filename); // IN/OUT
+    bool is_busy() const;
+    void wait();
+
+    long get_written() const;
+    long get_skipped() const;
+    long get_failed() const;
+    double get_write_time() const; // seconds spent encoding and writing, off the simulation thread
+
+private:
+    std::thread             m_thread;
+    mutable std::mutex      m_mutex;
+    std::condition_variable m_start_cond;
+    std::condition_variable m_done_cond;
+    Snapshot                m_snapshot;
+    std::string             m_filename;
+    bool                    m_busy;
+    bool                    m_quit;
+    long                    m_written;
+    long                    m_skipped;
+    long                    m_failed;
+    double                  m_write_time;
+
+    void run();
+};
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_STRIP_BOARD_H_
+#define VT_STRIP_BOARD_H_
+
+#include <LifeKernel.h>
+#include <LifeRule.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define STRIP_BOARD_RING_DEPTH 4 // generations a strip can run ahead of a neighbor's reads
+
+namespace vt {
+
+struct strip_control_t;
+struct strip_worker_t;
+
+// one bit-packed board split into horizontal strips, each stepped by its own process with the BitBoard kernel
+// NOTE: the strips only share their boundary rows: after every generation each process pushes its top and bottom
+//       rows into single-producer/single-consumer rings in POSIX shared memory, tagged with the generation they
+//       belong to, and pulls its neighbors' rows into its guard rows (see BitBoard::set_guard_rows). Besides the
+//       rings, the shared segment holds the whole board as two bit planes (cells and grow bits), which are only
+//       touched on load and store, and a command block the parent uses to drive the workers
+class StripBoard
+{
+public:
+    StripBoard(glm::ivec2 dim, int process_count);
+    virtual ~StripBoard(); // stops the workers
+
+    // accessors
+    bool is_open() const                { return m_segment != NULL; } // false if the shared segment failed
+    bool is_failed() const              { return m_failed; } // a worker could not be started or died
+    glm::ivec2 get_dim() const          { return m_dim; }
+    int get_process_count() const       { return m_process_count; }
+    int get_row_begin(int process_index) const // first board row of the process's strip
+    {
+        return static_cast<long>(m_dim.y) * process_index / m_process_count;
+    }
+    long get_generation() const         { return m_generation; }
+    double get_elapsed_time() const     { return m_elapsed_time; } // wall-clock seconds spent in step()
+    double get_generations_per_sec() const;
+    size_t get_population();
+
+    // per process: seconds in the kernel, and seconds pushing, waiting for and pulling boundary rows
+    double get_compute_time(int process_index) const;
+    double get_halo_time(int process_index) const;
+    uint64_t get_halo_bytes() const; // pushed by all processes
+
+    // NOTE: only before start(); every worker takes a copy when it is forked
+    void set_rule(life_rule_t rule)                      { m_rule = rule; }
+    life_rule_t get_rule() const                         { return m_rule; }
+    void set_kernel_type(life_kernel_type_t kernel_type) { m_kernel_type = kernel_type; }
+    life_kernel_type_t get_kernel_type() const           { return m_kernel_type; }
+    void set_skip_stable_tiles(bool skip_stable_tiles)   { m_skip_stable_tiles = skip_stable_tiles; }
+    void set_cursor_pos(glm::ivec2 cursor_pos)           { m_cursor_pos = cursor_pos; }
+
+    // forks the workers
+    // NOTE: call before any other thread exists; a forked child only gets the calling thread
+    bool start();
+
+    // texture interop (Texture::RED layout, see BitBoard), through the shared bit planes
+    bool load_r32f(const float* pixels);
+    bool store_r32f(float* pixels);
+
+    // core functionality
+    bool step(int iters = 1);
+    void reset_stats();
+
+private:
+    enum command_t {
+        COMMAND_LOAD,  // bit planes -> strips
+        COMMAND_STORE, // strips -> bit planes
+        COMMAND_STEP,
+        COMMAND_QUIT
+    };
+
+    glm::ivec2         m_dim;
+    int                m_process_count;
+    int                m_words_per_row;
+    life_rule_t        m_rule;
+    life_kernel_type_t m_kernel_type;
+    bool               m_skip_stable_tiles;
+    glm::ivec2         m_cursor_pos;
+    uint8_t*           m_segment;
+    size_t             m_segment_size; // bytes
+    size_t             m_ring_size;    // bytes per ring
+    strip_control_t*   m_control;
+    strip_worker_t*    m_workers;
+    uint64_t*          m_cells;        // bit plane, m_words_per_row words per row
+    uint64_t*          m_grow_cells;   // bit plane
+    std::vector<pid_t> m_pids;
+    bool               m_failed;
+    long               m_generation;
+    double             m_elapsed_time;
+
+    uint8_t* get_ring(int process_index, bool up) const; // boundary rows pushed by the process, up or down
+    bool run_command(command_t command, long generations = 0);
+    void run_worker(int process_index);
+};
+
+}
+
+#endif
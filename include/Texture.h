@@ -22,6 +22,7 @@
 #include <FrameObject.h>
 #include <IdentObject.h>
 #include <BindableObjectBase.h>
+#include <Boundary.h>
 #include <GL/glew.h>
 #include <string>
 #include <glm/glm.hpp>
@@ -37,7 +38,8 @@ class Texture : public NamedObject,
                 public BindableObjectBase
 {
 public:
-    typedef enum { RGBA, RGB, RED, DEPTH } format_t;
+    typedef enum { RGBA, RGB, RED, DEPTH, R8, RGBA32F } format_t; // RED is one float per texel, R8 one byte per texel,
+                                                                   // RGBA32F four floats per texel
 
     Texture(const std::string&         name            = "",
                   format_t             internal_format = Texture::RGBA,
@@ -99,10 +101,24 @@ public:
     void set_pixel_r32f(glm::ivec2 pos, float color);
     void set_color_r32f(float color);
 
+    // basic modifiers -- r8 only
+    unsigned char get_pixel_r8(glm::ivec2 pos) const;
+    void set_pixel_r8(glm::ivec2 pos, unsigned char color);
+    void set_color_r8(unsigned char color);
+
+    // basic modifiers -- rgba32f only
+    glm::vec4 get_pixel_rgba32f(glm::ivec2 pos) const;
+    void set_pixel_rgba32f(glm::ivec2 pos, glm::vec4 color);
+    void set_color_rgba32f(glm::vec4 color);
+
     // core functionality
     void update();
     void refresh();
 
+    // what a fetch just off the texture returns (see Boundary.h); textures start out as GL_REPEAT
+    // NOTE: lets a shader read its neighbors without testing for the border
+    void set_boundary_mode(boundary_mode_t boundary_mode);
+
 private:
     bool           m_skybox;
     format_t       m_internal_format;
@@ -0,0 +1,87 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef VT_THREAD_POOL_H_
+#define VT_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vt {
+
+// work-stealing thread pool; each parallel_for() call is one barrier-synchronized batch of tasks
+// NOTE: tasks are handed out in contiguous chunks per thread (for locality); idle threads steal from the back of
+//       other threads' queues
+class ThreadPool
+{
+public:
+    typedef std::function<void(int task_index, int thread_index)> task_func_t;
+
+    struct thread_stats_t
+    {
+        double busy_time; // seconds spent running tasks
+        long   tasks;
+        long   steals;
+    };
+
+    explicit ThreadPool(int thread_count = 0); // 0 for std::thread::hardware_concurrency()
+    virtual ~ThreadPool();
+
+    int get_thread_count() const
+    {
+        return static_cast<int>(m_workers.size());
+    }
+    const thread_stats_t& get_thread_stats(int thread_index) const
+    {
+        return m_workers[thread_index]->m_stats;
+    }
+    double get_imbalance() const; // max busy time / mean busy time (1 is perfect balance)
+    void reset_stats();
+
+    // blocks until every task has run
+    void parallel_for(int task_count, const task_func_t& func);
+
+private:
+    struct Worker
+    {
+        std::thread     m_thread;
+        std::mutex      m_mutex;
+        std::deque<int> m_tasks;
+        thread_stats_t  m_stats;
+    };
+
+    std::vector<Worker*>    m_workers;
+    std::mutex              m_mutex;
+    std::condition_variable m_start_cond;
+    std::condition_variable m_done_cond;
+    const task_func_t*      m_func;
+    long                    m_epoch;
+    int                     m_busy_workers;
+    bool                    m_quit;
+
+    void worker_main(int thread_index);
+    bool pop_task(int thread_index, int* task_index, bool* stolen); // out
+};
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#ifndef VT_TILED_BOARD_H_
+#define VT_TILED_BOARD_H_
+
+#include <BitBoard.h>
+#include <LifeKernel.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TILED_BOARD_TILE_DIM   256 // cells per side
+#define TILED_BOARD_TILE_WORDS (TILED_BOARD_TILE_DIM / BITBOARD_WORD_BITS)
+#define TILED_BOARD_TILE_SIZE  (TILED_BOARD_TILE_DIM * TILED_BOARD_TILE_WORDS) // 8KB per tile per buffer
+#define TILED_BOARD_DEFAULT_CACHE_TILES 8192 // 128MB (both buffers)
+
+namespace vt {
+
+// out-of-core bit-packed board; tiles live in a memory-mapped scratch file (both ping-pong buffers side by side),
+// and only tiles that may hold live cells (or border one) are ever touched
+// NOTE: a resident set of at most get_cache_tiles() tiles is kept in LRU order; evicted tiles are dropped from
+//       the mapping (madvise), so the kernel can write them back and reclaim the memory. Boards can be far larger
+//       than RAM as long as the live part fits in the file system
+class TiledBoard
+{
+public:
+    TiledBoard(glm::ivec2 dim, const std::string& filename, size_t cache_tiles = TILED_BOARD_DEFAULT_CACHE_TILES);
+    virtual ~TiledBoard(); // removes the file
+
+    // accessors
+    bool is_open() const            { return m_map != NULL; } // false if the file could not be created or mapped
+    glm::ivec2 get_dim() const      { return m_dim; }
+    glm::ivec2 get_tile_dim() const { return m_tile_dim; } // in tiles
+    int get_tile_count() const      { return m_tile_dim.x * m_tile_dim.y; }
+    long get_generation() const     { return m_generation; }
+    double get_elapsed_time() const { return m_elapsed_time; } // seconds spent in step()
+    double get_generations_per_sec() const;
+    size_t get_population();
+    size_t get_occupied_tile_count() const;
+
+    // simd variant and life-like rule (see BitBoard); B0 rules are rejected, empty tiles must stay empty
+    life_kernel_type_t get_kernel_type() const { return m_kernel_type; }
+    bool set_kernel_type(life_kernel_type_t kernel_type);
+    life_rule_t get_rule() const               { return m_rule; }
+    bool set_rule(life_rule_t rule);
+
+    // paging
+    size_t get_cache_tiles() const    { return m_cache_tiles; }
+    void set_cache_tiles(size_t cache_tiles);
+    size_t get_resident_tiles() const { return m_resident_count; }
+    long get_page_ins() const         { return m_page_ins; }   // tiles brought into the resident set
+    long get_evictions() const        { return m_evictions; }  // tiles dropped from it
+    long get_tiles_stepped() const    { return m_tiles_stepped; } // tiles run through the kernel
+
+    // basic modifiers
+    bool get_cell(glm::ivec2 pos);
+    void set_cell(glm::ivec2 pos, bool alive);
+    void clear();
+    void draw_x();    // same pattern as ConwayEngine::draw_x
+    void randomize(); // half the cells alive, a word of random bits at a time
+
+    // texture interop (Texture::RED layout, whole board; only for boards that fit in memory)
+    // NOTE: no grow bits are kept, so live cells are stored as CONWAY_LIVE_COLOR
+    void load_r32f(const float* pixels);
+    void store_r32f(float* pixels);
+
+    // core functionality
+    void step(int iters = 1);
+    void reset_stats();
+
+private:
+    glm::ivec2            m_dim;
+    glm::ivec2            m_tile_dim; // in tiles
+    std::string           m_filename;
+    int                   m_fd;
+    uint64_t*             m_map;
+    size_t                m_map_size; // bytes
+    int                   m_buffer;   // current half of each tile's pair
+    life_kernel_type_t    m_kernel_type;
+    life_kernel_t         m_kernel;
+    life_rule_t           m_rule;
+    std::vector<char>     m_occupied;  // input; may hold live cells
+    std::vector<char>     m_occupied2; // output
+    std::vector<int>      m_lru_prev;  // intrusive list over tile indices, most recently used first
+    std::vector<int>      m_lru_next;
+    std::vector<char>     m_resident;
+    int                   m_lru_head;
+    int                   m_lru_tail;
+    size_t                m_resident_count;
+    size_t                m_cache_tiles;
+    std::vector<uint64_t> m_scratch;      // one tile plus a one-word, one-row halo
+    std::vector<uint64_t> m_scratch_out;
+    std::vector<uint64_t> m_scratch_grow;
+    long                  m_page_ins;
+    long                  m_evictions;
+    long                  m_tiles_stepped;
+    long                  m_generation;
+    double                m_elapsed_time;
+
+    uint64_t* get_tile(int tile_index, int buffer) const
+    {
+        return m_map + (static_cast<size_t>(tile_index) * 2 + buffer) * TILED_BOARD_TILE_SIZE;
+    }
+    int get_tile_words(int tile_x) const; // words of a tile row that are on the board
+    int get_tile_rows(int tile_y) const;
+    void touch_tile(int tile_index);
+    void evict_tile();
+    void step_tile(int tile_index);
+};
+
+}
+
+#endif
@@ -0,0 +1,672 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <BitBoard.h>
+#include <ConwayEngine.h>
+#include <CycleDetector.h>
+#include <LifeKernel.h>
+#include <ThreadPool.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <memory.h>
+
+namespace vt {
+
+BitBoard::BitBoard(glm::ivec2 dim)
+    : m_dim(dim),
+      m_words_per_row((dim.x + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS),
+      m_stride(0),
+      m_last_word_mask(0),
+      m_words(NULL),
+      m_words2(NULL),
+      m_grow_words(NULL),
+      m_kernel_type(life_kernel_best()),
+      m_kernel(get_life_kernel(m_kernel_type)),
+      m_rule(LIFE_RULE_CONWAY),
+      m_boundary_mode(BOUNDARY_DEAD),
+      m_thread_pool(NULL),
+      m_tile_dim((m_words_per_row + BITBOARD_TILE_WORDS - 1) / BITBOARD_TILE_WORDS,
+                 (dim.y + BITBOARD_TILE_ROWS - 1) / BITBOARD_TILE_ROWS),
+      m_skip_stable_tiles(true),
+      m_hash(0),
+      m_tiles_stepped(0),
+      m_block_generations(1),
+      m_prev_block_generations(1),
+      m_bytes_moved(0),
+      m_cursor_pos(-1),
+      m_generation(0),
+      m_elapsed_time(0)
+{
+    m_stride = m_words_per_row + 2; // guard words
+    int last_word_bits = m_dim.x - (m_words_per_row - 1) * BITBOARD_WORD_BITS;
+    m_last_word_mask = (last_word_bits == BITBOARD_WORD_BITS) ? ~0ULL : ((1ULL << last_word_bits) - 1);
+    size_t n = m_stride * (m_dim.y + 2); // guard rows
+    m_words      = new uint64_t[n];
+    m_words2     = new uint64_t[n];
+    m_grow_words = new uint64_t[n];
+    memset(m_words,      0, sizeof(uint64_t) * n);
+    memset(m_words2,     0, sizeof(uint64_t) * n);
+    memset(m_grow_words, 0, sizeof(uint64_t) * n);
+    m_tile_changed.resize(get_tile_count(), 1);
+    m_tile_changed2.resize(get_tile_count(), 0);
+    m_tile_hash.resize(get_tile_count(), 0);
+    m_tile_hash_dirty.resize(get_tile_count(), 1);
+}
+
+BitBoard::~BitBoard()
+{
+    if(m_words) {
+        delete[] m_words;
+    }
+    if(m_words2) {
+        delete[] m_words2;
+    }
+    if(m_grow_words) {
+        delete[] m_grow_words;
+    }
+}
+
+double BitBoard::get_generations_per_sec() const
+{
+    if(m_elapsed_time <= 0) {
+        return 0;
+    }
+    return m_generation / m_elapsed_time;
+}
+
+double BitBoard::get_bytes_per_generation() const
+{
+    if(!m_generation) {
+        return 0;
+    }
+    return m_bytes_moved / m_generation;
+}
+
+size_t BitBoard::get_population() const
+{
+    size_t population = 0;
+    for(int y = 0; y < m_dim.y; y++) {
+        const uint64_t* row = get_row(y);
+        for(int i = 0; i < m_words_per_row; i++) {
+            population += __builtin_popcountll(row[i]);
+        }
+    }
+    return population;
+}
+
+//================
+// basic modifiers
+//================
+
+bool BitBoard::get_cell(glm::ivec2 pos) const
+{
+    return (get_row(pos.y)[pos.x / BITBOARD_WORD_BITS] >> (pos.x % BITBOARD_WORD_BITS)) & 1;
+}
+
+void BitBoard::set_cell(glm::ivec2 pos, bool alive)
+{
+    uint64_t  bit  = 1ULL << (pos.x % BITBOARD_WORD_BITS);
+    uint64_t* word = &get_row(pos.y)[pos.x / BITBOARD_WORD_BITS];
+    if(alive) {
+        *word |= bit;
+    } else {
+        *word &= ~bit;
+    }
+    int tile_index = (pos.y / BITBOARD_TILE_ROWS) * m_tile_dim.x + pos.x / (BITBOARD_WORD_BITS * BITBOARD_TILE_WORDS);
+    m_tile_changed[tile_index]    = 1;
+    m_tile_hash_dirty[tile_index] = 1;
+}
+
+void BitBoard::clear()
+{
+    size_t n = m_stride * (m_dim.y + 2);
+    memset(m_words,      0, sizeof(uint64_t) * n);
+    memset(m_grow_words, 0, sizeof(uint64_t) * n);
+    mark_all_tiles_changed();
+}
+
+void BitBoard::set_guard_rows(const uint64_t* above, const uint64_t* below)
+{
+    const uint64_t* halos[2]     = {above, below};
+    int             rows[2]      = {m_dim.y, -1};
+    int             tile_rows[2] = {m_tile_dim.y - 1, 0};
+    for(int i = 0; i < 2; i++) {
+        std::vector<uint64_t>& prev_halo = m_guard_rows[i];
+        prev_halo.resize(m_words_per_row, 0); // the guard rows start out dead
+        uint64_t* guard_row = get_row(rows[i]);
+        for(int tile_x = 0; tile_x < m_tile_dim.x; tile_x++) {
+            int word_begin = tile_x * BITBOARD_TILE_WORDS;
+            int word_end   = std::min(word_begin + BITBOARD_TILE_WORDS, m_words_per_row);
+            uint64_t changed = 0;
+            for(int j = word_begin; j < word_end; j++) {
+                uint64_t word = halos[i] ? halos[i][j] : 0;
+                changed |= word ^ prev_halo[j];
+                prev_halo[j] = word;
+                guard_row[j] = word;
+            }
+            if(changed) {
+                m_tile_changed[tile_rows[i] * m_tile_dim.x + tile_x] = 1;
+            }
+        }
+    }
+}
+
+//==================
+// texture interop
+//==================
+
+// NOTE: any non-zero texel is alive; only GROW_COLOR texels are marked as grown
+void BitBoard::load_r32f(const float* pixels)
+{
+    if(!pixels) {
+        return;
+    }
+    clear();
+    for(int y = 0; y < m_dim.y; y++) {
+        const float* src      = &pixels[y * m_dim.x];
+        uint64_t*    row      = get_row(y);
+        uint64_t*    grow_row = get_grow_row(y);
+        for(int x = 0; x < m_dim.x; x++) {
+            uint64_t bit = 1ULL << (x % BITBOARD_WORD_BITS);
+            if(src[x] > 0) {
+                row[x / BITBOARD_WORD_BITS] |= bit;
+            }
+            if(src[x] == CONWAY_GROW_COLOR) {
+                grow_row[x / BITBOARD_WORD_BITS] |= bit;
+            }
+        }
+    }
+}
+
+void BitBoard::store_r32f(float* pixels) const
+{
+    if(!pixels) {
+        return;
+    }
+    for(int y = 0; y < m_dim.y; y++) {
+        float*          dest     = &pixels[y * m_dim.x];
+        const uint64_t* row      = get_row(y);
+        const uint64_t* grow_row = get_grow_row(y);
+        for(int x = 0; x < m_dim.x; x++) {
+            int shift = x % BITBOARD_WORD_BITS;
+            if(!((row[x / BITBOARD_WORD_BITS] >> shift) & 1)) {
+                dest[x] = CONWAY_DIE_COLOR;
+                continue;
+            }
+            dest[x] = ((grow_row[x / BITBOARD_WORD_BITS] >> shift) & 1) ? CONWAY_GROW_COLOR : CONWAY_LIVE_COLOR;
+        }
+    }
+}
+
+//===================
+// core functionality
+//===================
+
+void BitBoard::step(int iters)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for(int i = 0; i < iters;) {
+        int generations = (m_boundary_mode == BOUNDARY_DEAD) ? std::min(m_block_generations, iters - i) : 1;
+
+        // NOTE: a tile unchanged over the last block is only known to be unchanged over blocks of that length
+        if(generations != m_prev_block_generations) {
+            mark_all_tiles_changed();
+            m_prev_block_generations = generations;
+        }
+        if(generations == 1) {
+            if(m_boundary_mode != BOUNDARY_DEAD) {
+                fill_halo();
+                step_generation();
+                clear_halo();
+            } else {
+                step_generation();
+            }
+        } else {
+            step_block(generations);
+        }
+        std::swap(m_words, m_words2); // the elusive ping-pong swap (after the barrier)
+        m_tile_changed.swap(m_tile_changed2);
+
+        // NOTE: the single-threaded whole-board pass does not track changed tiles
+        if(generations == 1 && !m_skip_stable_tiles && !m_thread_pool) {
+            std::fill(m_tile_hash_dirty.begin(), m_tile_hash_dirty.end(), 1);
+        } else {
+            for(int j = 0; j < get_tile_count(); j++) {
+                m_tile_hash_dirty[j] |= m_tile_changed[j];
+            }
+        }
+        m_generation += generations;
+        i += generations;
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    m_elapsed_time += delta_time.count();
+}
+
+// NOTE: only generations % period are stepped; the cells (and grow bits) end up as if all of them had been
+void BitBoard::skip_generations(long generations, int period)
+{
+    if(period <= 0 || generations <= 0) {
+        return;
+    }
+    int remainder = generations % period;
+    step(remainder);
+    m_generation += generations - remainder;
+}
+
+void BitBoard::step_generation()
+{
+    if(m_skip_stable_tiles) {
+        update_active_tiles();
+        std::fill(m_tile_changed2.begin(), m_tile_changed2.end(), 0);
+        if(m_thread_pool) {
+            m_thread_pool->parallel_for(m_active_tiles.size(), [this](int task_index, int thread_index) {
+                step_tile(m_active_tiles[task_index]);
+            });
+        } else {
+            for(std::vector<int>::const_iterator p = m_active_tiles.begin(); p != m_active_tiles.end(); p++) {
+                step_tile(*p);
+            }
+        }
+        for(std::vector<int>::const_iterator p = m_active_tiles.begin(); p != m_active_tiles.end(); p++) {
+            m_bytes_moved += get_tile_bytes(*p, 1);
+        }
+        m_tiles_stepped += m_active_tiles.size();
+    } else {
+        if(m_thread_pool) {
+            m_thread_pool->parallel_for(get_tile_count(), [this](int tile_index, int thread_index) {
+                step_tile(tile_index);
+            });
+        } else {
+            for(int y = 0; y < m_dim.y; y++) {
+                m_kernel(get_row(y + 1),
+                         get_row(y),
+                         get_row(y - 1),
+                         get_row2(y),
+                         get_grow_row(y),
+                         m_words_per_row,
+                         m_last_word_mask,
+                         m_rule);
+            }
+        }
+        for(int i = 0; i < get_tile_count(); i++) {
+            m_bytes_moved += get_tile_bytes(i, 1);
+        }
+    }
+    if(m_cursor_pos.x >= 0 && m_cursor_pos.x < m_dim.x &&
+       m_cursor_pos.y >= 0 && m_cursor_pos.y < m_dim.y)
+    {
+        uint64_t bit = 1ULL << (m_cursor_pos.x % BITBOARD_WORD_BITS);
+        get_row2(m_cursor_pos.y)[m_cursor_pos.x / BITBOARD_WORD_BITS]     |= bit; // seed
+        get_grow_row(m_cursor_pos.y)[m_cursor_pos.x / BITBOARD_WORD_BITS] |= bit;
+
+        // NOTE: keeps the cursor tile live, so its grow bits get recomputed once the cursor leaves
+        m_tile_changed2[(m_cursor_pos.y / BITBOARD_TILE_ROWS) * m_tile_dim.x +
+                        m_cursor_pos.x / (BITBOARD_WORD_BITS * BITBOARD_TILE_WORDS)] = 1;
+    }
+}
+
+// NOTE: a skipped tile is k-periodic along with its neighbors, so k more generations leave it as is
+void BitBoard::step_block(int generations)
+{
+    if(m_skip_stable_tiles) {
+        update_active_tiles();
+    } else {
+        m_active_tiles.clear();
+        for(int i = 0; i < get_tile_count(); i++) {
+            m_active_tiles.push_back(i);
+        }
+    }
+    std::fill(m_tile_changed2.begin(), m_tile_changed2.end(), 0);
+    if(m_thread_pool) {
+        m_scratch.resize(m_thread_pool->get_thread_count());
+        m_thread_pool->parallel_for(m_active_tiles.size(), [this, generations](int task_index, int thread_index) {
+            step_tile_block(m_active_tiles[task_index], generations, thread_index);
+        });
+    } else {
+        m_scratch.resize(1);
+        for(std::vector<int>::const_iterator p = m_active_tiles.begin(); p != m_active_tiles.end(); p++) {
+            step_tile_block(*p, generations, 0);
+        }
+    }
+    for(std::vector<int>::const_iterator p = m_active_tiles.begin(); p != m_active_tiles.end(); p++) {
+        m_bytes_moved += get_tile_bytes(*p, generations);
+    }
+    m_tiles_stepped += m_active_tiles.size() * generations;
+    if(m_cursor_pos.x >= 0 && m_cursor_pos.x < m_dim.x &&
+       m_cursor_pos.y >= 0 && m_cursor_pos.y < m_dim.y)
+    {
+        m_tile_changed2[(m_cursor_pos.y / BITBOARD_TILE_ROWS) * m_tile_dim.x +
+                        m_cursor_pos.x / (BITBOARD_WORD_BITS * BITBOARD_TILE_WORDS)] = 1;
+    }
+}
+
+// NOTE: tiles only read their one-cell halo from the input buffer, so they never race
+void BitBoard::step_tile(int tile_index)
+{
+    int tile_x = tile_index % m_tile_dim.x;
+    int tile_y = tile_index / m_tile_dim.x;
+    int word_begin = tile_x * BITBOARD_TILE_WORDS;
+    int words      = std::min(BITBOARD_TILE_WORDS, m_words_per_row - word_begin);
+    int row_begin  = tile_y * BITBOARD_TILE_ROWS;
+    int row_end    = std::min(row_begin + BITBOARD_TILE_ROWS, m_dim.y);
+    uint64_t last_word_mask = (word_begin + words == m_words_per_row) ? m_last_word_mask : ~0ULL;
+    uint64_t changed = 0;
+    for(int y = row_begin; y < row_end; y++) {
+        const uint64_t* row  = get_row(y)  + word_begin;
+        uint64_t*       row2 = get_row2(y) + word_begin;
+        m_kernel(get_row(y + 1)      + word_begin,
+                 row,
+                 get_row(y - 1)      + word_begin,
+                 row2,
+                 get_grow_row(y)     + word_begin,
+                 words,
+                 last_word_mask,
+                 m_rule);
+        for(int i = 0; i < words; i++) {
+            changed |= row[i] ^ row2[i];
+        }
+    }
+    m_tile_changed2[tile_index] = (changed != 0);
+}
+
+// NOTE: scratch is the tile plus one halo word on either side (enough for k <= 64) and k halo rows above and below;
+//       cells outside the board are cleared after every local generation, so the board border stays dead
+void BitBoard::step_tile_block(int tile_index, int generations, int thread_index)
+{
+    int tile_x = tile_index % m_tile_dim.x;
+    int tile_y = tile_index / m_tile_dim.x;
+    int word_begin = tile_x * BITBOARD_TILE_WORDS;
+    int words      = std::min(BITBOARD_TILE_WORDS, m_words_per_row - word_begin);
+    int row_begin  = tile_y * BITBOARD_TILE_ROWS;
+    int row_end    = std::min(row_begin + BITBOARD_TILE_ROWS, m_dim.y);
+    int halo_rows  = generations;
+
+    int scratch_words  = words + 2;
+    int scratch_stride = scratch_words + 2; // guard words
+    int scratch_rows   = (row_end - row_begin) + halo_rows * 2;
+    size_t n = scratch_stride * (scratch_rows + 2); // guard rows
+    std::vector<uint64_t>& scratch = m_scratch[thread_index];
+    if(scratch.size() < n * 3) {
+        scratch.resize(n * 3);
+    }
+    uint64_t* words1     = &scratch[0];
+    uint64_t* words2     = &scratch[n];
+    uint64_t* grow_words = &scratch[n * 2];
+
+    // board word for scratch word j is word_begin - 1 + j; scratch row r is board row row_begin - halo_rows + r
+    uint64_t col_mask[BITBOARD_TILE_WORDS + 2];
+    bool     interior = true;
+    for(int j = 0; j < scratch_words; j++) {
+        int word = word_begin - 1 + j;
+        col_mask[j] = (word < 0 || word >= m_words_per_row) ? 0 :
+                      (word == m_words_per_row - 1)          ? m_last_word_mask : ~0ULL;
+        interior &= (col_mask[j] == ~0ULL);
+    }
+    int row_lo = std::max(0, halo_rows - row_begin);                      // first scratch row on the board
+    int row_hi = std::min(scratch_rows, m_dim.y - row_begin + halo_rows); // one past the last
+
+    // zero only what the kernel reads but never writes: guard words, and rows off the board (plus guard rows)
+    for(int r = -1; r <= scratch_rows; r++) {
+        uint64_t* row  = words1 + (r + 1) * scratch_stride + 1;
+        uint64_t* row2 = words2 + (r + 1) * scratch_stride + 1;
+        if(r < row_lo || r >= row_hi) {
+            memset(row  - 1, 0, sizeof(uint64_t) * scratch_stride);
+            memset(row2 - 1, 0, sizeof(uint64_t) * scratch_stride);
+            continue;
+        }
+        row[-1] = row[scratch_words] = row2[-1] = row2[scratch_words] = 0;
+        const uint64_t* src = get_row(row_begin - halo_rows + r) + word_begin - 1;
+        for(int j = 0; j < scratch_words; j++) {
+            row[j] = src[j] & col_mask[j]; // NOTE: past the row's guard word is the next row
+        }
+    }
+    int  cursor_r   = m_cursor_pos.y - (row_begin - halo_rows);
+    int  cursor_j   = m_cursor_pos.x / BITBOARD_WORD_BITS - (word_begin - 1);
+    bool has_cursor = m_cursor_pos.x >= 0 && m_cursor_pos.x < m_dim.x &&
+                      m_cursor_pos.y >= 0 && m_cursor_pos.y < m_dim.y &&
+                      cursor_r >= 0 && cursor_r < scratch_rows && cursor_j >= 0 && cursor_j < scratch_words;
+
+    // k local generations; errors from the scratch edge creep in one cell per generation and never reach the tile
+    // NOTE: rows farther from the tile than the remaining generations cannot affect it, so the band shrinks
+    for(int g = 0; g < generations; g++) {
+        int reach = generations - 1 - g;
+        int lo    = std::max(row_lo, halo_rows - reach);
+        int hi    = std::min(row_hi, scratch_rows - halo_rows + reach);
+        for(int r = lo; r < hi; r++) {
+            uint64_t* row  = words1 + (r + 1) * scratch_stride + 1;
+            uint64_t* row2 = words2 + (r + 1) * scratch_stride + 1;
+            m_kernel(row + scratch_stride,
+                     row,
+                     row - scratch_stride,
+                     row2,
+                     grow_words + (r + 1) * scratch_stride + 1,
+                     scratch_words,
+                     ~0ULL,
+                     m_rule);
+            if(!interior) {
+                for(int j = 0; j < scratch_words; j++) {
+                    row2[j] &= col_mask[j];
+                }
+            }
+        }
+        if(has_cursor) {
+            uint64_t bit = 1ULL << (m_cursor_pos.x % BITBOARD_WORD_BITS);
+            words2[(cursor_r + 1) * scratch_stride + 1 + cursor_j]     |= bit; // seed
+            grow_words[(cursor_r + 1) * scratch_stride + 1 + cursor_j] |= bit;
+        }
+        std::swap(words1, words2);
+    }
+
+    // write back once
+    uint64_t changed = 0;
+    for(int y = row_begin; y < row_end; y++) {
+        int r = y - row_begin + halo_rows;
+        const uint64_t* src      = words1     + (r + 1) * scratch_stride + 2;
+        const uint64_t* src_grow = grow_words + (r + 1) * scratch_stride + 2;
+        const uint64_t* row      = get_row(y)      + word_begin;
+        uint64_t*       row2     = get_row2(y)     + word_begin;
+        uint64_t*       grow_row = get_grow_row(y) + word_begin;
+        for(int i = 0; i < words; i++) {
+            row2[i]     = src[i];
+            grow_row[i] = src_grow[i] & col_mask[i + 1];
+            changed |= row[i] ^ src[i];
+        }
+    }
+    m_tile_changed2[tile_index] = (changed != 0);
+}
+
+// input tile plus halo read, output tile (cells and grow bits) written
+double BitBoard::get_tile_bytes(int tile_index, int halo_rows) const
+{
+    int tile_x = tile_index % m_tile_dim.x;
+    int tile_y = tile_index / m_tile_dim.x;
+    int words  = std::min(BITBOARD_TILE_WORDS, m_words_per_row - tile_x * BITBOARD_TILE_WORDS);
+    int rows   = std::min(BITBOARD_TILE_ROWS, m_dim.y - tile_y * BITBOARD_TILE_ROWS);
+    return sizeof(uint64_t) * (static_cast<double>(rows + halo_rows * 2) * (words + 2) + rows * words * 2);
+}
+
+uint64_t BitBoard::get_hash()
+{
+    for(int i = 0; i < get_tile_count(); i++) {
+        if(!m_tile_hash_dirty[i]) {
+            continue;
+        }
+        uint64_t tile_hash = get_tile_hash(i);
+        m_hash ^= m_tile_hash[i] ^ tile_hash;
+        m_tile_hash[i]       = tile_hash;
+        m_tile_hash_dirty[i] = 0;
+    }
+    return m_hash;
+}
+
+// NOTE: four independent lanes (see hash_bytes), seeded with the tile index so equal tiles in different
+//       places do not cancel out in the xor
+uint64_t BitBoard::get_tile_hash(int tile_index) const
+{
+    int tile_x = tile_index % m_tile_dim.x;
+    int tile_y = tile_index / m_tile_dim.x;
+    int word_begin = tile_x * BITBOARD_TILE_WORDS;
+    int words      = std::min(BITBOARD_TILE_WORDS, m_words_per_row - word_begin);
+    int row_begin  = tile_y * BITBOARD_TILE_ROWS;
+    int row_end    = std::min(row_begin + BITBOARD_TILE_ROWS, m_dim.y);
+    uint64_t seed = hash_mix(tile_index);
+    uint64_t lane0 = seed, lane1 = seed + 1, lane2 = seed + 2, lane3 = seed + 3;
+    for(int y = row_begin; y < row_end; y++) {
+        const uint64_t* row = get_row(y) + word_begin;
+        int i = 0;
+        for(; i + 4 <= words; i += 4) {
+            lane0 = hash_step(lane0, row[i]);
+            lane1 = hash_step(lane1, row[i + 1]);
+            lane2 = hash_step(lane2, row[i + 2]);
+            lane3 = hash_step(lane3, row[i + 3]);
+        }
+        for(; i < words; i++) {
+            lane0 = hash_step(lane0, row[i]);
+        }
+    }
+    return hash_mix(lane0 ^ hash_mix(lane1 ^ hash_mix(lane2 ^ hash_mix(lane3))));
+}
+
+// changed tiles dilated by one tile
+// NOTE: on a torus the tiles along opposite edges are neighbors
+void BitBoard::update_active_tiles()
+{
+    if(m_cursor_pos.x >= 0 && m_cursor_pos.x < m_dim.x &&
+       m_cursor_pos.y >= 0 && m_cursor_pos.y < m_dim.y)
+    {
+        m_tile_changed[(m_cursor_pos.y / BITBOARD_TILE_ROWS) * m_tile_dim.x +
+                       m_cursor_pos.x / (BITBOARD_WORD_BITS * BITBOARD_TILE_WORDS)] = 1; // seeded this generation
+    }
+    bool wrap = (m_boundary_mode == BOUNDARY_TORUS);
+    m_active_tiles.clear();
+    for(int tile_y = 0; tile_y < m_tile_dim.y; tile_y++) {
+        for(int tile_x = 0; tile_x < m_tile_dim.x; tile_x++) {
+            bool active = false;
+            for(int dy = -1; !active && dy <= 1; dy++) {
+                int y = wrap ? (tile_y + dy + m_tile_dim.y) % m_tile_dim.y : tile_y + dy;
+                if(y < 0 || y >= m_tile_dim.y) {
+                    continue;
+                }
+                for(int dx = -1; dx <= 1; dx++) {
+                    int x = wrap ? (tile_x + dx + m_tile_dim.x) % m_tile_dim.x : tile_x + dx;
+                    if(x >= 0 && x < m_tile_dim.x && m_tile_changed[y * m_tile_dim.x + x]) {
+                        active = true;
+                        break;
+                    }
+                }
+            }
+            if(active) {
+                m_active_tiles.push_back(tile_y * m_tile_dim.x + tile_x);
+            }
+        }
+    }
+}
+
+// the west neighbor of column 0 is the top bit of the left guard word; the east neighbor of the last column is the
+// bit just past it (in the last word's padding, or bit 0 of the right guard word if the width is a multiple of 64)
+// NOTE: rows are copied into the guard rows guard words included, so the corner cells come along
+void BitBoard::fill_halo()
+{
+    int      left_x   = get_boundary_index(m_boundary_mode, -1,      m_dim.x);
+    int      right_x  = get_boundary_index(m_boundary_mode, m_dim.x, m_dim.x);
+    int      pad_word = m_dim.x / BITBOARD_WORD_BITS;
+    uint64_t pad_bit  = 1ULL << (m_dim.x % BITBOARD_WORD_BITS);
+    for(int y = 0; y < m_dim.y; y++) {
+        uint64_t* row = get_row(y);
+        row[-1]        = ((row[left_x / BITBOARD_WORD_BITS] >> (left_x % BITBOARD_WORD_BITS)) & 1) << (BITBOARD_WORD_BITS - 1);
+        row[pad_word] |= ((row[right_x / BITBOARD_WORD_BITS] >> (right_x % BITBOARD_WORD_BITS)) & 1) ? pad_bit : 0;
+    }
+    memcpy(get_row(-1) - 1,
+           get_row(get_boundary_index(m_boundary_mode, -1, m_dim.y)) - 1,      sizeof(uint64_t) * m_stride);
+    memcpy(get_row(m_dim.y) - 1,
+           get_row(get_boundary_index(m_boundary_mode, m_dim.y, m_dim.y)) - 1, sizeof(uint64_t) * m_stride);
+}
+
+// padding bits are never cells (see get_population, get_hash); the guard rows are refilled before they are read
+void BitBoard::clear_halo()
+{
+    int      pad_word = m_dim.x / BITBOARD_WORD_BITS;
+    uint64_t pad_bit  = 1ULL << (m_dim.x % BITBOARD_WORD_BITS);
+    for(int y = 0; y < m_dim.y; y++) {
+        uint64_t* row = get_row(y);
+        row[-1]        = 0;
+        row[pad_word] &= ~pad_bit;
+    }
+}
+
+void BitBoard::mark_all_tiles_changed()
+{
+    std::fill(m_tile_changed.begin(), m_tile_changed.end(), 1);
+    std::fill(m_tile_hash_dirty.begin(), m_tile_hash_dirty.end(), 1);
+}
+
+void BitBoard::set_block_generations(int block_generations)
+{
+    m_block_generations = std::max(1, std::min(block_generations, BITBOARD_MAX_BLOCK_GENERATIONS));
+}
+
+void BitBoard::set_skip_stable_tiles(bool skip_stable_tiles)
+{
+    m_skip_stable_tiles = skip_stable_tiles;
+    mark_all_tiles_changed(); // flags go stale while disabled
+}
+
+bool BitBoard::set_kernel_type(life_kernel_type_t kernel_type)
+{
+    life_kernel_t kernel = get_life_kernel(kernel_type, m_rule);
+    if(!kernel) {
+        return false;
+    }
+    m_kernel_type = kernel_type;
+    m_kernel      = kernel;
+    return true;
+}
+
+// NOTE: under a B0 rule the off-board cells still read as dead, same as ConwayEngine
+void BitBoard::set_rule(life_rule_t rule)
+{
+    m_rule   = rule;
+    m_kernel = get_life_kernel(m_kernel_type, m_rule);
+    mark_all_tiles_changed(); // a stable tile under the old rule may not be stable under the new one
+}
+
+void BitBoard::set_boundary_mode(boundary_mode_t boundary_mode)
+{
+    m_boundary_mode = boundary_mode;
+    if(m_boundary_mode == BOUNDARY_DEAD) {
+        uint64_t* buffers[2] = {m_words, m_words2};
+        for(int i = 0; i < 2; i++) {
+            memset(buffers[i],                              0, sizeof(uint64_t) * m_stride);
+            memset(buffers[i] + (m_dim.y + 1) * m_stride, 0, sizeof(uint64_t) * m_stride);
+        }
+        m_guard_rows[0].clear();
+        m_guard_rows[1].clear();
+    }
+    mark_all_tiles_changed(); // edge tiles see different neighbors
+}
+
+void BitBoard::reset_stats()
+{
+    m_generation    = 0;
+    m_tiles_stepped = 0;
+    m_bytes_moved   = 0;
+    m_elapsed_time  = 0;
+}
+
+}
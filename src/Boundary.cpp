@@ -0,0 +1,61 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <Boundary.h>
+#include <string.h>
+
+namespace vt {
+
+static const char* boundary_mode_names[] = {"dead", "torus", "mirror"};
+
+const char* get_boundary_mode_name(boundary_mode_t mode)
+{
+    if(mode < 0 || mode >= BOUNDARY_COUNT) {
+        return "";
+    }
+    return boundary_mode_names[mode];
+}
+
+bool find_boundary_mode(const char* name, boundary_mode_t* mode)
+{
+    for(int i = 0; i < BOUNDARY_COUNT; i++) {
+        if(!strcmp(name, boundary_mode_names[i])) {
+            *mode = static_cast<boundary_mode_t>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int get_boundary_index(boundary_mode_t mode, int index, int dim)
+{
+    if(index >= 0 && index < dim) {
+        return index;
+    }
+    switch(mode) {
+        case BOUNDARY_TORUS:
+            return (index < 0) ? dim - 1 : 0;
+        case BOUNDARY_MIRROR:
+            return (index < 0) ? 0 : dim - 1;
+        default:
+            return -1;
+    }
+}
+
+}
@@ -20,14 +20,14 @@
 
 namespace vt {
 
-Buffer::Buffer(GLenum target, size_t size, void* data)
+Buffer::Buffer(GLenum target, size_t size, void* data, GLenum usage)
     : m_target(target),
       m_size(size),
       m_data(data)
 {
     glGenBuffers(1, &m_id);
     bind();
-    glBufferData(target, size, data, GL_STATIC_DRAW);
+    glBufferData(target, size, data, usage);
 }
 
 Buffer::~Buffer()
@@ -46,4 +46,22 @@ void Buffer::bind()
     glBindBuffer(m_target, m_id);
 }
 
+void Buffer::unbind()
+{
+    glBindBuffer(m_target, 0);
+}
+
+const void* Buffer::map_read()
+{
+    bind();
+    return glMapBuffer(m_target, GL_READ_ONLY);
+}
+
+void Buffer::unmap()
+{
+    bind();
+    glUnmapBuffer(m_target);
+    unbind();
+}
+
 }
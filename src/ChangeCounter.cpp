@@ -0,0 +1,96 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <ChangeCounter.h>
+#include <GL/glew.h>
+#include <algorithm>
+
+namespace vt {
+
+ChangeCounter::ChangeCounter()
+    : m_next_query(0),
+      m_query_open(false),
+      m_serial(0),
+      m_result_serial(0)
+{
+    glGenQueries(CHANGE_COUNTER_QUERIES, m_query_ids);
+    std::fill(m_query_serials, m_query_serials + CHANGE_COUNTER_QUERIES, 0);
+    reset();
+}
+
+ChangeCounter::~ChangeCounter()
+{
+    glDeleteQueries(CHANGE_COUNTER_QUERIES, m_query_ids);
+}
+
+void ChangeCounter::begin()
+{
+    m_serial++;
+    m_passes++;
+    if(m_query_open || m_query_serials[m_next_query]) {
+        return;
+    }
+    glBeginQuery(GL_SAMPLES_PASSED, m_query_ids[m_next_query]);
+    m_query_open = true;
+}
+
+void ChangeCounter::end()
+{
+    if(!m_query_open) {
+        return;
+    }
+    glEndQuery(GL_SAMPLES_PASSED);
+    m_query_open = false;
+    m_query_serials[m_next_query] = m_serial;
+    m_next_query = (m_next_query + 1) % CHANGE_COUNTER_QUERIES;
+}
+
+// NOTE: results still pending for passes begun before the reset are read and dropped by poll()
+void ChangeCounter::reset()
+{
+    m_reset_serial = m_serial + 1;
+    m_changed      = -1;
+    m_passes       = 0;
+    m_settled      = false;
+}
+
+// NOTE: a pending result is polled, never waited for
+bool ChangeCounter::poll()
+{
+    for(int i = 0; i < CHANGE_COUNTER_QUERIES; i++) {
+        if(!m_query_serials[i]) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(m_query_ids[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available) {
+            continue;
+        }
+        GLuint samples = 0;
+        glGetQueryObjectuiv(m_query_ids[i], GL_QUERY_RESULT, &samples);
+        if(m_query_serials[i] >= m_reset_serial && m_query_serials[i] > m_result_serial) {
+            m_result_serial = m_query_serials[i];
+            m_changed       = samples;
+            m_settled       = (samples == 0);
+        }
+        m_query_serials[i] = 0;
+    }
+    return m_settled;
+}
+
+}
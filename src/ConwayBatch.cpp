@@ -0,0 +1,191 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <ConwayBatch.h>
+#include <BitBoard.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+
+namespace vt {
+
+ConwayBatch::ConwayBatch(glm::ivec2 universe_dim, int universe_count)
+    : m_universe_dim(universe_dim),
+      m_universe_count(universe_count),
+      m_grid_dim(get_grid_dim(universe_count)),
+      m_board(NULL),
+      m_elapsed_time(0)
+{
+    glm::ivec2 atlas_dim = get_atlas_dim();
+    m_board = new BitBoard(atlas_dim);
+    m_board->set_block_generations(1); // gutters are cleared between generations
+    m_gutter_mask.assign(m_board->get_words_per_row(), ~0ULL);
+    for(int x = m_universe_dim.x; x < atlas_dim.x; x += m_universe_dim.x + 1) {
+        m_gutter_mask[x / BITBOARD_WORD_BITS] &= ~(1ULL << (x % BITBOARD_WORD_BITS));
+    }
+}
+
+ConwayBatch::~ConwayBatch()
+{
+    if(m_board) {
+        delete m_board;
+    }
+}
+
+glm::ivec2 ConwayBatch::get_universe_origin(int universe_index) const
+{
+    return glm::ivec2((universe_index % m_grid_dim.x) * (m_universe_dim.x + 1),
+                      (universe_index / m_grid_dim.x) * (m_universe_dim.y + 1));
+}
+
+// as square as possible
+glm::ivec2 ConwayBatch::get_grid_dim(int universe_count)
+{
+    int columns = std::max(1, static_cast<int>(ceil(sqrt(static_cast<double>(universe_count)))));
+    return glm::ivec2(columns, std::max(1, (universe_count + columns - 1) / columns));
+}
+
+glm::ivec2 ConwayBatch::get_atlas_dim(glm::ivec2 universe_dim, int universe_count)
+{
+    glm::ivec2 grid_dim = get_grid_dim(universe_count);
+    return glm::ivec2(grid_dim.x * (universe_dim.x + 1) - 1,
+                      grid_dim.y * (universe_dim.y + 1) - 1);
+}
+
+double ConwayBatch::get_generations_per_sec() const
+{
+    if(m_elapsed_time <= 0) {
+        return 0;
+    }
+    return get_generation() / m_elapsed_time;
+}
+
+//================
+// basic modifiers
+//================
+
+bool ConwayBatch::get_cell(int universe_index, glm::ivec2 pos) const
+{
+    return m_board->get_cell(get_universe_origin(universe_index) + pos);
+}
+
+void ConwayBatch::set_cell(int universe_index, glm::ivec2 pos, bool alive)
+{
+    m_board->set_cell(get_universe_origin(universe_index) + pos, alive);
+}
+
+//==================
+// texture interop
+//==================
+
+void ConwayBatch::load_r32f(int universe_index, const float* pixels)
+{
+    if(!pixels) {
+        return;
+    }
+    for(int y = 0; y < m_universe_dim.y; y++) {
+        for(int x = 0; x < m_universe_dim.x; x++) {
+            set_cell(universe_index, glm::ivec2(x, y), pixels[y * m_universe_dim.x + x] > 0);
+        }
+    }
+}
+
+void ConwayBatch::load_r32f(const float* pixels)
+{
+    m_board->load_r32f(pixels);
+    clear_gutters();
+}
+
+void ConwayBatch::store_r32f(float* pixels) const
+{
+    m_board->store_r32f(pixels);
+}
+
+// NOTE: counts bits [x0, x0 + universe width) of each row, a word at a time
+void ConwayBatch::get_populations(std::vector<size_t>* populations) const
+{
+    populations->assign(m_universe_count, 0);
+    for(int y = 0; y < m_board->get_dim().y; y++) {
+        int grid_y = y / (m_universe_dim.y + 1);
+        if(y % (m_universe_dim.y + 1) == m_universe_dim.y) {
+            continue; // gutter row
+        }
+        const uint64_t* row = m_board->get_row(y);
+        for(int grid_x = 0; grid_x < m_grid_dim.x; grid_x++) {
+            int universe_index = grid_y * m_grid_dim.x + grid_x;
+            if(universe_index >= m_universe_count) {
+                break;
+            }
+            int x0 = grid_x * (m_universe_dim.x + 1);
+            int x1 = x0 + m_universe_dim.x;
+            size_t population = 0;
+            for(int w = x0 / BITBOARD_WORD_BITS; w <= (x1 - 1) / BITBOARD_WORD_BITS; w++) {
+                uint64_t word = row[w];
+                if(w == x0 / BITBOARD_WORD_BITS) {
+                    word &= ~0ULL << (x0 % BITBOARD_WORD_BITS);
+                }
+                if(w == (x1 - 1) / BITBOARD_WORD_BITS && x1 % BITBOARD_WORD_BITS) {
+                    word &= (1ULL << (x1 % BITBOARD_WORD_BITS)) - 1;
+                }
+                population += __builtin_popcountll(word);
+            }
+            (*populations)[universe_index] += population;
+        }
+    }
+}
+
+//===================
+// core functionality
+//===================
+
+void ConwayBatch::step(int iters)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for(int i = 0; i < iters; i++) {
+        m_board->step();
+        clear_gutters();
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    m_elapsed_time += delta_time.count();
+}
+
+void ConwayBatch::reset_stats()
+{
+    m_board->reset_stats();
+    m_elapsed_time = 0;
+}
+
+// NOTE: cells born in a gutter are cleared before anyone reads them; the bitboard's changed-tile flags only get
+//       more conservative, and both ping-pong buffers have clear gutters whenever they are the input
+void ConwayBatch::clear_gutters()
+{
+    int words_per_row = m_board->get_words_per_row();
+    for(int y = 0; y < m_board->get_dim().y; y++) {
+        uint64_t* row = m_board->get_row(y);
+        if(y % (m_universe_dim.y + 1) == m_universe_dim.y) {
+            std::fill(row, row + words_per_row, 0);
+            continue;
+        }
+        for(int w = 0; w < words_per_row; w++) {
+            row[w] &= m_gutter_mask[w];
+        }
+    }
+}
+
+}
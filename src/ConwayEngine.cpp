@@ -0,0 +1,205 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <ConwayEngine.h>
+#include <Boundary.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+#include <memory.h>
+
+namespace vt {
+
+static inline int live_column(const float* up, const float* row, const float* down, int x)
+{
+    return (up[x] > 0) + (row[x] > 0) + (down[x] > 0);
+}
+
+// sum includes the cell itself
+static inline float next_color(life_rule_t rule, float color, int sum)
+{
+    sum -= (color > 0);
+    if(!life_rule_lookup(rule, color > 0, sum)) {
+        return CONWAY_DIE_COLOR;
+    }
+    if(life_rule_lookup(rule, false, sum)) {
+        return CONWAY_GROW_COLOR;
+    }
+    return (color == CONWAY_GROW_COLOR) ? CONWAY_LIVE_COLOR : color; // add extra transitional color for aesthetic purpose
+}
+
+ConwayEngine::ConwayEngine(glm::ivec2 dim)
+    : m_dim(dim),
+      m_pixels(NULL),
+      m_pixels2(NULL),
+      m_zero_row(NULL),
+      m_cursor_pos(-1),
+      m_rule(LIFE_RULE_CONWAY),
+      m_boundary_mode(BOUNDARY_DEAD),
+      m_generation(0),
+      m_elapsed_time(0)
+{
+    size_t n = m_dim.x * m_dim.y;
+    m_pixels   = new float[n];
+    m_pixels2  = new float[n];
+    m_zero_row = new float[m_dim.x];
+    memset(m_pixels,   0, sizeof(float) * n);
+    memset(m_pixels2,  0, sizeof(float) * n);
+    memset(m_zero_row, 0, sizeof(float) * m_dim.x);
+}
+
+ConwayEngine::~ConwayEngine()
+{
+    if(m_pixels) {
+        delete[] m_pixels;
+    }
+    if(m_pixels2) {
+        delete[] m_pixels2;
+    }
+    if(m_zero_row) {
+        delete[] m_zero_row;
+    }
+}
+
+double ConwayEngine::get_generations_per_sec() const
+{
+    if(m_elapsed_time <= 0) {
+        return 0;
+    }
+    return m_generation / m_elapsed_time;
+}
+
+size_t ConwayEngine::get_population() const
+{
+    size_t n = m_dim.x * m_dim.y;
+    size_t population = 0;
+    for(int i = 0; i < static_cast<int>(n); i++) {
+        population += (m_pixels[i] > 0);
+    }
+    return population;
+}
+
+//================
+// basic modifiers
+//================
+
+void ConwayEngine::set_color(float color)
+{
+    size_t n = m_dim.x * m_dim.y;
+    std::fill(m_pixels, m_pixels + n, color);
+}
+
+// NOTE: same pattern as Texture::draw_x
+void ConwayEngine::draw_x()
+{
+    size_t min_dim = std::min(m_dim.x, m_dim.y);
+    for(int i = 0; i < static_cast<int>(min_dim); i++) {
+        m_pixels[i * m_dim.x + i]                 = CONWAY_GROW_COLOR;
+        m_pixels[i * m_dim.x + (m_dim.x - 1 - i)] = CONWAY_GROW_COLOR;
+    }
+}
+
+// NOTE: same distribution as Texture::randomize
+void ConwayEngine::randomize()
+{
+    size_t n = m_dim.x * m_dim.y;
+    for(int i = 0; i < static_cast<int>(n); i++) {
+        m_pixels[i] = (static_cast<float>(rand()) / RAND_MAX) > 0.5;
+    }
+}
+
+//==================
+// texture interop
+//==================
+
+void ConwayEngine::load(const float* pixels)
+{
+    if(!pixels) {
+        return;
+    }
+    memcpy(m_pixels, pixels, sizeof(float) * m_dim.x * m_dim.y);
+}
+
+void ConwayEngine::store(float* pixels) const
+{
+    if(!pixels) {
+        return;
+    }
+    memcpy(pixels, m_pixels, sizeof(float) * m_dim.x * m_dim.y);
+}
+
+//===================
+// core functionality
+//===================
+
+void ConwayEngine::step(int iters)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for(int i = 0; i < iters; i++) {
+        for(int y = 0; y < m_dim.y; y++) {
+            step_row(y);
+        }
+        if(m_cursor_pos.x >= 0 && m_cursor_pos.x < m_dim.x &&
+           m_cursor_pos.y >= 0 && m_cursor_pos.y < m_dim.y)
+        {
+            m_pixels2[m_cursor_pos.y * m_dim.x + m_cursor_pos.x] = CONWAY_GROW_COLOR; // seed
+        }
+        std::swap(m_pixels, m_pixels2); // the elusive ping-pong swap
+        m_generation++;
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    m_elapsed_time += delta_time.count();
+}
+
+void ConwayEngine::reset_stats()
+{
+    m_generation   = 0;
+    m_elapsed_time = 0;
+}
+
+// NOTE: texels outside the board read as get_pixel() in the shader does under the same sampler wrap state; the
+//       halo rows and columns are picked once per row, so the inner loop never tests for the border
+void ConwayEngine::step_row(int y)
+{
+    const float* row  = &m_pixels[y * m_dim.x];
+    const float* up   = get_halo_row(y + 1);
+    const float* down = get_halo_row(y - 1);
+    float*       out  = &m_pixels2[y * m_dim.x];
+    int last       = m_dim.x - 1;
+    int left_halo  = get_boundary_index(m_boundary_mode, -1,      m_dim.x);
+    int right_halo = get_boundary_index(m_boundary_mode, m_dim.x, m_dim.x);
+    int left_column  = (left_halo  < 0) ? 0 : live_column(up, row, down, left_halo);
+    int right_column = (right_halo < 0) ? 0 : live_column(up, row, down, right_halo);
+    int column       = live_column(up, row, down, 0);
+    for(int x = 0; x < last; x++) {
+        int next_column = live_column(up, row, down, x + 1);
+        out[x] = next_color(m_rule, row[x], left_column + column + next_column);
+        left_column = column;
+        column      = next_column;
+    }
+    out[last] = next_color(m_rule, row[last], left_column + column + right_column);
+}
+
+const float* ConwayEngine::get_halo_row(int y) const
+{
+    int board_y = get_boundary_index(m_boundary_mode, y, m_dim.y);
+    return (board_y < 0) ? m_zero_row : &m_pixels[board_y * m_dim.x];
+}
+
+}
@@ -0,0 +1,100 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <CycleDetector.h>
+#include <algorithm>
+#include <string.h>
+
+namespace vt {
+
+// NOTE: four independent lanes so the multiplies overlap instead of forming one long dependency chain
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    uint64_t lanes[4] = {seed, seed + 1, seed + 2, seed + 3};
+    size_t n = size / sizeof(uint64_t);
+    for(size_t i = 0; i < n; i++) {
+        uint64_t word;
+        memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+        lanes[i & 3] = hash_step(lanes[i & 3], word);
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, bytes + n * sizeof(uint64_t), size - n * sizeof(uint64_t));
+    return hash_mix(lanes[0] ^ hash_mix(lanes[1] ^ hash_mix(lanes[2] ^ hash_mix(lanes[3] ^ tail ^ size))));
+}
+
+CycleDetector::CycleDetector(int max_period)
+    : m_hashes(max_period + 1),
+      m_generations(max_period + 1),
+      m_count(0),
+      m_next(0),
+      m_period(0),
+      m_cycle_generation(-1)
+{
+}
+
+// NOTE: with temporal blocking or skipped frames hashes come less than one generation apart, so the period is
+//       the generation difference, not the ring distance
+bool CycleDetector::update(long generation, uint64_t hash)
+{
+    int size = m_hashes.size();
+    bool found = false;
+    long period = 0;
+    for(int i = 1; i <= m_count; i++) {
+        int index = (m_next - i + size) % size;
+        if(m_hashes[index] == hash) {
+            found  = true;
+            period = generation - m_generations[index];
+            break;
+        }
+    }
+    m_hashes[m_next]      = hash;
+    m_generations[m_next] = generation;
+    m_next  = (m_next + 1) % size;
+    m_count = std::min(m_count + 1, size - 1);
+    if(!found || period <= 0) {
+        m_period           = 0; // never cycled, or the cycle was broken
+        m_cycle_generation = -1;
+        return false;
+    }
+    if(m_period) {
+        return false; // still in the same cycle
+    }
+    m_period           = period;
+    m_cycle_generation = generation;
+    return true;
+}
+
+void CycleDetector::reset()
+{
+    m_count            = 0;
+    m_next             = 0;
+    m_period           = 0;
+    m_cycle_generation = -1;
+}
+
+long CycleDetector::get_remaining_generations(long generation, long target_generation) const
+{
+    if(!m_period || target_generation <= generation) {
+        return 0;
+    }
+    return (target_generation - generation) % m_period;
+}
+
+}
@@ -0,0 +1,757 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <FilePattern.h>
+#include <BitBoard.h>
+#include <ConwayEngine.h>
+#include <HashLife.h>
+#include <LifeRule.h>
+#include <TiledBoard.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define MACROCELL_LEAF_LEVEL 3 // 8x8 cells, one bit each
+
+namespace vt {
+
+// buffered byte stream over a FILE; the only state a streaming decode needs besides the current run
+class PatternReader
+{
+public:
+    explicit PatternReader(FILE* file)
+        : m_file(file),
+          m_buffer(PATTERN_READ_BUFFER_SIZE),
+          m_pos(0),
+          m_size(0),
+          m_bytes(0)
+    {}
+
+    size_t get_bytes() const { return m_bytes; }
+
+    int get()
+    {
+        if(!fill()) {
+            return EOF;
+        }
+        return static_cast<unsigned char>(m_buffer[m_pos++]);
+    }
+
+    // without the line break; false at the end of the file
+    bool get_line(std::string* line) // out
+    {
+        line->clear();
+        while(fill()) {
+            const char* begin = &m_buffer[m_pos];
+            const char* end   = static_cast<const char*>(memchr(begin, '\n', m_size - m_pos));
+            if(!end) {
+                line->append(begin, m_size - m_pos);
+                m_pos = m_size;
+                continue;
+            }
+            line->append(begin, end - begin);
+            m_pos += end - begin + 1;
+            if(!line->empty() && (*line)[line->size() - 1] == '\r') {
+                line->resize(line->size() - 1);
+            }
+            return true;
+        }
+        return !line->empty();
+    }
+
+private:
+    FILE*             m_file;
+    std::vector<char> m_buffer;
+    size_t            m_pos;
+    size_t            m_size;
+    size_t            m_bytes;
+
+    // false at the end of the file
+    bool fill()
+    {
+        if(m_pos == m_size) {
+            m_size = fread(&m_buffer[0], 1, m_buffer.size(), m_file);
+            m_pos  = 0;
+            m_bytes += m_size;
+        }
+        return m_pos < m_size;
+    }
+};
+
+// one node of a Macrocell file; children refer to earlier lines (1-based), 0 is the empty node
+struct macrocell_node_t
+{
+    int      level;
+    uint32_t child[4]; // nw, ne, sw, se
+    uint64_t bits;     // leaves only, bit (row * 8 + column), row 0 at the top
+    uint64_t population;
+    int64_t  min_x;    // bounding box of the live cells, relative to the top-left corner
+    int64_t  min_y;
+    int64_t  max_x;
+    int64_t  max_y;
+};
+
+static std::string trim(const std::string& str)
+{
+    size_t begin = str.find_first_not_of(" \t");
+    if(begin == std::string::npos) {
+        return "";
+    }
+    return str.substr(begin, str.find_last_not_of(" \t") - begin + 1);
+}
+
+// NOTE: bounded-grid suffixes (":T100,100") are dropped; the engines pick their own borders
+static void parse_rule(const std::string& str, pattern_info_t* info) // out
+{
+    std::string rule_string = trim(str.substr(0, str.find(':')));
+    info->has_rule = find_generations_rule(rule_string.c_str(), &info->rule, &info->states);
+}
+
+static void init_pattern_info(pattern_format_t format, pattern_info_t* info) // out
+{
+    info->format       = format;
+    info->width        = 0;
+    info->height       = 0;
+    info->has_rule     = false;
+    info->rule         = LIFE_RULE_CONWAY;
+    info->states       = 2;
+    info->population   = 0;
+    info->bytes        = 0;
+    info->elapsed_time = 0;
+}
+
+//==================
+// decoders
+//==================
+
+// "x = 3, y = 3, rule = B3/S23", after any '#' comment lines
+static bool read_rle_header(PatternReader* reader, pattern_info_t* info) // out
+{
+    std::string line;
+    while(reader->get_line(&line)) {
+        line = trim(line);
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t begin = 0;
+        while(begin < line.size()) {
+            size_t end = line.find(',', begin);
+            std::string field = line.substr(begin, (end == std::string::npos) ? std::string::npos : end - begin);
+            size_t equals = field.find('=');
+            if(equals != std::string::npos) {
+                std::string key   = trim(field.substr(0, equals));
+                std::string value = trim(field.substr(equals + 1));
+                if(key == "x") {
+                    info->width = atoll(value.c_str());
+                } else if(key == "y") {
+                    info->height = atoll(value.c_str());
+                } else if(key == "rule") {
+                    parse_rule(value, info);
+                }
+            }
+            if(end == std::string::npos) {
+                break;
+            }
+            begin = end + 1;
+        }
+        return true;
+    }
+    return false;
+}
+
+// run-length encoded rows ("bo$2bo$3o!") after the header
+// NOTE: any letter other than 'b' is alive (multi-state patterns load as their live cells)
+static bool read_rle(PatternReader* reader, PatternSink* sink, pattern_info_t* info) // out
+{
+    if(!read_rle_header(reader, info)) {
+        return false;
+    }
+    sink->begin(*info);
+    int64_t x     = 0;
+    int64_t y     = 0;
+    int64_t count = 0;
+    int c;
+    while((c = reader->get()) != EOF) {
+        if(c >= '0' && c <= '9') {
+            count = count * 10 + (c - '0');
+            continue;
+        }
+        int64_t n = count ? count : 1;
+        if(c == 'b' || c == '.') {
+            x += n;
+        } else if(c == '$') {
+            x = 0;
+            y += n;
+        } else if(c == '!') {
+            break;
+        } else if(isalpha(c)) {
+            sink->add_run(x, y, n);
+            info->population += n;
+            x += n;
+        } else {
+            continue; // whitespace between runs
+        }
+        count = 0;
+    }
+    return true;
+}
+
+// NOTE: the size is not stored in the file, so it takes a pass of its own (line lengths only)
+static bool read_plaintext(FILE* file, PatternSink* sink, pattern_info_t* info) // out
+{
+    std::string line;
+    {
+        PatternReader reader(file);
+        while(reader.get_line(&line)) {
+            if(!line.empty() && line[0] == '!') {
+                continue;
+            }
+            info->width = std::max(info->width, static_cast<int64_t>(line.size()));
+            info->height++;
+        }
+    }
+    rewind(file);
+    PatternReader reader(file);
+    sink->begin(*info);
+    int64_t y = 0;
+    while(reader.get_line(&line)) {
+        if(!line.empty() && line[0] == '!') {
+            continue;
+        }
+        int64_t x = 0;
+        while(x < static_cast<int64_t>(line.size())) {
+            if(line[x] != 'O' && line[x] != '*') {
+                x++;
+                continue;
+            }
+            int64_t begin = x;
+            while(x < static_cast<int64_t>(line.size()) && (line[x] == 'O' || line[x] == '*')) {
+                x++;
+            }
+            sink->add_run(begin, y, x - begin);
+            info->population += x - begin;
+        }
+        y++;
+    }
+    info->bytes = reader.get_bytes();
+    return true;
+}
+
+// node table of a Macrocell file, children before parents; nodes[0] is the empty node
+// NOTE: only 2-state files (8x8 leaves) are supported; multi-state files are built from level 1 nodes
+static bool read_macrocell_nodes(PatternReader* reader, std::vector<macrocell_node_t>* nodes, pattern_info_t* info) // out
+{
+    std::string line;
+    if(!reader->get_line(&line) || line.compare(0, 4, "[M2]")) {
+        return false;
+    }
+    macrocell_node_t empty = {0, {0, 0, 0, 0}, 0, 0, 1, 1, 0, 0};
+    nodes->clear();
+    nodes->push_back(empty);
+    while(reader->get_line(&line)) {
+        if(line.empty()) {
+            continue;
+        }
+        if(line[0] == '#') {
+            if(line.compare(0, 2, "#R") == 0) {
+                parse_rule(line.substr(2), info);
+            }
+            continue;
+        }
+        macrocell_node_t node = empty;
+        if(isdigit(line[0])) {
+            char* p = const_cast<char*>(line.c_str());
+            node.level = strtol(p, &p, 10);
+            for(int i = 0; i < 4; i++) {
+                node.child[i] = strtoul(p, &p, 10);
+            }
+            if(*p || node.level <= MACROCELL_LEAF_LEVEL || node.level > HASHLIFE_MAX_LEVEL) {
+                return false;
+            }
+            int64_t half = 1LL << (node.level - 1);
+            for(int i = 0; i < 4; i++) {
+                if(node.child[i] >= nodes->size() || (node.child[i] && (*nodes)[node.child[i]].level != node.level - 1)) {
+                    return false;
+                }
+                const macrocell_node_t& child = (*nodes)[node.child[i]];
+                if(!child.population) {
+                    continue;
+                }
+                int64_t x = (i & 1) ? half : 0;
+                int64_t y = (i & 2) ? half : 0;
+                node.min_x = node.population ? std::min(node.min_x, x + child.min_x) : x + child.min_x;
+                node.min_y = node.population ? std::min(node.min_y, y + child.min_y) : y + child.min_y;
+                node.max_x = node.population ? std::max(node.max_x, x + child.max_x) : x + child.max_x;
+                node.max_y = node.population ? std::max(node.max_y, y + child.max_y) : y + child.max_y;
+                node.population += child.population;
+            }
+        } else {
+            node.level = MACROCELL_LEAF_LEVEL;
+            int row    = 0;
+            int column = 0;
+            for(std::string::const_iterator p = line.begin(); p != line.end(); p++) {
+                if(*p == '$') {
+                    row++;
+                    column = 0;
+                } else if(*p == '*' && row < 8 && column < 8) {
+                    node.bits |= 1ULL << (row * 8 + column++);
+                } else if(*p == '.') {
+                    column++;
+                } else {
+                    return false;
+                }
+            }
+            if(node.bits) {
+                uint64_t columns = node.bits;
+                columns |= columns >> 32;
+                columns |= columns >> 16;
+                columns |= columns >> 8;
+                columns &= 0xFF;
+                node.min_x      = __builtin_ctzll(columns);
+                node.max_x      = 63 - __builtin_clzll(columns);
+                node.min_y      = __builtin_ctzll(node.bits) / 8;
+                node.max_y      = (63 - __builtin_clzll(node.bits)) / 8;
+                node.population = __builtin_popcountll(node.bits);
+            }
+        }
+        nodes->push_back(node);
+    }
+    if(nodes->size() < 2) {
+        return false;
+    }
+    const macrocell_node_t& root = nodes->back();
+    info->width      = root.population ? root.max_x - root.min_x + 1 : 0;
+    info->height     = root.population ? root.max_y - root.min_y + 1 : 0;
+    info->population = root.population;
+    return true;
+}
+
+// NOTE: a subtree shared n times is walked n times; only is_visible() keeps that bounded
+static void walk_macrocell(const std::vector<macrocell_node_t>& nodes, uint32_t index, int64_t x, int64_t y, PatternSink* sink)
+{
+    const macrocell_node_t& node = nodes[index];
+    if(!node.population || !sink->is_visible(x, y, 1LL << node.level)) {
+        return;
+    }
+    if(node.level == MACROCELL_LEAF_LEVEL) {
+        for(int row = 0; row < 8; row++) {
+            int bits   = (node.bits >> (row * 8)) & 0xFF;
+            int column = 0;
+            while(bits >> column) {
+                if(!((bits >> column) & 1)) {
+                    column++;
+                    continue;
+                }
+                int begin = column;
+                while((bits >> column) & 1) {
+                    column++;
+                }
+                sink->add_run(x + begin, y + row, column - begin);
+            }
+        }
+        return;
+    }
+    int64_t half = 1LL << (node.level - 1);
+    walk_macrocell(nodes, node.child[0], x,        y,        sink);
+    walk_macrocell(nodes, node.child[1], x + half, y,        sink);
+    walk_macrocell(nodes, node.child[2], x,        y + half, sink);
+    walk_macrocell(nodes, node.child[3], x + half, y + half, sink);
+}
+
+static bool read_macrocell(PatternReader* reader, PatternSink* sink, pattern_info_t* info) // out
+{
+    std::vector<macrocell_node_t> nodes;
+    if(!read_macrocell_nodes(reader, &nodes, info)) {
+        return false;
+    }
+    sink->begin(*info);
+    const macrocell_node_t& root = nodes.back();
+    walk_macrocell(nodes, nodes.size() - 1, -root.min_x, -root.min_y, sink);
+    return true;
+}
+
+//==================
+// sinks
+//==================
+
+// pattern centered on a board of dim cells, y flipped to Texture rows; runs are clipped to the board
+class BoardPatternSink : public PatternSink
+{
+public:
+    explicit BoardPatternSink(glm::ivec2 dim)
+        : m_dim(dim),
+          m_offset_x(0),
+          m_offset_y(0)
+    {}
+
+    void begin(const pattern_info_t& info)
+    {
+        m_offset_x = (m_dim.x - info.width) / 2;
+        m_offset_y = (m_dim.y - info.height) / 2;
+    }
+
+    bool is_visible(int64_t x, int64_t y, int64_t size) const
+    {
+        x += m_offset_x;
+        y += m_offset_y;
+        return x < m_dim.x && y < m_dim.y && x + size > 0 && y + size > 0;
+    }
+
+    void add_run(int64_t x, int64_t y, int64_t length)
+    {
+        int64_t begin = std::max(x + m_offset_x, static_cast<int64_t>(0));
+        int64_t end   = std::min(x + m_offset_x + length, static_cast<int64_t>(m_dim.x));
+        y += m_offset_y;
+        if(begin >= end || y < 0 || y >= m_dim.y) {
+            return;
+        }
+        add_row_run(m_dim.y - 1 - static_cast<int>(y), static_cast<int>(begin), static_cast<int>(end));
+    }
+
+protected:
+    glm::ivec2 m_dim;
+    int64_t    m_offset_x; // of the pattern's top-left corner, in rows from the top
+    int64_t    m_offset_y;
+
+    // cells [begin, end) of Texture row y
+    virtual void add_row_run(int y, int begin, int end) = 0;
+};
+
+// NOTE: whole words at a time; clear() has already marked every tile changed
+class BitBoardPatternSink : public BoardPatternSink
+{
+public:
+    explicit BitBoardPatternSink(BitBoard* board)
+        : BoardPatternSink(board->get_dim()),
+          m_board(board)
+    {}
+
+protected:
+    BitBoard* m_board;
+
+    void add_row_run(int y, int begin, int end)
+    {
+        uint64_t* row = m_board->get_row(y);
+        while(begin < end) {
+            int bit   = begin % BITBOARD_WORD_BITS;
+            int count = std::min(end - begin, BITBOARD_WORD_BITS - bit);
+            uint64_t mask = (count == BITBOARD_WORD_BITS) ? ~0ULL : (((1ULL << count) - 1) << bit);
+            row[begin / BITBOARD_WORD_BITS] |= mask;
+            begin += count;
+        }
+    }
+};
+
+class TiledBoardPatternSink : public BoardPatternSink
+{
+public:
+    explicit TiledBoardPatternSink(TiledBoard* board)
+        : BoardPatternSink(board->get_dim()),
+          m_board(board)
+    {}
+
+protected:
+    TiledBoard* m_board;
+
+    void add_row_run(int y, int begin, int end)
+    {
+        for(int x = begin; x < end; x++) {
+            m_board->set_cell(glm::ivec2(x, y), true);
+        }
+    }
+};
+
+class PixelPatternSink : public BoardPatternSink
+{
+public:
+    PixelPatternSink(float* pixels, glm::ivec2 dim)
+        : BoardPatternSink(dim),
+          m_pixels(pixels)
+    {}
+
+protected:
+    float* m_pixels;
+
+    void add_row_run(int y, int begin, int end)
+    {
+        std::fill(m_pixels + static_cast<size_t>(y) * m_dim.x + begin,
+                  m_pixels + static_cast<size_t>(y) * m_dim.x + end,
+                  CONWAY_LIVE_COLOR);
+    }
+};
+
+class BytePatternSink : public BoardPatternSink
+{
+public:
+    BytePatternSink(uint8_t* pixels, glm::ivec2 dim, uint8_t alive)
+        : BoardPatternSink(dim),
+          m_pixels(pixels),
+          m_alive(alive)
+    {}
+
+protected:
+    uint8_t* m_pixels;
+    uint8_t  m_alive;
+
+    void add_row_run(int y, int begin, int end)
+    {
+        memset(m_pixels + static_cast<size_t>(y) * m_dim.x + begin, m_alive, end - begin);
+    }
+};
+
+class HashLifePatternSink : public PatternSink
+{
+public:
+    explicit HashLifePatternSink(HashLife* engine)
+        : m_engine(engine),
+          m_offset_x(0),
+          m_height(0)
+    {}
+
+    void begin(const pattern_info_t& info)
+    {
+        m_offset_x = -info.width / 2;
+        m_height   = info.height;
+    }
+
+    void add_run(int64_t x, int64_t y, int64_t length)
+    {
+        for(int64_t i = 0; i < length; i++) {
+            m_engine->set_cell(x + i + m_offset_x, m_height - 1 - y - m_height / 2, true);
+        }
+    }
+
+private:
+    HashLife* m_engine;
+    int64_t   m_offset_x;
+    int64_t   m_height;
+};
+
+// 8x8 leaf rows go down and HashLife's north is +y, so row 0 of a leaf is the top of its north half
+static HashLifeNode* build_macrocell_leaf(HashLife* engine, uint64_t bits, int row, int column, int level)
+{
+    if(!level) {
+        return engine->get_leaf((bits >> (row * 8 + column)) & 1);
+    }
+    int half = 1 << (level - 1);
+    return engine->create(build_macrocell_leaf(engine, bits, row,        column,        level - 1),
+                          build_macrocell_leaf(engine, bits, row,        column + half, level - 1),
+                          build_macrocell_leaf(engine, bits, row + half, column,        level - 1),
+                          build_macrocell_leaf(engine, bits, row + half, column + half, level - 1));
+}
+
+//==================
+// public interface
+//==================
+
+pattern_format_t find_pattern_format(const std::string& filename)
+{
+    size_t dot = filename.rfind('.');
+    std::string extension = (dot == std::string::npos) ? "" : filename.substr(dot + 1);
+    if(!strcasecmp(extension.c_str(), "rle")) {
+        return PATTERN_FORMAT_RLE;
+    }
+    if(!strcasecmp(extension.c_str(), "cells") || !strcasecmp(extension.c_str(), "txt")) {
+        return PATTERN_FORMAT_PLAINTEXT;
+    }
+    if(!strcasecmp(extension.c_str(), "mc")) {
+        return PATTERN_FORMAT_MACROCELL;
+    }
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file) {
+        return PATTERN_FORMAT_UNKNOWN;
+    }
+    PatternReader reader(file);
+    std::string line;
+    pattern_format_t format = PATTERN_FORMAT_UNKNOWN;
+    while(format == PATTERN_FORMAT_UNKNOWN && reader.get_line(&line)) {
+        line = trim(line);
+        if(line.empty()) {
+            continue;
+        }
+        if(line.compare(0, 4, "[M2]") == 0) {
+            format = PATTERN_FORMAT_MACROCELL;
+        } else if(line[0] == '#' || line[0] == 'x') {
+            format = PATTERN_FORMAT_RLE;
+        } else if(line[0] == '!' || line[0] == '.' || line[0] == 'O') {
+            format = PATTERN_FORMAT_PLAINTEXT;
+        } else {
+            break;
+        }
+    }
+    fclose(file);
+    return format;
+}
+
+const char* get_pattern_format_name(pattern_format_t format)
+{
+    switch(format) {
+        case PATTERN_FORMAT_RLE:       return "rle";
+        case PATTERN_FORMAT_PLAINTEXT: return "plaintext";
+        case PATTERN_FORMAT_MACROCELL: return "macrocell";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+// NOTE: a Macrocell rule comes before the first node; its size is only known once the whole table is read
+bool read_pattern_header(const std::string& filename, pattern_info_t* info)
+{
+    init_pattern_info(find_pattern_format(filename), info);
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file) {
+        return false;
+    }
+    PatternReader reader(file);
+    std::string line;
+    bool result = false;
+    switch(info->format) {
+        case PATTERN_FORMAT_RLE:
+            result = read_rle_header(&reader, info);
+            break;
+        case PATTERN_FORMAT_PLAINTEXT:
+            result = true;
+            break;
+        case PATTERN_FORMAT_MACROCELL:
+            result = reader.get_line(&line) && !line.compare(0, 4, "[M2]");
+            while(result && reader.get_line(&line) && (line.empty() || line[0] == '#')) {
+                if(line.compare(0, 2, "#R") == 0) {
+                    parse_rule(line.substr(2), info);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    info->bytes = reader.get_bytes();
+    fclose(file);
+    return result;
+}
+
+bool read_pattern(const std::string& filename, PatternSink* sink, pattern_info_t* info)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    pattern_info_t local_info;
+    if(!info) {
+        info = &local_info;
+    }
+    init_pattern_info(find_pattern_format(filename), info);
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file) {
+        return false;
+    }
+    bool result = false;
+    if(info->format == PATTERN_FORMAT_PLAINTEXT) {
+        result = read_plaintext(file, sink, info);
+    } else {
+        PatternReader reader(file);
+        if(info->format == PATTERN_FORMAT_RLE) {
+            result = read_rle(&reader, sink, info);
+        } else if(info->format == PATTERN_FORMAT_MACROCELL) {
+            result = read_macrocell(&reader, sink, info);
+        }
+        info->bytes = reader.get_bytes();
+    }
+    fclose(file);
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    info->elapsed_time = delta_time.count();
+    return result;
+}
+
+bool load_pattern(const std::string& filename, BitBoard* board, pattern_info_t* info)
+{
+    board->clear();
+    BitBoardPatternSink sink(board);
+    return read_pattern(filename, &sink, info);
+}
+
+bool load_pattern(const std::string& filename, TiledBoard* board, pattern_info_t* info)
+{
+    board->clear();
+    TiledBoardPatternSink sink(board);
+    return read_pattern(filename, &sink, info);
+}
+
+bool load_pattern_r32f(const std::string& filename, float* pixels, glm::ivec2 dim, pattern_info_t* info)
+{
+    std::fill(pixels, pixels + static_cast<size_t>(dim.x) * dim.y, CONWAY_DIE_COLOR);
+    PixelPatternSink sink(pixels, dim);
+    return read_pattern(filename, &sink, info);
+}
+
+bool load_pattern_r8(const std::string& filename, uint8_t* pixels, glm::ivec2 dim, uint8_t alive, pattern_info_t* info)
+{
+    memset(pixels, 0, static_cast<size_t>(dim.x) * dim.y);
+    BytePatternSink sink(pixels, dim, alive);
+    return read_pattern(filename, &sink, info);
+}
+
+bool load_pattern(const std::string& filename, HashLife* engine, pattern_info_t* info)
+{
+    engine->clear();
+    if(find_pattern_format(filename) != PATTERN_FORMAT_MACROCELL) {
+        HashLifePatternSink sink(engine);
+        return read_pattern(filename, &sink, info);
+    }
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    pattern_info_t local_info;
+    if(!info) {
+        info = &local_info;
+    }
+    init_pattern_info(PATTERN_FORMAT_MACROCELL, info);
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file) {
+        return false;
+    }
+    PatternReader reader(file);
+    std::vector<macrocell_node_t> nodes;
+    bool result = read_macrocell_nodes(&reader, &nodes, info);
+    info->bytes = reader.get_bytes();
+    fclose(file);
+    if(result) {
+        // one canonical node per line, children first
+        std::vector<HashLifeNode*> hash_nodes(nodes.size(), NULL);
+        for(size_t i = 1; i < nodes.size(); i++) {
+            const macrocell_node_t& node = nodes[i];
+            if(node.level == MACROCELL_LEAF_LEVEL) {
+                hash_nodes[i] = build_macrocell_leaf(engine, node.bits, 0, 0, MACROCELL_LEAF_LEVEL);
+                continue;
+            }
+            HashLifeNode* children[4];
+            for(int j = 0; j < 4; j++) {
+                children[j] = node.child[j] ? hash_nodes[node.child[j]] : engine->get_empty(node.level - 1);
+            }
+            hash_nodes[i] = engine->create(children[0], children[1], children[2], children[3]);
+        }
+        engine->set_root(hash_nodes.back());
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    info->elapsed_time = delta_time.count();
+    return result;
+}
+
+}
@@ -0,0 +1,157 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <FrameGovernor.h>
+#include <GL/glew.h>
+#include <algorithm>
+
+namespace vt {
+
+FrameGovernor::FrameGovernor(double target_fps, int max_iterations)
+    : m_target_frame_time(1.0 / target_fps),
+      m_max_iterations(max_iterations),
+      m_gpu_timer(GLEW_VERSION_3_3 || GLEW_ARB_timer_query),
+      m_next_query(0),
+      m_query_open(false)
+{
+    if(m_gpu_timer) {
+        glGenQueries(FRAME_GOVERNOR_QUERIES, m_query_ids);
+    }
+    reset();
+}
+
+FrameGovernor::~FrameGovernor()
+{
+    if(m_gpu_timer) {
+        glDeleteQueries(FRAME_GOVERNOR_QUERIES, m_query_ids);
+    }
+}
+
+void FrameGovernor::reset()
+{
+    std::fill(m_query_iterations, m_query_iterations + FRAME_GOVERNOR_QUERIES, 0);
+    m_iterations             = 1;
+    m_decision               = HOLD;
+    m_gpu_time_per_iteration = 0;
+    m_cpu_time_per_iteration = 0;
+    m_frame_time             = m_target_frame_time;
+    m_budget                 = m_target_frame_time * FRAME_GOVERNOR_MAX_BUDGET / 2;
+    m_budget_ceiling         = m_target_frame_time * FRAME_GOVERNOR_MAX_BUDGET;
+    m_overruns               = 0;
+    m_frames                 = 0;
+}
+
+const char* FrameGovernor::get_decision_name(decision_t decision)
+{
+    switch(decision) {
+        case HOLD:    return "hold";
+        case GROW:    return "grow";
+        case SHRINK:  return "shrink";
+        case OVERRUN: return "overrun";
+    }
+    return "";
+}
+
+// NOTE: a pending result is polled, never waited for
+void FrameGovernor::read_queries()
+{
+    for(int i = 0; i < FRAME_GOVERNOR_QUERIES; i++) {
+        if(!m_query_iterations[i]) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(m_query_ids[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available) {
+            continue;
+        }
+        GLuint64 elapsed_ns = 0;
+        glGetQueryObjectui64v(m_query_ids[i], GL_QUERY_RESULT, &elapsed_ns);
+        double time_per_iteration = elapsed_ns * 1e-9 / m_query_iterations[i];
+        m_gpu_time_per_iteration = m_gpu_time_per_iteration ? m_gpu_time_per_iteration + FRAME_GOVERNOR_SMOOTHING *
+                                                                  (time_per_iteration - m_gpu_time_per_iteration)
+                                                            : time_per_iteration;
+        m_query_iterations[i] = 0;
+    }
+}
+
+int FrameGovernor::begin_frame()
+{
+    clock_t::time_point now = clock_t::now();
+    double frame_time = std::chrono::duration<double>(now - m_frame_begin).count();
+    m_frame_begin = now;
+    if(m_gpu_timer) {
+        read_queries();
+    }
+
+    // budget from the frame time, iterations from the budget
+    if(m_frames++ && frame_time < FRAME_GOVERNOR_MAX_GAP) {
+        m_frame_time += FRAME_GOVERNOR_SMOOTHING * (frame_time - m_frame_time);
+        bool overrun = frame_time > m_target_frame_time * FRAME_GOVERNOR_OVERRUN;
+        if(overrun) {
+            m_budget_ceiling = m_budget;
+            m_budget *= 0.75;
+            m_overruns++;
+        } else {
+            // back quickly to just under the budget that last missed a frame, then probe past it slowly
+            double step = (m_budget < m_budget_ceiling * 0.9) ? 0.01 : 0.001;
+            m_budget = std::min(m_budget + m_target_frame_time * step, m_target_frame_time * FRAME_GOVERNOR_MAX_BUDGET);
+            m_budget_ceiling = std::max(m_budget_ceiling, m_budget);
+        }
+        double cost = std::max(m_gpu_time_per_iteration, m_cpu_time_per_iteration);
+        int iterations = m_iterations;
+        if(cost > 0) {
+            iterations = std::max(m_iterations / 2, std::min(m_iterations * 2, static_cast<int>(m_budget / cost)));
+        }
+        if(overrun) {
+            iterations = std::min(iterations, m_iterations / 2);
+        }
+        iterations = std::max(1, std::min(m_max_iterations, iterations));
+        m_decision = overrun                       ? OVERRUN :
+                     (iterations > m_iterations) ? GROW :
+                     (iterations < m_iterations) ? SHRINK
+                                                 : HOLD;
+        m_iterations = iterations;
+    }
+
+    // a query slot whose last result is still pending leaves this frame untimed on the gpu
+    if(m_gpu_timer && !m_query_open && !m_query_iterations[m_next_query]) {
+        glBeginQuery(GL_TIME_ELAPSED, m_query_ids[m_next_query]);
+        m_query_open = true;
+    }
+    m_batch_begin = clock_t::now();
+    return m_iterations;
+}
+
+void FrameGovernor::end_frame(int iterations)
+{
+    double batch_time = std::chrono::duration<double>(clock_t::now() - m_batch_begin).count();
+    if(m_query_open) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_query_open = false;
+        m_query_iterations[m_next_query] = std::max(1, iterations);
+        m_next_query = (m_next_query + 1) % FRAME_GOVERNOR_QUERIES;
+    }
+    if(iterations > 0) {
+        double time_per_iteration = batch_time / iterations;
+        m_cpu_time_per_iteration = m_cpu_time_per_iteration ? m_cpu_time_per_iteration + FRAME_GOVERNOR_SMOOTHING *
+                                                                  (time_per_iteration - m_cpu_time_per_iteration)
+                                                            : time_per_iteration;
+    }
+}
+
+}
@@ -0,0 +1,224 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <GenerationsEngine.h>
+#include <Boundary.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+#include <memory.h>
+
+namespace vt {
+
+static inline int alive_column(const uint8_t* up, const uint8_t* row, const uint8_t* down, int x)
+{
+    return (up[x] == GENERATIONS_ALIVE) + (row[x] == GENERATIONS_ALIVE) + (down[x] == GENERATIONS_ALIVE);
+}
+
+GenerationsEngine::GenerationsEngine(glm::ivec2 dim)
+    : m_dim(dim),
+      m_cells(NULL),
+      m_cells2(NULL),
+      m_zero_row(NULL),
+      m_rule(LIFE_RULE_CONWAY),
+      m_states(2),
+      m_cursor_pos(-1),
+      m_boundary_mode(BOUNDARY_DEAD),
+      m_generation(0),
+      m_elapsed_time(0)
+{
+    size_t n = m_dim.x * m_dim.y;
+    m_cells    = new uint8_t[n];
+    m_cells2   = new uint8_t[n];
+    m_zero_row = new uint8_t[m_dim.x];
+    memset(m_cells,    0, n);
+    memset(m_cells2,   0, n);
+    memset(m_zero_row, 0, m_dim.x);
+    set_rule(m_rule, m_states);
+}
+
+GenerationsEngine::~GenerationsEngine()
+{
+    if(m_cells) {
+        delete[] m_cells;
+    }
+    if(m_cells2) {
+        delete[] m_cells2;
+    }
+    if(m_zero_row) {
+        delete[] m_zero_row;
+    }
+}
+
+double GenerationsEngine::get_generations_per_sec() const
+{
+    if(m_elapsed_time <= 0) {
+        return 0;
+    }
+    return m_generation / m_elapsed_time;
+}
+
+size_t GenerationsEngine::get_population() const
+{
+    size_t n = m_dim.x * m_dim.y;
+    size_t population = 0;
+    for(int i = 0; i < static_cast<int>(n); i++) {
+        population += (m_cells[i] == GENERATIONS_ALIVE);
+    }
+    return population;
+}
+
+// NOTE: the whole transition table is precomputed, so a step costs the same for every rule and state count
+void GenerationsEngine::set_rule(life_rule_t rule, int states)
+{
+    m_rule   = rule;
+    m_states = std::max(2, std::min(states, GENERATIONS_MAX_STATES));
+    m_next.assign(GENERATIONS_MAX_STATES * LIFE_RULE_COUNTS, GENERATIONS_DEAD);
+    for(int count = 0; count < LIFE_RULE_COUNTS; count++) {
+        m_next[GENERATIONS_DEAD * LIFE_RULE_COUNTS + count] =
+                life_rule_lookup(m_rule, false, count) ? GENERATIONS_ALIVE : GENERATIONS_DEAD;
+        m_next[GENERATIONS_ALIVE * LIFE_RULE_COUNTS + count] =
+                life_rule_lookup(m_rule, true, count) ? GENERATIONS_ALIVE : ((m_states > 2) ? 2 : GENERATIONS_DEAD);
+        for(int state = 2; state < m_states; state++) {
+            m_next[state * LIFE_RULE_COUNTS + count] = (state + 1 < m_states) ? state + 1 : GENERATIONS_DEAD;
+        }
+    }
+}
+
+//================
+// basic modifiers
+//================
+
+void GenerationsEngine::clear()
+{
+    memset(m_cells, GENERATIONS_DEAD, m_dim.x * m_dim.y);
+}
+
+// NOTE: same pattern as Texture::draw_x
+void GenerationsEngine::draw_x()
+{
+    size_t min_dim = std::min(m_dim.x, m_dim.y);
+    for(int i = 0; i < static_cast<int>(min_dim); i++) {
+        m_cells[i * m_dim.x + i]                 = GENERATIONS_ALIVE;
+        m_cells[i * m_dim.x + (m_dim.x - 1 - i)] = GENERATIONS_ALIVE;
+    }
+}
+
+// NOTE: same distribution as Texture::randomize
+void GenerationsEngine::randomize()
+{
+    size_t n = m_dim.x * m_dim.y;
+    for(int i = 0; i < static_cast<int>(n); i++) {
+        m_cells[i] = ((static_cast<float>(rand()) / RAND_MAX) > 0.5) ? GENERATIONS_ALIVE : GENERATIONS_DEAD;
+    }
+}
+
+//==================
+// texture interop
+//==================
+
+void GenerationsEngine::load_r8(const uint8_t* pixels)
+{
+    if(!pixels) {
+        return;
+    }
+    memcpy(m_cells, pixels, m_dim.x * m_dim.y);
+}
+
+void GenerationsEngine::store_r8(uint8_t* pixels) const
+{
+    if(!pixels) {
+        return;
+    }
+    memcpy(pixels, m_cells, m_dim.x * m_dim.y);
+}
+
+void GenerationsEngine::load_r32f(const float* pixels)
+{
+    if(!pixels) {
+        return;
+    }
+    size_t n = m_dim.x * m_dim.y;
+    for(int i = 0; i < static_cast<int>(n); i++) {
+        m_cells[i] = (pixels[i] > 0) ? GENERATIONS_ALIVE : GENERATIONS_DEAD;
+    }
+}
+
+//===================
+// core functionality
+//===================
+
+void GenerationsEngine::step(int iters)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for(int i = 0; i < iters; i++) {
+        for(int y = 0; y < m_dim.y; y++) {
+            step_row(y);
+        }
+        if(m_cursor_pos.x >= 0 && m_cursor_pos.x < m_dim.x &&
+           m_cursor_pos.y >= 0 && m_cursor_pos.y < m_dim.y)
+        {
+            m_cells2[m_cursor_pos.y * m_dim.x + m_cursor_pos.x] = GENERATIONS_ALIVE; // seed
+        }
+        std::swap(m_cells, m_cells2); // the elusive ping-pong swap
+        m_generation++;
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    m_elapsed_time += delta_time.count();
+}
+
+void GenerationsEngine::reset_stats()
+{
+    m_generation   = 0;
+    m_elapsed_time = 0;
+}
+
+// NOTE: cells outside the board read as get_state() in the shader does under the same sampler wrap state; the halo
+//       rows and columns are picked once per row, so the inner loop never tests for the border
+void GenerationsEngine::step_row(int y)
+{
+    const uint8_t* row  = &m_cells[y * m_dim.x];
+    const uint8_t* up   = get_halo_row(y + 1);
+    const uint8_t* down = get_halo_row(y - 1);
+    uint8_t*       out  = &m_cells2[y * m_dim.x];
+    const uint8_t* next = &m_next[0];
+    int last       = m_dim.x - 1;
+    int left_halo  = get_boundary_index(m_boundary_mode, -1,      m_dim.x);
+    int right_halo = get_boundary_index(m_boundary_mode, m_dim.x, m_dim.x);
+    int left_column  = (left_halo  < 0) ? 0 : alive_column(up, row, down, left_halo);
+    int right_column = (right_halo < 0) ? 0 : alive_column(up, row, down, right_halo);
+    int column       = alive_column(up, row, down, 0);
+    for(int x = 0; x < last; x++) {
+        int next_column = alive_column(up, row, down, x + 1);
+        int count = left_column + column + next_column - (row[x] == GENERATIONS_ALIVE);
+        out[x] = next[row[x] * LIFE_RULE_COUNTS + count];
+        left_column = column;
+        column      = next_column;
+    }
+    int count = left_column + column + right_column - (row[last] == GENERATIONS_ALIVE);
+    out[last] = next[row[last] * LIFE_RULE_COUNTS + count];
+}
+
+const uint8_t* GenerationsEngine::get_halo_row(int y) const
+{
+    int board_y = get_boundary_index(m_boundary_mode, y, m_dim.y);
+    return (board_y < 0) ? m_zero_row : &m_cells[board_y * m_dim.x];
+}
+
+}
@@ -0,0 +1,511 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <HashLife.h>
+#include <ConwayEngine.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdint.h>
+
+#define HASHLIFE_MIN_LEVEL       3
+#define HASHLIFE_INITIAL_BUCKETS (1 << 16)
+
+namespace vt {
+
+static inline size_t hash_children(const HashLifeNode* nw,
+                                   const HashLifeNode* ne,
+                                   const HashLifeNode* sw,
+                                   const HashLifeNode* se)
+{
+    uint64_t h = reinterpret_cast<uintptr_t>(nw);
+    h = h * 0x9E3779B97F4A7C15ULL + reinterpret_cast<uintptr_t>(ne);
+    h = h * 0x9E3779B97F4A7C15ULL + reinterpret_cast<uintptr_t>(sw);
+    h = h * 0x9E3779B97F4A7C15ULL + reinterpret_cast<uintptr_t>(se);
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+static HashLifeNode* new_leaf(bool alive)
+{
+    HashLifeNode* node = new HashLifeNode();
+    node->m_nw         = NULL;
+    node->m_ne         = NULL;
+    node->m_sw         = NULL;
+    node->m_se         = NULL;
+    node->m_result     = NULL;
+    node->m_next       = NULL;
+    node->m_population = alive ? 1 : 0;
+    node->m_level      = 0;
+    node->m_marked     = false;
+    return node;
+}
+
+HashLife::HashLife(size_t max_nodes)
+    : m_node_count(0),
+      m_max_nodes(max_nodes),
+      m_root(NULL),
+      m_step_log2(0),
+      m_rule(LIFE_RULE_CONWAY),
+      m_generation(0),
+      m_gc_count(0),
+      m_result_hits(0),
+      m_result_misses(0),
+      m_elapsed_time(0)
+{
+    m_leaves[0] = new_leaf(false);
+    m_leaves[1] = new_leaf(true);
+    m_buckets.resize(HASHLIFE_INITIAL_BUCKETS, NULL);
+    m_root = get_empty(HASHLIFE_MIN_LEVEL);
+}
+
+HashLife::~HashLife()
+{
+    for(std::vector<HashLifeNode*>::iterator p = m_buckets.begin(); p != m_buckets.end(); p++) {
+        HashLifeNode* node = *p;
+        while(node) {
+            HashLifeNode* next = node->m_next;
+            delete node;
+            node = next;
+        }
+    }
+    delete m_leaves[0];
+    delete m_leaves[1];
+}
+
+double HashLife::get_generations_per_sec() const
+{
+    if(m_elapsed_time <= 0) {
+        return 0;
+    }
+    return static_cast<double>(m_generation) / m_elapsed_time;
+}
+
+// NOTE: memoized results depend on the step size, so changing it drops them
+void HashLife::set_step_log2(int step_log2)
+{
+    step_log2 = std::max(0, std::min(step_log2, HASHLIFE_MAX_LEVEL - 2));
+    if(step_log2 == m_step_log2) {
+        return;
+    }
+    m_step_log2 = step_log2;
+    clear_results();
+}
+
+bool HashLife::set_rule(life_rule_t rule)
+{
+    if(get_life_rule_birth(rule) & 1) {
+        return false;
+    }
+    if(rule == m_rule) {
+        return true;
+    }
+    m_rule = rule;
+    clear_results();
+    return true;
+}
+
+//================
+// basic modifiers
+//================
+
+void HashLife::clear()
+{
+    for(std::vector<HashLifeNode*>::iterator p = m_buckets.begin(); p != m_buckets.end(); p++) {
+        HashLifeNode* node = *p;
+        while(node) {
+            HashLifeNode* next = node->m_next;
+            delete node;
+            node = next;
+        }
+        *p = NULL;
+    }
+    m_node_count = 0;
+    m_empty.clear();
+    m_root       = get_empty(HASHLIFE_MIN_LEVEL);
+    m_generation = 0;
+}
+
+bool HashLife::get_cell(int64_t x, int64_t y) const
+{
+    const HashLifeNode* node = m_root;
+    int64_t half = 1LL << (node->m_level - 1);
+    x += half;
+    y += half;
+    if(x < 0 || y < 0 || x >= half * 2 || y >= half * 2) {
+        return false;
+    }
+    while(node->m_level > 0) {
+        if(!node->m_population) {
+            return false;
+        }
+        half = 1LL << (node->m_level - 1);
+        if(y >= half) {
+            node = (x >= half) ? node->m_ne : node->m_nw;
+        } else {
+            node = (x >= half) ? node->m_se : node->m_sw;
+        }
+        x %= half;
+        y %= half;
+    }
+    return node->m_population != 0;
+}
+
+void HashLife::set_cell(int64_t x, int64_t y, bool alive)
+{
+    int64_t half = 1LL << (m_root->m_level - 1);
+    while(x < -half || y < -half || x >= half || y >= half) {
+        if(m_root->m_level >= HASHLIFE_MAX_LEVEL) {
+            return;
+        }
+        m_root = expand(m_root);
+        half = 1LL << (m_root->m_level - 1);
+    }
+    m_root = set_cell(m_root, x + half, y + half, alive);
+}
+
+HashLifeNode* HashLife::set_cell(HashLifeNode* node, int64_t x, int64_t y, bool alive)
+{
+    if(!node->m_level) {
+        return get_leaf(alive);
+    }
+    int64_t half = 1LL << (node->m_level - 1);
+    if(y >= half) {
+        if(x >= half) {
+            return create(node->m_nw, set_cell(node->m_ne, x - half, y - half, alive), node->m_sw, node->m_se);
+        }
+        return create(set_cell(node->m_nw, x, y - half, alive), node->m_ne, node->m_sw, node->m_se);
+    }
+    if(x >= half) {
+        return create(node->m_nw, node->m_ne, node->m_sw, set_cell(node->m_se, x - half, y, alive));
+    }
+    return create(node->m_nw, node->m_ne, set_cell(node->m_sw, x, y, alive), node->m_se);
+}
+
+//==================
+// texture interop
+//==================
+
+// NOTE: the board occupies the north-east quadrant of the root, so cell (x, y) is texel (x, y)
+void HashLife::load_r32f(const float* pixels, glm::ivec2 dim)
+{
+    if(!pixels) {
+        return;
+    }
+    clear();
+    int level = HASHLIFE_MIN_LEVEL;
+    while((1LL << (level - 1)) < std::max(dim.x, dim.y)) {
+        level++;
+    }
+    HashLifeNode* empty = get_empty(level - 1);
+    m_root = create(empty, build_r32f(pixels, dim, 0, 0, level - 1), empty, empty);
+}
+
+HashLifeNode* HashLife::build_r32f(const float* pixels, glm::ivec2 dim, int64_t x, int64_t y, int level)
+{
+    if(x >= dim.x || y >= dim.y) {
+        return get_empty(level);
+    }
+    if(!level) {
+        return get_leaf(pixels[y * dim.x + x] > 0);
+    }
+    int64_t half = 1LL << (level - 1);
+    return create(build_r32f(pixels, dim, x,        y + half, level - 1),
+                  build_r32f(pixels, dim, x + half, y + half, level - 1),
+                  build_r32f(pixels, dim, x,        y,        level - 1),
+                  build_r32f(pixels, dim, x + half, y,        level - 1));
+}
+
+// NOTE: HashLife does not track births, so live cells come back as LIVE_COLOR
+void HashLife::store_r32f(float* pixels, glm::ivec2 dim) const
+{
+    if(!pixels) {
+        return;
+    }
+    std::fill(pixels, pixels + static_cast<size_t>(dim.x) * dim.y, CONWAY_DIE_COLOR);
+    int64_t half = 1LL << (m_root->m_level - 1);
+    store_r32f(m_root, pixels, dim, -half, -half);
+}
+
+void HashLife::store_r32f(const HashLifeNode* node, float* pixels, glm::ivec2 dim, int64_t x, int64_t y) const
+{
+    int64_t size = 1LL << node->m_level;
+    if(!node->m_population || x >= dim.x || y >= dim.y || x + size <= 0 || y + size <= 0) {
+        return;
+    }
+    if(!node->m_level) {
+        pixels[y * dim.x + x] = CONWAY_LIVE_COLOR;
+        return;
+    }
+    int64_t half = size / 2;
+    store_r32f(node->m_nw, pixels, dim, x,        y + half);
+    store_r32f(node->m_ne, pixels, dim, x + half, y + half);
+    store_r32f(node->m_sw, pixels, dim, x,        y);
+    store_r32f(node->m_se, pixels, dim, x + half, y);
+}
+
+//==========================
+// quadtree construction
+//==========================
+
+HashLifeNode* HashLife::get_empty(int level)
+{
+    if(m_empty.empty()) {
+        m_empty.push_back(get_leaf(false));
+    }
+    while(static_cast<int>(m_empty.size()) <= level) {
+        HashLifeNode* e = m_empty.back();
+        m_empty.push_back(create(e, e, e, e));
+    }
+    return m_empty[level];
+}
+
+// NOTE: hash-consing -- identical subtrees are stored once, which is what makes memoization pay off
+HashLifeNode* HashLife::create(HashLifeNode* nw, HashLifeNode* ne, HashLifeNode* sw, HashLifeNode* se)
+{
+    size_t index = hash_children(nw, ne, sw, se) & (m_buckets.size() - 1);
+    for(HashLifeNode* node = m_buckets[index]; node; node = node->m_next) {
+        if(node->m_nw == nw && node->m_ne == ne && node->m_sw == sw && node->m_se == se) {
+            return node;
+        }
+    }
+    HashLifeNode* node = new HashLifeNode();
+    node->m_nw         = nw;
+    node->m_ne         = ne;
+    node->m_sw         = sw;
+    node->m_se         = se;
+    node->m_result     = NULL;
+    node->m_next       = m_buckets[index];
+    node->m_population = nw->m_population + ne->m_population + sw->m_population + se->m_population;
+    node->m_level      = nw->m_level + 1;
+    node->m_marked     = false;
+    m_buckets[index] = node;
+    m_node_count++;
+    if(m_node_count > m_buckets.size()) {
+        rehash(m_buckets.size() * 2);
+    }
+    return node;
+}
+
+void HashLife::set_root(HashLifeNode* root, uint64_t generation)
+{
+    m_root = root;
+    while(m_root->m_level < HASHLIFE_MIN_LEVEL) {
+        m_root = expand(m_root);
+    }
+    m_generation = generation;
+}
+
+void HashLife::rehash(size_t bucket_count)
+{
+    std::vector<HashLifeNode*> buckets(bucket_count, NULL);
+    for(std::vector<HashLifeNode*>::iterator p = m_buckets.begin(); p != m_buckets.end(); p++) {
+        HashLifeNode* node = *p;
+        while(node) {
+            HashLifeNode* next = node->m_next;
+            size_t index = hash_children(node->m_nw, node->m_ne, node->m_sw, node->m_se) & (bucket_count - 1);
+            node->m_next   = buckets[index];
+            buckets[index] = node;
+            node = next;
+        }
+    }
+    m_buckets.swap(buckets);
+}
+
+// same node centered in a node twice the size
+HashLifeNode* HashLife::expand(HashLifeNode* node)
+{
+    if(!node->m_level) {
+        HashLifeNode* e = get_empty(0);
+        return create(e, e, e, node);
+    }
+    HashLifeNode* e = get_empty(node->m_level - 1);
+    return create(create(e, e, e, node->m_nw),
+                  create(e, e, node->m_ne, e),
+                  create(e, node->m_sw, e, e),
+                  create(node->m_se, e, e, e));
+}
+
+HashLifeNode* HashLife::center(HashLifeNode* node)
+{
+    return create(node->m_nw->m_se, node->m_ne->m_sw, node->m_sw->m_ne, node->m_se->m_nw);
+}
+
+//===================
+// core functionality
+//===================
+
+// center 2x2 of a 4x4 node, one generation later (brute force)
+HashLifeNode* HashLife::result_level2(HashLifeNode* node)
+{
+    int cells[4][4]; // [y][x], y up
+    const HashLifeNode* quads[4] = {node->m_sw, node->m_se, node->m_nw, node->m_ne};
+    for(int i = 0; i < 4; i++) {
+        int x = (i % 2) * 2;
+        int y = (i / 2) * 2;
+        cells[y + 1][x]     = static_cast<int>(quads[i]->m_nw->m_population);
+        cells[y + 1][x + 1] = static_cast<int>(quads[i]->m_ne->m_population);
+        cells[y][x]         = static_cast<int>(quads[i]->m_sw->m_population);
+        cells[y][x + 1]     = static_cast<int>(quads[i]->m_se->m_population);
+    }
+    bool next[2][2];
+    for(int y = 1; y <= 2; y++) {
+        for(int x = 1; x <= 2; x++) {
+            int sum = cells[y - 1][x - 1] + cells[y - 1][x] + cells[y - 1][x + 1] +
+                      cells[y][x - 1]                       + cells[y][x + 1] +
+                      cells[y + 1][x - 1] + cells[y + 1][x] + cells[y + 1][x + 1];
+            next[y - 1][x - 1] = life_rule_lookup(m_rule, cells[y][x], sum);
+        }
+    }
+    return create(get_leaf(next[1][0]), get_leaf(next[1][1]), get_leaf(next[0][0]), get_leaf(next[0][1]));
+}
+
+// NOTE: a level-n node advances 2^(n-2) generations at full speed (two rounds of sub-results);
+//       smaller step sizes take plain centers for the first round instead
+HashLifeNode* HashLife::result(HashLifeNode* node)
+{
+    if(node->m_result) {
+        m_result_hits++;
+        return node->m_result;
+    }
+    m_result_misses++;
+    HashLifeNode* r = NULL;
+    if(!node->m_population) {
+        r = get_empty(node->m_level - 1);
+    } else if(node->m_level == 2) {
+        r = result_level2(node);
+    } else {
+        HashLifeNode* nw = node->m_nw;
+        HashLifeNode* ne = node->m_ne;
+        HashLifeNode* sw = node->m_sw;
+        HashLifeNode* se = node->m_se;
+        HashLifeNode* n[3][3] = {
+            {nw,                                      create(nw->m_ne, ne->m_nw, nw->m_se, ne->m_sw), ne},
+            {create(nw->m_sw, nw->m_se, sw->m_nw, sw->m_ne),
+             create(nw->m_se, ne->m_sw, sw->m_ne, se->m_nw),
+             create(ne->m_sw, ne->m_se, se->m_nw, se->m_ne)},
+            {sw,                                      create(sw->m_ne, se->m_nw, sw->m_se, se->m_sw), se}
+        };
+        bool full_speed = (m_step_log2 >= node->m_level - 2);
+        for(int i = 0; i < 3; i++) {
+            for(int j = 0; j < 3; j++) {
+                n[i][j] = full_speed ? result(n[i][j]) : center(n[i][j]);
+            }
+        }
+        r = create(result(create(n[0][0], n[0][1], n[1][0], n[1][1])),
+                   result(create(n[0][1], n[0][2], n[1][1], n[1][2])),
+                   result(create(n[1][0], n[1][1], n[2][0], n[2][1])),
+                   result(create(n[1][1], n[1][2], n[2][1], n[2][2])));
+    }
+    node->m_result = r;
+    return r;
+}
+
+// NOTE: the root is padded until the pattern sits in its center half, so nothing can escape the result
+void HashLife::step(int iters)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for(int i = 0; i < iters; i++) {
+        while(m_root->m_level < m_step_log2 + 2 || m_root->m_population != center(m_root)->m_population) {
+            if(m_root->m_level >= HASHLIFE_MAX_LEVEL - 1) {
+                break;
+            }
+            m_root = expand(m_root);
+        }
+        if(m_root->m_level >= HASHLIFE_MAX_LEVEL - 1) {
+            break;
+        }
+        m_root = result(expand(m_root));
+        m_generation += 1ULL << m_step_log2;
+        if(m_node_count > m_max_nodes) {
+            gc();
+        }
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    m_elapsed_time += delta_time.count();
+}
+
+// NOTE: keeps memoized results of live nodes if that frees enough, otherwise drops them too
+void HashLife::gc()
+{
+    mark(m_root, true);
+    for(std::vector<HashLifeNode*>::iterator p = m_empty.begin(); p != m_empty.end(); p++) {
+        mark(*p, true);
+    }
+    sweep();
+    if(m_node_count > m_max_nodes / 2) {
+        clear_results();
+        mark(m_root, false);
+        for(std::vector<HashLifeNode*>::iterator p = m_empty.begin(); p != m_empty.end(); p++) {
+            mark(*p, false);
+        }
+        sweep();
+    }
+    m_gc_count++;
+}
+
+void HashLife::clear_results()
+{
+    for(std::vector<HashLifeNode*>::iterator p = m_buckets.begin(); p != m_buckets.end(); p++) {
+        for(HashLifeNode* node = *p; node; node = node->m_next) {
+            node->m_result = NULL;
+        }
+    }
+}
+
+void HashLife::mark(HashLifeNode* node, bool with_results)
+{
+    if(!node || !node->m_level || node->m_marked) {
+        return;
+    }
+    node->m_marked = true;
+    mark(node->m_nw, with_results);
+    mark(node->m_ne, with_results);
+    mark(node->m_sw, with_results);
+    mark(node->m_se, with_results);
+    if(with_results) {
+        mark(node->m_result, with_results);
+    }
+}
+
+void HashLife::sweep()
+{
+    for(std::vector<HashLifeNode*>::iterator p = m_buckets.begin(); p != m_buckets.end(); p++) {
+        HashLifeNode** link = &(*p);
+        while(*link) {
+            HashLifeNode* node = *link;
+            if(node->m_marked) {
+                node->m_marked = false;
+                link = &node->m_next;
+                continue;
+            }
+            *link = node->m_next;
+            delete node;
+            m_node_count--;
+        }
+    }
+}
+
+void HashLife::reset_stats()
+{
+    m_generation    = 0;
+    m_result_hits   = 0;
+    m_result_misses = 0;
+    m_elapsed_time  = 0;
+}
+
+}
@@ -0,0 +1,361 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <LifeKernel.h>
+#include <string.h>
+#include <stddef.h>
+#if defined(__x86_64__) || defined(__i386__)
+    // NOTE: gcc 12 warns about _mm512_undefined_epi32() inside its own avx512 headers when optimizing
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #include <immintrin.h>
+    #pragma GCC diagnostic pop
+    #define LIFE_KERNEL_X86
+#endif
+
+namespace vt {
+
+// template argument for the generic kernel: read the rule from the kernel's rule argument instead
+#define LIFE_RULE_RUNTIME 0xFFFFFFFFu
+
+// algebraic normal form of one half (birth or survival) of a rule over the neighbor count's bit planes: bit m (0..7)
+// is whether the product of the planes set in m (c0 c1 c2, bit 0 the constant term) is a term, bit 8 whether c3 is
+// NOTE: c3 is only set for a count of 8, when the other planes are clear, so its coefficient is table[8] ^ table[0]
+constexpr uint32_t life_rule_anf_step(uint32_t table, uint32_t low_bits, int shift)
+{
+    return table ^ ((table & low_bits) << shift);
+}
+
+constexpr uint32_t life_rule_anf(uint32_t table)
+{
+    return life_rule_anf_step(life_rule_anf_step(life_rule_anf_step(table & 0xFF, 0x55, 1), 0x33, 2), 0x0F, 4) |
+           ((((table >> 8) ^ table) & 1) << 8);
+}
+
+// all-ones if term (m) is in the algebraic normal form of the (alive) half of the rule
+#define LIFE_RULE_ANF_MASK(rule, alive, m) \
+        (((life_rule_anf((alive) ? get_life_rule_survival(rule) : get_life_rule_birth(rule)) >> (m)) & 1) ? ~0ULL : 0ULL)
+
+// one half of the rule at the cell's neighbor count, as the xor of the terms of its algebraic normal form
+#define LIFE_KERNEL_RULE_HALF(alive, AND, XOR, SET1) \
+        XOR(XOR(XOR(SET1(LIFE_RULE_ANF_MASK(r, alive, 0)), \
+                    AND(c0,   SET1(LIFE_RULE_ANF_MASK(r, alive, 1)))), \
+                XOR(AND(c1,   SET1(LIFE_RULE_ANF_MASK(r, alive, 2))), \
+                    AND(p01,  SET1(LIFE_RULE_ANF_MASK(r, alive, 3))))), \
+            XOR(XOR(AND(c2,   SET1(LIFE_RULE_ANF_MASK(r, alive, 4))), \
+                    AND(p02,  SET1(LIFE_RULE_ANF_MASK(r, alive, 5)))), \
+                XOR(AND(p12,  SET1(LIFE_RULE_ANF_MASK(r, alive, 6))), \
+                    XOR(AND(p012, SET1(LIFE_RULE_ANF_MASK(r, alive, 7))), \
+                        AND(c3,   SET1(LIFE_RULE_ANF_MASK(r, alive, 8)))))))
+
+// one word (or one vector of words) of one generation; bit i of a word is cell x = word_index * 64 + i, so the west
+// neighbor comes in through a left shift
+// NOTE: the bit-sliced adder tree yields the neighbor count as four bit planes (c3 c2 c1 c0); each half of the rule
+//       is then an xor of products of those planes (its algebraic normal form), the products shared by both halves.
+//       With the rule as a template argument the terms are constants and the compiler keeps only the gates that
+//       rule needs; the generic kernel evaluates every term, 40 gates where a mux tree over the lookup table takes
+//       about 80, and its per-cell cost does not depend on the rule either
+#define LIFE_KERNEL_BODY(V, LOAD, STORE, SLL, SRL, AND, OR, XOR, SET1) \
+        { \
+            V a     = LOAD(above + i); \
+            V a_w   = OR(SLL(a, 1), SRL(LOAD(above + i - 1), 63)); \
+            V a_e   = OR(SRL(a, 1), SLL(LOAD(above + i + 1), 63)); \
+            V b     = LOAD(row + i); \
+            V b_w   = OR(SLL(b, 1), SRL(LOAD(row + i - 1), 63)); \
+            V b_e   = OR(SRL(b, 1), SLL(LOAD(row + i + 1), 63)); \
+            V c     = LOAD(below + i); \
+            V c_w   = OR(SLL(c, 1), SRL(LOAD(below + i - 1), 63)); \
+            V c_e   = OR(SRL(c, 1), SLL(LOAD(below + i + 1), 63)); \
+            \
+            /* per-row partial sums (weights 1 and 2) */ \
+            V t_a   = XOR(a_w, a); \
+            V s_a   = XOR(t_a, a_e); \
+            V c_a   = OR(AND(a_w, a), AND(t_a, a_e)); \
+            V t_c   = XOR(c_w, c); \
+            V s_c   = XOR(t_c, c_e); \
+            V c_c   = OR(AND(c_w, c), AND(t_c, c_e)); \
+            V s_b   = XOR(b_w, b_e); \
+            V c_b   = AND(b_w, b_e); \
+            \
+            /* count = c0 + 2 * c1 + 4 * c2 + 8 * c3 */ \
+            V t_1   = XOR(s_a, s_c); \
+            V c0    = XOR(t_1, s_b); \
+            V car_1 = OR(AND(s_a, s_c), AND(t_1, s_b)); \
+            V t_2   = XOR(c_a, c_c); \
+            V twp   = XOR(t_2, c_b); \
+            V fours = OR(AND(c_a, c_c), AND(t_2, c_b)); \
+            V c1    = XOR(twp, car_1); \
+            V car_2 = AND(twp, car_1); \
+            V c2    = XOR(fours, car_2); \
+            V c3    = AND(fours, car_2); \
+            \
+            /* products of the count planes, shared by both halves of the rule */ \
+            V p01   = AND(c0, c1); \
+            V p02   = AND(c0, c2); \
+            V p12   = AND(c1, c2); \
+            V p012  = AND(p01, c2); \
+            \
+            /* born = rule[dead][count], i.e. the count alone would have made the cell alive */ \
+            V born  = LIFE_KERNEL_RULE_HALF(false, AND, XOR, SET1); \
+            V kept  = LIFE_KERNEL_RULE_HALF(true,  AND, XOR, SET1); \
+            \
+            /* next = rule[alive][count] */ \
+            V next  = XOR(born, AND(b, XOR(kept, born))); \
+            \
+            STORE(out + i,      next); \
+            STORE(out_grow + i, AND(next, born)); \
+        }
+
+#define SCALAR_LOAD(p)         (*(p))
+#define SCALAR_STORE(p, v)     (*(p) = (v))
+#define SCALAR_SLL(a, n)       ((a) << (n))
+#define SCALAR_SRL(a, n)       ((a) >> (n))
+#define SCALAR_AND(a, b)       ((a) & (b))
+#define SCALAR_OR(a, b)        ((a) | (b))
+#define SCALAR_XOR(a, b)       ((a) ^ (b))
+#define SCALAR_SET1(x)         (x)
+
+template<life_rule_t RULE>
+static void life_kernel_scalar(const uint64_t*   above,
+                               const uint64_t*   row,
+                               const uint64_t*   below,
+                                     uint64_t*   out,
+                                     uint64_t*   out_grow,
+                                     int         words,
+                                     uint64_t    last_word_mask,
+                                     life_rule_t rule)
+{
+    const life_rule_t r = (RULE == LIFE_RULE_RUNTIME) ? rule : RULE;
+    for(int i = 0; i < words; i++) {
+        LIFE_KERNEL_BODY(uint64_t, SCALAR_LOAD, SCALAR_STORE,
+                         SCALAR_SLL, SCALAR_SRL,
+                         SCALAR_AND, SCALAR_OR, SCALAR_XOR, SCALAR_SET1);
+    }
+    out[words - 1]      &= last_word_mask;
+    out_grow[words - 1] &= last_word_mask;
+}
+
+#ifdef LIFE_KERNEL_X86
+
+// same adder tree as life_kernel_scalar, one 64-bit word per vector lane
+// NOTE: the west/east carries come from unaligned loads shifted by one word, so lanes never cross
+
+#define SSE2_LOAD(p)     _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))
+#define SSE2_STORE(p, v) _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v)
+#define SSE2_SET1(x)     _mm_set1_epi64x(static_cast<long long>(x))
+
+template<life_rule_t RULE>
+__attribute__((target("sse2")))
+static void life_kernel_sse2(const uint64_t*   above,
+                             const uint64_t*   row,
+                             const uint64_t*   below,
+                                   uint64_t*   out,
+                                   uint64_t*   out_grow,
+                                   int         words,
+                                   uint64_t    last_word_mask,
+                                   life_rule_t rule)
+{
+    const life_rule_t r = (RULE == LIFE_RULE_RUNTIME) ? rule : RULE;
+    int i = 0;
+    for(; i + 2 <= words; i += 2) {
+        LIFE_KERNEL_BODY(__m128i, SSE2_LOAD, SSE2_STORE,
+                         _mm_slli_epi64, _mm_srli_epi64,
+                         _mm_and_si128, _mm_or_si128, _mm_xor_si128, SSE2_SET1);
+    }
+    if(i < words) {
+        life_kernel_scalar<RULE>(above + i, row + i, below + i, out + i, out_grow + i, words - i, last_word_mask, rule);
+        return;
+    }
+    out[words - 1]      &= last_word_mask;
+    out_grow[words - 1] &= last_word_mask;
+}
+
+#define AVX2_LOAD(p)     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+#define AVX2_STORE(p, v) _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v)
+#define AVX2_SET1(x)     _mm256_set1_epi64x(static_cast<long long>(x))
+
+template<life_rule_t RULE>
+__attribute__((target("avx2")))
+static void life_kernel_avx2(const uint64_t*   above,
+                             const uint64_t*   row,
+                             const uint64_t*   below,
+                                   uint64_t*   out,
+                                   uint64_t*   out_grow,
+                                   int         words,
+                                   uint64_t    last_word_mask,
+                                   life_rule_t rule)
+{
+    const life_rule_t r = (RULE == LIFE_RULE_RUNTIME) ? rule : RULE;
+    int i = 0;
+    for(; i + 4 <= words; i += 4) {
+        LIFE_KERNEL_BODY(__m256i, AVX2_LOAD, AVX2_STORE,
+                         _mm256_slli_epi64, _mm256_srli_epi64,
+                         _mm256_and_si256, _mm256_or_si256, _mm256_xor_si256, AVX2_SET1);
+    }
+    if(i < words) {
+        life_kernel_scalar<RULE>(above + i, row + i, below + i, out + i, out_grow + i, words - i, last_word_mask, rule);
+        return;
+    }
+    out[words - 1]      &= last_word_mask;
+    out_grow[words - 1] &= last_word_mask;
+}
+
+#define AVX512_LOAD(p)     _mm512_loadu_si512(reinterpret_cast<const void*>(p))
+#define AVX512_STORE(p, v) _mm512_storeu_si512(reinterpret_cast<void*>(p), v)
+#define AVX512_SET1(x)     _mm512_set1_epi64(static_cast<long long>(x))
+
+template<life_rule_t RULE>
+__attribute__((target("avx512f")))
+static void life_kernel_avx512(const uint64_t*   above,
+                               const uint64_t*   row,
+                               const uint64_t*   below,
+                                     uint64_t*   out,
+                                     uint64_t*   out_grow,
+                                     int         words,
+                                     uint64_t    last_word_mask,
+                                     life_rule_t rule)
+{
+    const life_rule_t r = (RULE == LIFE_RULE_RUNTIME) ? rule : RULE;
+    int i = 0;
+    for(; i + 8 <= words; i += 8) {
+        LIFE_KERNEL_BODY(__m512i, AVX512_LOAD, AVX512_STORE,
+                         _mm512_slli_epi64, _mm512_srli_epi64,
+                         _mm512_and_si512, _mm512_or_si512, _mm512_xor_si512, AVX512_SET1);
+    }
+    if(i < words) {
+        life_kernel_scalar<RULE>(above + i, row + i, below + i, out + i, out_grow + i, words - i, last_word_mask, rule);
+        return;
+    }
+    out[words - 1]      &= last_word_mask;
+    out_grow[words - 1] &= last_word_mask;
+}
+
+#endif
+
+//==============
+// rule registry
+//==============
+
+struct life_rule_kernels_t
+{
+    life_rule_t   rule;
+    life_kernel_t kernels[LIFE_KERNEL_COUNT];
+};
+
+#ifdef LIFE_KERNEL_X86
+    #define LIFE_RULE_KERNELS(rule) {rule, {life_kernel_scalar<rule>, \
+                                            life_kernel_sse2<rule>, \
+                                            life_kernel_avx2<rule>, \
+                                            life_kernel_avx512<rule>}},
+#else
+    #define LIFE_RULE_KERNELS(rule) {rule, {life_kernel_scalar<rule>, NULL, NULL, NULL}},
+#endif
+#define LIFE_RULE_KNOWN_KERNELS(name, birth_digits, survival_digits) \
+        LIFE_RULE_KERNELS(LIFE_RULE(birth_digits, survival_digits))
+
+// one instantiation per known rule; the last entry is the generic fallback
+static const life_rule_kernels_t life_rule_kernels[] = {
+    LIFE_RULE_TABLE(LIFE_RULE_KNOWN_KERNELS)
+    LIFE_RULE_KERNELS(LIFE_RULE_RUNTIME)
+};
+static const int life_rule_kernel_count = sizeof(life_rule_kernels) / sizeof(life_rule_kernels[0]);
+
+static const life_rule_kernels_t& find_life_rule_kernels(life_rule_t rule)
+{
+    for(int i = 0; i < life_rule_kernel_count - 1; i++) {
+        if(life_rule_kernels[i].rule == rule) {
+            return life_rule_kernels[i];
+        }
+    }
+    return life_rule_kernels[life_rule_kernel_count - 1];
+}
+
+bool is_life_kernel_specialized(life_rule_t rule)
+{
+    return find_life_rule_kernels(rule).rule != LIFE_RULE_RUNTIME;
+}
+
+//=================
+// runtime dispatch
+//=================
+
+static const char* life_kernel_names[] = {"scalar", "sse2", "avx2", "avx512"};
+
+bool life_kernel_supported(life_kernel_type_t type)
+{
+    switch(type) {
+        case LIFE_KERNEL_SCALAR:
+            return true;
+#ifdef LIFE_KERNEL_X86
+        case LIFE_KERNEL_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case LIFE_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case LIFE_KERNEL_AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            break;
+    }
+    return false;
+}
+
+life_kernel_type_t life_kernel_best()
+{
+    static life_kernel_type_t best = LIFE_KERNEL_COUNT;
+    if(best != LIFE_KERNEL_COUNT) {
+        return best;
+    }
+    best = LIFE_KERNEL_SCALAR;
+    for(int i = LIFE_KERNEL_COUNT - 1; i > LIFE_KERNEL_SCALAR; i--) {
+        if(life_kernel_supported(static_cast<life_kernel_type_t>(i))) {
+            best = static_cast<life_kernel_type_t>(i);
+            break;
+        }
+    }
+    return best;
+}
+
+life_kernel_t get_life_kernel(life_kernel_type_t type, life_rule_t rule)
+{
+    if(!life_kernel_supported(type)) {
+        return NULL;
+    }
+    return find_life_rule_kernels(rule).kernels[type];
+}
+
+const char* get_life_kernel_name(life_kernel_type_t type)
+{
+    if(type < 0 || type >= LIFE_KERNEL_COUNT) {
+        return "";
+    }
+    return life_kernel_names[type];
+}
+
+bool find_life_kernel(const char* name, life_kernel_type_t* type)
+{
+    for(int i = 0; i < LIFE_KERNEL_COUNT; i++) {
+        if(!strcmp(name, life_kernel_names[i])) {
+            *type = static_cast<life_kernel_type_t>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+}
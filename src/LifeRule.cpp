@@ -0,0 +1,253 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <LifeRule.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <ctype.h>
+#include <stdlib.h>
+#include <strings.h>
+
+namespace vt {
+
+struct known_life_rule_t
+{
+    const char* name;
+    life_rule_t rule;
+};
+
+struct known_generations_rule_t
+{
+    const char* name;
+    life_rule_t rule;
+    int         states;
+};
+
+#define LIFE_RULE_KNOWN(name, birth_digits, survival_digits) {name, LIFE_RULE(birth_digits, survival_digits)},
+static const known_life_rule_t known_life_rules[] = {
+    LIFE_RULE_TABLE(LIFE_RULE_KNOWN)
+};
+#undef LIFE_RULE_KNOWN
+
+#define GENERATIONS_RULE_KNOWN(name, birth_digits, survival_digits, states) \
+        {name, LIFE_RULE(birth_digits, survival_digits), states},
+static const known_generations_rule_t known_generations_rules[] = {
+    GENERATIONS_RULE_TABLE(GENERATIONS_RULE_KNOWN)
+};
+#undef GENERATIONS_RULE_KNOWN
+
+static bool parse_life_rule_digits(const std::string& digits, uint32_t* mask) // out
+{
+    *mask = 0;
+    for(std::string::const_iterator p = digits.begin(); p != digits.end(); p++) {
+        if(*p < '0' || *p > '8') {
+            return false;
+        }
+        *mask |= 1u << (*p - '0');
+    }
+    return true;
+}
+
+bool find_life_rule(const char* str, life_rule_t* rule)
+{
+    for(int i = 0; i < get_known_life_rule_count(); i++) {
+        if(!strcasecmp(str, known_life_rules[i].name)) {
+            *rule = known_life_rules[i].rule;
+            return true;
+        }
+    }
+    std::string s(str);
+    size_t slash = s.find('/');
+    if(slash == std::string::npos) {
+        return false;
+    }
+    std::string lhs = s.substr(0, slash);
+    std::string rhs = s.substr(slash + 1);
+    char lhs_tag = lhs.empty() ? 0 : toupper(lhs[0]);
+    char rhs_tag = rhs.empty() ? 0 : toupper(rhs[0]);
+    uint32_t birth    = 0;
+    uint32_t survival = 0;
+    if(lhs_tag == 'B' && rhs_tag == 'S') {
+        if(!parse_life_rule_digits(lhs.substr(1), &birth) || !parse_life_rule_digits(rhs.substr(1), &survival)) {
+            return false;
+        }
+    } else if(lhs_tag == 'S' && rhs_tag == 'B') {
+        if(!parse_life_rule_digits(lhs.substr(1), &survival) || !parse_life_rule_digits(rhs.substr(1), &birth)) {
+            return false;
+        }
+    } else if(!parse_life_rule_digits(lhs, &survival) || !parse_life_rule_digits(rhs, &birth)) { // S/B
+        return false;
+    }
+    *rule = make_life_rule(birth, survival);
+    return true;
+}
+
+std::string get_life_rule_string(life_rule_t rule)
+{
+    std::string s = "B";
+    for(int i = 0; i < LIFE_RULE_COUNTS; i++) {
+        if(life_rule_lookup(rule, false, i)) {
+            s += static_cast<char>('0' + i);
+        }
+    }
+    s += "/S";
+    for(int i = 0; i < LIFE_RULE_COUNTS; i++) {
+        if(life_rule_lookup(rule, true, i)) {
+            s += static_cast<char>('0' + i);
+        }
+    }
+    return s;
+}
+
+const char* get_life_rule_name(life_rule_t rule)
+{
+    for(int i = 0; i < get_known_life_rule_count(); i++) {
+        if(known_life_rules[i].rule == rule) {
+            return known_life_rules[i].name;
+        }
+    }
+    return NULL;
+}
+
+int get_known_life_rule_count()
+{
+    return sizeof(known_life_rules) / sizeof(known_life_rules[0]);
+}
+
+life_rule_t get_known_life_rule(int index)
+{
+    return known_life_rules[index].rule;
+}
+
+bool find_generations_rule(const char* str, life_rule_t* rule, int* states)
+{
+    for(int i = 0; i < get_known_generations_rule_count(); i++) {
+        if(!strcasecmp(str, known_generations_rules[i].name)) {
+            *rule   = known_generations_rules[i].rule;
+            *states = known_generations_rules[i].states;
+            return true;
+        }
+    }
+    std::string s(str);
+    size_t slash = s.rfind('/');
+    if(slash == std::string::npos || s.find('/') == slash) { // not three fields
+        *states = 2;
+        return find_life_rule(str, rule);
+    }
+    std::string count = s.substr(slash + 1);
+    if(!count.empty() && (toupper(count[0]) == 'C' || toupper(count[0]) == 'G')) {
+        count = count.substr(1);
+    }
+    if(count.empty() || count.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    int n = atoi(count.c_str());
+    if(n < 2 || n > GENERATIONS_MAX_STATES) {
+        return false;
+    }
+    if(!find_life_rule(s.substr(0, slash).c_str(), rule)) {
+        return false;
+    }
+    *states = n;
+    return true;
+}
+
+std::string get_generations_rule_string(life_rule_t rule, int states)
+{
+    std::stringstream ss;
+    ss << get_life_rule_string(rule) << "/C" << states;
+    return ss.str();
+}
+
+const char* get_generations_rule_name(life_rule_t rule, int states)
+{
+    for(int i = 0; i < get_known_generations_rule_count(); i++) {
+        if(known_generations_rules[i].rule == rule && known_generations_rules[i].states == states) {
+            return known_generations_rules[i].name;
+        }
+    }
+    return (states == 2) ? get_life_rule_name(rule) : NULL;
+}
+
+int get_known_generations_rule_count()
+{
+    return sizeof(known_generations_rules) / sizeof(known_generations_rules[0]);
+}
+
+life_rule_t get_known_generations_rule(int index, int* states)
+{
+    *states = known_generations_rules[index].states;
+    return known_generations_rules[index].rule;
+}
+
+static std::string get_life_rule_glsl_array(const char* name, life_rule_t rule, bool alive)
+{
+    std::stringstream ss;
+    ss << "const bool " << name << "[" << LIFE_RULE_COUNTS << "] = bool[" << LIFE_RULE_COUNTS << "](";
+    for(int i = 0; i < LIFE_RULE_COUNTS; i++) {
+        ss << (i ? ", " : "") << (life_rule_lookup(rule, alive, i) ? "true" : "false");
+    }
+    ss << ");";
+    return ss.str();
+}
+
+// NOTE: replaces whichever of the "const bool BIRTH[...]", "const bool SURVIVAL[...]" and "const int STATES" lines
+//       the template has
+bool write_life_rule_shader(const std::string& template_filename,
+                            const std::string& output_filename,
+                            life_rule_t        rule,
+                            int                states)
+{
+    std::ifstream in(template_filename.c_str());
+    if(!in) {
+        return false;
+    }
+    std::stringstream ss;
+    std::string line;
+    int replaced = 0;
+    bool first_line = true;
+    while(std::getline(in, line)) {
+        if(!line.compare(0, 16, "const bool BIRTH")) {
+            line = get_life_rule_glsl_array("BIRTH",    rule, false);
+            replaced++;
+        } else if(!line.compare(0, 19, "const bool SURVIVAL")) {
+            line = get_life_rule_glsl_array("SURVIVAL", rule, true);
+            replaced++;
+        } else if(!line.compare(0, 16, "const int STATES")) {
+            std::stringstream states_ss;
+            states_ss << "const int STATES = " << states << ";";
+            line = states_ss.str();
+            replaced++;
+        }
+        ss << (first_line ? "" : "\n") << line;
+        first_line = false;
+    }
+    if(!replaced) {
+        return false;
+    }
+    std::ofstream out(output_filename.c_str());
+    if(!out) {
+        return false;
+    }
+    out << "// generated from \"" << template_filename << "\" for "
+        << ((states == 2) ? get_life_rule_string(rule) : get_generations_rule_string(rule, states)) << "\n" << ss.str();
+    return static_cast<bool>(out);
+}
+
+}
@@ -0,0 +1,279 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <MazeSolver.h>
+#include <ThreadPool.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <math.h>
+#include <stdlib.h>
+
+namespace vt {
+
+void gen_maze_r32f(float* pixels, glm::ivec2 dim)
+{
+    std::fill(pixels, pixels + dim.x * dim.y, MAZE_WALL_COLOR); // clear
+    glm::ivec2 half_dim((dim.x - 1) / 2, (dim.y - 1) / 2);
+    if(half_dim.x <= 0 || half_dim.y <= 0) {
+        return;
+    }
+    for(int y = 1; y < dim.y - 1; y += 2) {
+        for(int x = 1; x < dim.x - 1; x += 2) {
+            pixels[y * dim.x + x] = MAZE_EMPTY_COLOR;
+        }
+    }
+    std::vector<bool> visited(half_dim.x * half_dim.y, false);
+    std::vector<glm::ivec2> frontier;
+    frontier.push_back(glm::ivec2(rand() / (static_cast<float>(RAND_MAX) + 1) * half_dim.x,
+                                  rand() / (static_cast<float>(RAND_MAX) + 1) * half_dim.y));
+    visited[frontier[0].y * half_dim.x + frontier[0].x] = true;
+    glm::ivec2 offset_4[] = {
+        glm::ivec2( 0,  1), // n
+        glm::ivec2( 0, -1), // s
+        glm::ivec2( 1,  0), // e
+        glm::ivec2(-1,  0)  // w
+        };
+    glm::ivec2 halfdim_min(0), halfdim_max(half_dim - glm::ivec2(1));
+    while(frontier.size()) {
+        int seed_index = rand() / (static_cast<float>(RAND_MAX) + 1) * frontier.size();
+        glm::ivec2 seed = frontier[seed_index];
+        for(int i = 0; i < 4; i++) {
+            glm::ivec2 sample = glm::clamp(seed + offset_4[i], halfdim_min, halfdim_max);
+            if(sample != seed && !visited[sample.y * half_dim.x + sample.x]) {
+                glm::ivec2 passage = glm::ivec2(1) + sample * 2 - offset_4[i];
+                pixels[passage.y * dim.x + passage.x] = MAZE_EMPTY_COLOR;
+                frontier.push_back(sample);
+                visited[sample.y * half_dim.x + sample.x] = true;
+            }
+        }
+        // NOTE: order does not matter, seeds are picked at random
+        frontier[seed_index] = frontier.back();
+        frontier.pop_back();
+    }
+}
+
+void gen_maze_tree_rgba32f(const float* pixels, glm::ivec2 dim, float* tree_pixels)
+{
+    std::vector<glm::ivec2> parents(dim.x * dim.y, glm::ivec2(-1));
+    std::vector<glm::ivec2> queue;
+    glm::ivec2 offset_4[] = {
+        glm::ivec2( 0,  1), // n
+        glm::ivec2( 0, -1), // s
+        glm::ivec2( 1,  0), // e
+        glm::ivec2(-1,  0)  // w
+        };
+    for(int y = 0; y < dim.y; y++) {
+        for(int x = 0; x < dim.x; x++) {
+            if(pixels[y * dim.x + x] == MAZE_WALL_COLOR || parents[y * dim.x + x].x >= 0) {
+                continue;
+            }
+            parents[y * dim.x + x] = glm::ivec2(x, y); // root of a new region
+            queue.assign(1, glm::ivec2(x, y));
+            for(size_t i = 0; i < queue.size(); i++) {
+                glm::ivec2 cell = queue[i];
+                for(int j = 0; j < 4; j++) {
+                    glm::ivec2 neighbor = cell + offset_4[j];
+                    if(neighbor.x < 0 || neighbor.x >= dim.x || neighbor.y < 0 || neighbor.y >= dim.y ||
+                       pixels[neighbor.y * dim.x + neighbor.x] == MAZE_WALL_COLOR ||
+                       parents[neighbor.y * dim.x + neighbor.x].x >= 0)
+                    {
+                        continue;
+                    }
+                    parents[neighbor.y * dim.x + neighbor.x] = cell;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+    }
+    for(int y = 0; y < dim.y; y++) {
+        for(int x = 0; x < dim.x; x++) {
+            glm::ivec2 cell(x, y);
+            glm::ivec2 parent = parents[y * dim.x + x];
+            float* texel = tree_pixels + (y * dim.x + x) * 4;
+            if(parent.x < 0 || parent == cell) { // wall or root
+                texel[0] = x;
+                texel[1] = y;
+                texel[2] = 0;
+                texel[3] = 0;
+                continue;
+            }
+            glm::ivec2 grandparent = parents[parent.y * dim.x + parent.x];
+            glm::ivec2 in_dir = cell - parent, out_dir = grandparent - parent;
+            bool cut = (grandparent != parent && (parent.x & 1) && (parent.y & 1) &&
+                        in_dir.x * out_dir.x + in_dir.y * out_dir.y == 0);
+            texel[0] = parent.x;
+            texel[1] = parent.y;
+            texel[2] = cut ? 0 : 1;
+            texel[3] = 1;
+        }
+    }
+}
+
+MazeSolver::MazeSolver(glm::ivec2 dim)
+    : m_dim(dim),
+      m_words_per_row((dim.x + 2 + 63) / 64),
+      m_goal(-1),
+      m_cells(dim.x * dim.y, CELL_EMPTY),
+      m_free(m_words_per_row * (dim.y + 2), 0),
+      m_open(m_words_per_row * (dim.y + 2)),
+      m_distance(dim.x * dim.y),
+      m_thread_pool(NULL),
+      m_max_distance(-1),
+      m_reached(0),
+      m_parallel_wavefronts(0),
+      m_elapsed_time(0)
+{
+    for(size_t i = 0; i < m_open.size(); i++) {
+        m_open[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MazeSolver::load_r32f(const float* pixels)
+{
+    std::fill(m_free.begin(), m_free.end(), 0);
+    for(int y = 0; y < m_dim.y; y++) {
+        for(int x = 0; x < m_dim.x; x++) {
+            int i = y * m_dim.x + x;
+            float value = pixels[i];
+            m_cells[i] = (value == MAZE_WALL_COLOR)   ? CELL_WALL :
+                         (value == MAZE_SPRITE_COLOR) ? CELL_SPRITE
+                                                      : CELL_EMPTY;
+            if(m_cells[i] == CELL_EMPTY) {
+                int bit = get_bit(glm::ivec2(x, y));
+                m_free[bit >> 6] |= 1ULL << (bit & 63);
+            }
+            if(value == MAZE_SEED_COLOR) {
+                m_goal = glm::ivec2(x, y);
+            }
+        }
+    }
+}
+
+void MazeSolver::store_r32f(float* pixels) const
+{
+    for(int y = 0; y < m_dim.y; y++) {
+        for(int x = 0; x < m_dim.x; x++) {
+            int i = y * m_dim.x + x;
+            int distance = get_distance(glm::ivec2(x, y));
+            pixels[i] = (m_cells[i] == CELL_WALL)   ? MAZE_WALL_COLOR :
+                        (m_cells[i] == CELL_SPRITE) ? MAZE_SPRITE_COLOR :
+                        (distance >= 0)             ? m_colors[distance]
+                                                    : MAZE_EMPTY_COLOR;
+        }
+    }
+}
+
+// NOTE: in parallel (ATOMIC), a cell is claimed by whichever task clears its open bit first, so it lands in
+//       exactly one next wavefront and its distance has one writer; on one thread a plain store does
+template<bool ATOMIC>
+void MazeSolver::expand(const glm::ivec2* cells, size_t count, int32_t distance, std::vector<glm::ivec2>* next_frontier)
+{
+    for(size_t i = 0; i < count; i++) {
+        int bit = get_bit(cells[i]) - 1 - m_words_per_row * 64; // top left of the 3x3 neighborhood
+        for(int row = 0; row < 3; row++, bit += m_words_per_row * 64) {
+            int word  = bit >> 6;
+            int shift = bit & 63;
+            uint64_t open = m_open[word].load(std::memory_order_relaxed) >> shift;
+            if(shift > 61) {
+                open |= m_open[word + 1].load(std::memory_order_relaxed) << (64 - shift);
+            }
+            open &= 7;
+            while(open) {
+                int column = __builtin_ctzll(open);
+                open &= open - 1;
+                int neighbor_bit = bit + column;
+                uint64_t mask = 1ULL << (neighbor_bit & 63);
+                std::atomic<uint64_t>& neighbor_word = m_open[neighbor_bit >> 6];
+                if(ATOMIC) {
+                    if(!(neighbor_word.fetch_and(~mask, std::memory_order_relaxed) & mask)) {
+                        continue;
+                    }
+                } else {
+                    neighbor_word.store(neighbor_word.load(std::memory_order_relaxed) & ~mask, std::memory_order_relaxed);
+                }
+                glm::ivec2 neighbor(cells[i].x - 1 + column, cells[i].y - 1 + row);
+                m_distance[neighbor.y * m_dim.x + neighbor.x] = distance;
+                next_frontier->push_back(neighbor);
+            }
+        }
+    }
+}
+
+void MazeSolver::solve()
+{
+    std::chrono::steady_clock::time_point begin_time = std::chrono::steady_clock::now();
+
+    // NOTE: distances are not reset; whatever a cell still open holds is never read
+    for(size_t i = 0; i < m_open.size(); i++) {
+        m_open[i].store(m_free[i], std::memory_order_relaxed);
+    }
+    m_max_distance        = -1;
+    m_reached             = 0;
+    m_parallel_wavefronts = 0;
+    m_frontier.clear();
+    if(m_goal.x >= 0 && m_goal.x < m_dim.x && m_goal.y >= 0 && m_goal.y < m_dim.y &&
+       m_cells[m_goal.y * m_dim.x + m_goal.x] == CELL_EMPTY)
+    {
+        int bit = get_bit(m_goal);
+        m_open[bit >> 6].fetch_and(~(1ULL << (bit & 63)), std::memory_order_relaxed);
+        m_distance[m_goal.y * m_dim.x + m_goal.x] = 0;
+        m_frontier.push_back(m_goal);
+    }
+
+    // one wavefront per distance
+    for(int32_t distance = 0; !m_frontier.empty(); distance++) {
+        m_max_distance = distance;
+        m_reached += m_frontier.size();
+        m_next_frontier.clear();
+        if(m_thread_pool && m_frontier.size() >= MAZE_SOLVER_PARALLEL_FRONTIER) {
+            int task_count = (m_frontier.size() + MAZE_SOLVER_TASK_CELLS - 1) / MAZE_SOLVER_TASK_CELLS;
+            if(static_cast<int>(m_task_frontiers.size()) < task_count) {
+                m_task_frontiers.resize(task_count);
+            }
+            m_thread_pool->parallel_for(task_count, [this, distance](int task_index, int thread_index) {
+                size_t begin = static_cast<size_t>(task_index) * MAZE_SOLVER_TASK_CELLS;
+                size_t count = std::min(m_frontier.size() - begin, static_cast<size_t>(MAZE_SOLVER_TASK_CELLS));
+                m_task_frontiers[task_index].clear();
+                expand<true>(&m_frontier[begin], count, distance + 1, &m_task_frontiers[task_index]);
+            });
+            for(int i = 0; i < task_count; i++) {
+                m_next_frontier.insert(m_next_frontier.end(), m_task_frontiers[i].begin(), m_task_frontiers[i].end());
+            }
+            m_parallel_wavefronts++;
+        } else {
+            expand<false>(&m_frontier[0], m_frontier.size(), distance + 1, &m_next_frontier);
+        }
+        m_frontier.swap(m_next_frontier);
+    }
+
+    // field values, evaluated as the shader does: mix(max_value, WALL_COLOR, 1 - DECAY_FACTOR)
+    float decay = 1 - MAZE_DECAY_FACTOR;
+    float min_color = nextafterf(MAZE_WALL_COLOR, MAZE_SEED_COLOR);
+    m_colors.resize(std::max(m_max_distance + 1, 1));
+    m_colors[0] = MAZE_SEED_COLOR;
+    for(int i = 1; i <= m_max_distance; i++) {
+        m_colors[i] = std::max(m_colors[i - 1] * (1 - decay) + MAZE_WALL_COLOR * decay, min_color);
+    }
+
+    m_elapsed_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_time).count();
+}
+
+}
@@ -52,6 +52,7 @@ Program::var_uniform_type_to_name_table_t Program::m_var_uniform_type_to_name_ta
         {Program::var_uniform_type_color_texture,                   "color_texture"},
         {Program::var_uniform_type_color_texture2,                  "color_texture2"},
         {Program::var_uniform_type_cursor_pos,                      "cursor_pos"},
+        {Program::var_uniform_type_decay_texture,                   "decay_texture"},
         {Program::var_uniform_type_env_map_texture,                 "env_map_texture"},
         {Program::var_uniform_type_frontface_depth_overlay_texture, "frontface_depth_overlay_texture"},
         {Program::var_uniform_type_glow_cutoff_threshold,           "glow_cutoff_threshold"},
@@ -66,11 +67,14 @@ Program::var_uniform_type_to_name_table_t Program::m_var_uniform_type_to_name_ta
         {Program::var_uniform_type_model_transform,                 "model_transform"},
         {Program::var_uniform_type_mvp_transform,                   "mvp_transform"},
         {Program::var_uniform_type_normal_transform,                "normal_transform"},
+        {Program::var_uniform_type_occupancy_texture,               "occupancy_texture"},
+        {Program::var_uniform_type_random_seed,                     "random_seed"},
         {Program::var_uniform_type_random_texture,                  "random_texture"},
         {Program::var_uniform_type_reflect_to_refract_ratio,        "reflect_to_refract_ratio"},
-        {Program::var_uniform_type_sprite_pos,                      "sprite_pos"},
         {Program::var_uniform_type_sprite_count,                    "sprite_count"},
+        {Program::var_uniform_type_sprite_texture,                  "sprite_texture"},
         {Program::var_uniform_type_ssao_sample_kernel_pos,          "ssao_sample_kernel_pos"},
+        {Program::var_uniform_type_universe_dim,                    "universe_dim"},
         {Program::var_uniform_type_viewport_dim,                    "viewport_dim"},
         {Program::var_uniform_type_view_proj_transform,             "view_proj_transform"},
         {Program::var_uniform_type_count,                           ""}
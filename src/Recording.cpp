@@ -0,0 +1,428 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <Recording.h>
+#include <Snapshot.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+namespace vt {
+
+//==================
+// recorder
+//==================
+
+Recorder::Recorder()
+    : m_file(NULL),
+      m_keyframe_interval(RECORDING_DEFAULT_KEYFRAME_INTERVAL),
+      m_queue(RECORDING_QUEUE_SIZE),
+      m_queue_head(0),
+      m_queue_count(0),
+      m_quit(false),
+      m_frames(0),
+      m_keyframes(0),
+      m_tiles(0),
+      m_bytes(0),
+      m_failed(false),
+      m_stall_time(0),
+      m_write_time(0)
+{
+}
+
+Recorder::~Recorder()
+{
+    close();
+}
+
+bool Recorder::open(const std::string& filename, int keyframe_interval)
+{
+    close();
+    m_file = fopen(filename.c_str(), "wb");
+    if(!m_file) {
+        return false;
+    }
+    m_keyframe_interval = std::max(keyframe_interval, 1);
+    m_queue_head  = 0;
+    m_queue_count = 0;
+    m_quit        = false;
+    m_frames      = 0;
+    m_keyframes   = 0;
+    m_tiles       = 0;
+    m_bytes       = 0;
+    m_failed      = false;
+    m_stall_time  = 0;
+    m_write_time  = 0;
+    m_thread = std::thread(&Recorder::run, this);
+    return true;
+}
+
+void Recorder::close()
+{
+    if(!m_file) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_queue_cond.notify_all();
+    m_thread.join();
+    if(fclose(m_file)) {
+        m_failed = true;
+    }
+    m_file = NULL;
+}
+
+void Recorder::record(Snapshot* frame)
+{
+    if(!m_file) {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(m_queue_count == RECORDING_QUEUE_SIZE) {
+            std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+            m_done_cond.wait(lock, [this] { return m_queue_count < RECORDING_QUEUE_SIZE; });
+            std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+            m_stall_time += delta_time.count();
+        }
+        m_queue[(m_queue_head + m_queue_count) % RECORDING_QUEUE_SIZE].swap(*frame);
+        m_queue_count++;
+    }
+    m_queue_cond.notify_all();
+}
+
+long Recorder::get_frames() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_frames;
+}
+
+long Recorder::get_keyframes() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_keyframes;
+}
+
+long Recorder::get_tiles() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_tiles;
+}
+
+uint64_t Recorder::get_bytes() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+bool Recorder::is_failed() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+double Recorder::get_stall_time() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_stall_time;
+}
+
+double Recorder::get_write_time() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_write_time;
+}
+
+// NOTE: queued frames are written before quitting; after a failure they are only drained
+void Recorder::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for(;;) {
+        m_queue_cond.wait(lock, [this] { return m_queue_count || m_quit; });
+        if(!m_queue_count) {
+            return;
+        }
+        Snapshot* frame = &m_queue[m_queue_head]; // stays queued, so record() cannot reuse it mid-write
+        bool failed = m_failed;
+        lock.unlock();
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        recording_frame_t header;
+        memset(&header, 0, sizeof(header));
+        bool result = !failed && write_frame(frame, &header);
+        std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+        lock.lock();
+        if(result) {
+            m_bytes += (m_frames ? 0 : sizeof(recording_header_t)) + sizeof(header) + header.size;
+            m_frames++;
+            m_keyframes += (header.type == RECORDING_FRAME_KEY);
+            m_tiles     += header.tile_count;
+        } else {
+            m_failed = true;
+        }
+        m_write_time += delta_time.count();
+        m_queue_head = (m_queue_head + 1) % RECORDING_QUEUE_SIZE;
+        m_queue_count--;
+        m_done_cond.notify_all();
+    }
+}
+
+bool Recorder::write_frame(Snapshot* frame, recording_frame_t* header)
+{
+    if(!m_frames) {
+        recording_header_t file_header;
+        memset(&file_header, 0, sizeof(file_header));
+        memcpy(file_header.magic, RECORDING_MAGIC, sizeof(file_header.magic));
+        file_header.version           = RECORDING_VERSION;
+        file_header.cells             = frame->get_cells();
+        file_header.width             = frame->get_dim().x;
+        file_header.height            = frame->get_dim().y;
+        file_header.tile_dim          = SNAPSHOT_TILE_DIM;
+        file_header.rule              = frame->get_rule();
+        file_header.states            = frame->get_states();
+        file_header.keyframe_interval = m_keyframe_interval;
+        if(fwrite(&file_header, sizeof(file_header), 1, m_file) != 1) {
+            return false;
+        }
+    } else if(frame->get_dim() != m_prev.get_dim() || frame->get_cells() != m_prev.get_cells()) {
+        return false;
+    }
+    bool key = !(m_frames % m_keyframe_interval);
+    if(!key) {
+        m_prev.xor_cells(*frame); // now the delta
+    }
+    const Snapshot& source = key ? *frame : m_prev;
+    glm::ivec2 tile_dim = source.get_tile_dim();
+    int prev_index = -1;
+    m_buffer.clear();
+    header->tile_count = 0;
+    for(int tile_y = 0; tile_y < tile_dim.y; tile_y++) {
+        for(int tile_x = 0; tile_x < tile_dim.x; tile_x++) {
+            snapshot_encoding_t encoding = source.encode_tile(glm::ivec2(tile_x, tile_y), &m_payload);
+            if(encoding == SNAPSHOT_ENCODING_EMPTY) {
+                continue; // dead (key) or unchanged (delta)
+            }
+            int index = tile_y * tile_dim.x + tile_x;
+            Snapshot::put_varint(&m_buffer, index - prev_index - 1);
+            Snapshot::put_varint(&m_buffer, encoding);
+            Snapshot::put_varint(&m_buffer, m_payload.size());
+            m_buffer.insert(m_buffer.end(), m_payload.begin(), m_payload.end());
+            prev_index = index;
+            header->tile_count++;
+        }
+    }
+    header->generation = frame->get_generation();
+    header->type       = key ? RECORDING_FRAME_KEY : RECORDING_FRAME_DELTA;
+    header->size       = m_buffer.size();
+    if(fwrite(header, sizeof(*header), 1, m_file) != 1 ||
+       (!m_buffer.empty() && fwrite(&m_buffer[0], 1, m_buffer.size(), m_file) != m_buffer.size())) {
+        return false;
+    }
+    m_prev.swap(*frame);
+    return true;
+}
+
+//==================
+// replayer
+//==================
+
+Replayer::Replayer()
+    : m_file(NULL),
+      m_dim(0),
+      m_cells(SNAPSHOT_CELLS_BIT),
+      m_rule(LIFE_RULE_CONWAY),
+      m_states(2),
+      m_keyframe_interval(0),
+      m_frame(-1),
+      m_frames_decoded(0)
+{
+}
+
+Replayer::~Replayer()
+{
+    close();
+}
+
+// NOTE: a frame cut short at the end of the file (the recorder died mid-write) is ignored
+bool Replayer::open(const std::string& filename)
+{
+    close();
+    m_file = fopen(filename.c_str(), "rb");
+    if(!m_file) {
+        return false;
+    }
+    recording_header_t header;
+    if(fread(&header, sizeof(header), 1, m_file) != 1 ||
+       memcmp(header.magic, RECORDING_MAGIC, sizeof(header.magic)) ||
+       header.version != RECORDING_VERSION ||
+       header.tile_dim != SNAPSHOT_TILE_DIM ||
+       (header.cells != SNAPSHOT_CELLS_BIT && header.cells != SNAPSHOT_CELLS_BYTE && header.cells != SNAPSHOT_CELLS_FLOAT) ||
+       header.width <= 0 || header.height <= 0 ||
+       fseek(m_file, 0, SEEK_END)) {
+        close();
+        return false;
+    }
+    uint64_t file_size = ftell(m_file);
+    m_dim               = glm::ivec2(header.width, header.height);
+    m_cells             = static_cast<snapshot_cells_t>(header.cells);
+    m_rule              = header.rule;
+    m_states            = header.states;
+    m_keyframe_interval = header.keyframe_interval;
+    frame_entry_t entry;
+    uint64_t offset = sizeof(header);
+    while(offset + sizeof(recording_frame_t) <= file_size &&
+          !fseek(m_file, offset, SEEK_SET) &&
+          fread(&entry.frame, sizeof(entry.frame), 1, m_file) == 1) {
+        entry.offset = offset + sizeof(entry.frame);
+        if((entry.frame.type != RECORDING_FRAME_KEY && entry.frame.type != RECORDING_FRAME_DELTA) ||
+           entry.frame.size > file_size - entry.offset ||
+           (m_frames.empty() && entry.frame.type != RECORDING_FRAME_KEY) ||
+           (!m_frames.empty() && entry.frame.generation <= m_frames.back().frame.generation)) {
+            break;
+        }
+        m_frames.push_back(entry);
+        offset = entry.offset + entry.frame.size;
+    }
+    m_snapshot.resize(m_dim, m_cells);
+    m_snapshot.set_rule(m_rule, m_states);
+    m_frame = -1;
+    return true;
+}
+
+void Replayer::close()
+{
+    if(m_file) {
+        fclose(m_file);
+        m_file = NULL;
+    }
+    m_frames.clear();
+    m_frame = -1;
+}
+
+long Replayer::get_keyframe_count() const
+{
+    long count = 0;
+    for(size_t i = 0; i < m_frames.size(); i++) {
+        count += (m_frames[i].frame.type == RECORDING_FRAME_KEY);
+    }
+    return count;
+}
+
+uint64_t Replayer::get_first_generation() const
+{
+    return m_frames.empty() ? 0 : m_frames.front().frame.generation;
+}
+
+uint64_t Replayer::get_last_generation() const
+{
+    return m_frames.empty() ? 0 : m_frames.back().frame.generation;
+}
+
+// NOTE: from the current frame if it lies between the keyframe and the target, so stepping forward through a
+//       recording with seek() costs one delta per call
+bool Replayer::seek(uint64_t generation)
+{
+    m_frames_decoded = 0;
+    long target = 0;
+    long lo = 0;
+    long hi = m_frames.size();
+    while(lo < hi) { // first frame at or after the generation
+        long mid = (lo + hi) / 2;
+        if(m_frames[mid].frame.generation < generation) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    target = lo;
+    if(target == static_cast<long>(m_frames.size()) || m_frames[target].frame.generation != generation) {
+        return false;
+    }
+    long start = target;
+    while(m_frames[start].frame.type != RECORDING_FRAME_KEY) {
+        start--;
+    }
+    if(m_frame >= start && m_frame <= target) {
+        start = m_frame + 1;
+    }
+    for(long i = start; i <= target; i++) {
+        if(!decode_frame(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Replayer::next()
+{
+    m_frames_decoded = 0;
+    if(m_frame < 0 || m_frame + 1 >= static_cast<long>(m_frames.size())) {
+        return false;
+    }
+    return decode_frame(m_frame + 1);
+}
+
+bool Replayer::decode_frame(long index)
+{
+    const frame_entry_t& entry = m_frames[index];
+    bool key = (entry.frame.type == RECORDING_FRAME_KEY);
+    m_frame = -1; // until the whole frame is applied
+    m_buffer.resize(entry.frame.size);
+    if(fseek(m_file, entry.offset, SEEK_SET) ||
+       (!m_buffer.empty() && fread(&m_buffer[0], 1, m_buffer.size(), m_file) != m_buffer.size())) {
+        return false;
+    }
+    if(key) {
+        m_snapshot.resize(m_dim, m_cells);
+    }
+    glm::ivec2 tile_dim = m_snapshot.get_tile_dim();
+    long tile_count = static_cast<long>(tile_dim.x) * tile_dim.y;
+    const uint8_t* p   = m_buffer.empty() ? NULL : &m_buffer[0];
+    const uint8_t* end = p + m_buffer.size();
+    long tile_index = -1;
+    for(uint32_t i = 0; i < entry.frame.tile_count; i++) {
+        uint64_t gap, encoding, size;
+        if(!Snapshot::get_varint(&p, end, &gap) ||
+           !Snapshot::get_varint(&p, end, &encoding) ||
+           !Snapshot::get_varint(&p, end, &size) ||
+           gap >= static_cast<uint64_t>(tile_count - tile_index - 1) ||
+           size > static_cast<uint64_t>(end - p)) {
+            return false;
+        }
+        tile_index += gap + 1;
+        glm::ivec2 tile_pos(tile_index % tile_dim.x * SNAPSHOT_TILE_DIM, tile_index / tile_dim.x * SNAPSHOT_TILE_DIM);
+        glm::ivec2 cell_dim = glm::min(m_dim - tile_pos, glm::ivec2(SNAPSHOT_TILE_DIM));
+        if(!m_snapshot.decode_tile(static_cast<snapshot_encoding_t>(encoding), p, size, cell_dim, &m_cells_buffer)) {
+            return false;
+        }
+        m_snapshot.blit_tile(m_cells_buffer, cell_dim, tile_pos, !key);
+        p += size;
+    }
+    m_snapshot.set_generation(entry.frame.generation);
+    m_frame = index;
+    m_frames_decoded++;
+    return true;
+}
+
+}
@@ -45,7 +45,6 @@
 #define TARGET_RADIUS           0.125
 #define TARGETS_RADIUS          0.0625
 #define BROKEN_EDGE_ALPHA       0.125f
-#define MAX_SPRITES             100
 
 #define draw_edge(p1, p2) \
         glVertex3fv(&p1.x); \
@@ -78,11 +77,13 @@ Scene::Scene()
       m_light_color(NULL),
       m_light_enabled(NULL),
       m_ssao_sample_kernel_pos(NULL),
-      m_sprite_pos(NULL),
-      m_sprite_angle(NULL),
-      m_sprite_velocity(NULL),
-      m_sprite_angle_velocity(NULL),
-      m_sprite_count(0)
+      m_sprite_count(0),
+      m_sprite_texture(NULL),
+      m_occupancy_texture(NULL),
+      m_decay_texture(NULL),
+      m_overlay_point_coords(NULL),
+      m_overlay_point_count(0),
+      m_random_seed(0)
 {
     //const int bloom_kernel_row[BLOOM_KERNEL_SIZE] = {1, 4, 6, 4, 1};
     const int bloom_kernel_row[BLOOM_KERNEL_SIZE] = {1, 6, 15, 20, 15, 6, 1};
@@ -104,13 +105,6 @@ Scene::Scene()
     memset(m_light_pos,     0, sizeof(GLfloat) * 3 * NUM_LIGHTS);
     memset(m_light_color,   0, sizeof(GLfloat) * 3 * NUM_LIGHTS);
     memset(m_light_enabled, 0, sizeof(GLint)       * NUM_LIGHTS);
-    m_sprite_pos            = new glm::vec2[MAX_SPRITES];
-    m_sprite_angle          = new float[MAX_SPRITES];
-    m_sprite_velocity       = new float[MAX_SPRITES];
-    m_sprite_angle_velocity = new float[MAX_SPRITES];
-    memset(m_sprite_angle,          0, sizeof(float) * MAX_SPRITES);
-    memset(m_sprite_velocity,       0, sizeof(float) * MAX_SPRITES);
-    memset(m_sprite_angle_velocity, 0, sizeof(float) * MAX_SPRITES);
 
     // http://john-chapman-graphics.blogspot.tw/2013/01/ssao-tutorial.html
     m_ssao_sample_kernel_pos = new GLfloat[NUM_SSAO_SAMPLE_KERNELS * 3];
@@ -163,18 +157,6 @@ Scene::~Scene()
     if(m_ssao_sample_kernel_pos) {
         delete[] m_ssao_sample_kernel_pos;
     }
-    if(m_sprite_pos) {
-        delete[] m_sprite_pos;
-    }
-    if(m_sprite_angle) {
-        delete[] m_sprite_angle;
-    }
-    if(m_sprite_velocity) {
-        delete[] m_sprite_velocity;
-    }
-    if(m_sprite_angle_velocity) {
-        delete[] m_sprite_angle_velocity;
-    }
 }
 
 void Scene::set_cursor_pos(glm::ivec2 cursor_pos)
@@ -182,65 +164,11 @@ void Scene::set_cursor_pos(glm::ivec2 cursor_pos)
     m_cursor_pos = cursor_pos;
 }
 
-void Scene::set_sprite_pos(int index, glm::vec2 sprite_pos)
+void Scene::set_sprite_count(int count)
 {
-    if(index < 0 || index >= MAX_SPRITES) {
-        return;
-    }
-    m_sprite_pos[index] = sprite_pos;
-}
-
-glm::vec2 Scene::get_sprite_pos(int index) const {
-    if(index < 0 || index >= MAX_SPRITES) {
-        return glm::vec2(0);
-    }
-    return m_sprite_pos[index];
-}
-
-void Scene::set_sprite_angle(int index, float angle) {
-    if(index < 0 || index >= MAX_SPRITES) {
-        return;
-    }
-    m_sprite_angle[index] = angle;
-}
-
-float Scene::get_sprite_angle(int index) const {
-    if(index < 0 || index >= MAX_SPRITES) {
-        return 0;
-    }
-    return m_sprite_angle[index];
-}
-
-void Scene::set_sprite_velocity(int index, float velocity) {
-    if(index < 0 || index >= MAX_SPRITES) {
+    if(count < 0) {
         return;
     }
-    m_sprite_velocity[index] = velocity;
-}
-
-float Scene::get_sprite_velocity(int index) const {
-    if(index < 0 || index >= MAX_SPRITES) {
-        return 0;
-    }
-    return m_sprite_velocity[index];
-}
-
-void Scene::set_sprite_angle_velocity(int index, float angle_velocity) {
-    if(index < 0 || index >= MAX_SPRITES) {
-        return;
-    }
-    m_sprite_angle_velocity[index] = angle_velocity;
-}
-
-float Scene::get_sprite_angle_velocity(int index) const {
-    if(index < 0 || index >= MAX_SPRITES) {
-        return 0;
-    }
-    return m_sprite_angle_velocity[index];
-}
-
-void Scene::set_sprite_count(int count)
-{
     m_sprite_count = count;
 }
 
@@ -400,12 +328,28 @@ void Scene::render(bool                clear_canvas,
         if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_cursor_pos)) {
             shader_context->set_cursor_pos(glm::value_ptr(m_cursor_pos));
         }
-        if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_sprite_pos)) {
-            shader_context->set_sprite_pos(m_sprite_count, glm::value_ptr(m_sprite_pos[0]));
+        if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_universe_dim)) {
+            shader_context->set_universe_dim(glm::value_ptr(m_universe_dim));
         }
         if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_sprite_count)) {
             shader_context->set_sprite_count(m_sprite_count);
         }
+        if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_sprite_texture) && m_sprite_texture) {
+            shader_context->set_sprite_texture_index(material->get_texture_index(m_sprite_texture));
+        }
+        if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_occupancy_texture) && m_occupancy_texture) {
+            shader_context->set_occupancy_texture_index(material->get_texture_index(m_occupancy_texture));
+        }
+        if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_decay_texture) && m_decay_texture) {
+            shader_context->set_decay_texture_index(material->get_texture_index(m_decay_texture));
+        }
+        if(program->has_var(Program::VAR_TYPE_UNIFORM, Program::var_uniform_type_random_seed)) {
+            shader_context->set_random_seed(m_random_seed);
+        }
+        if(m_overlay_point_coords) {
+            shader_context->render_points(m_overlay_point_coords, m_overlay_point_count);
+            return;
+        }
         shader_context->render();
         return;
     }
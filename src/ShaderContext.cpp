@@ -147,6 +147,30 @@ void ShaderContext::render()
     }
 }
 
+// NOTE: drawn like the overlay (no depth test, gl_Vertex in the vertex shader), so a vertex shader can scatter
+//       points to texels it looks up, such as sprite positions (see "src/shaders/overlay_maze_occupancy.v.glsl")
+void ShaderContext::render_points(Buffer* vbo_point_coords, GLsizei point_count)
+{
+    m_material->get_program()->use();
+    int i = 0;
+    for(ShaderContext::textures_t::const_iterator p = m_textures.begin(); p != m_textures.end(); ++p) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        (*p)->bind();
+        i++;
+    }
+    glDisable(GL_DEPTH_TEST);
+    vbo_point_coords->bind();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2,        // number of elements per vertex, here (x,y)
+                    GL_FLOAT, // the type of each element
+                    0,        // no extra data between each position
+                    0);       // offset of first element
+    glDrawArrays(GL_POINTS, 0, point_count);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    vbo_point_coords->unbind();
+    glEnable(GL_DEPTH_TEST);
+}
+
 void ShaderContext::set_ambient_color(const float* ambient_color)
 {
     m_var_uniforms[Program::var_uniform_type_ambient_color]->uniform_3fv(1, ambient_color);
@@ -310,9 +334,9 @@ void ShaderContext::set_cursor_pos(const GLint* cursor_pos_arr)
     m_var_uniforms[Program::var_uniform_type_cursor_pos]->uniform_2iv(1, cursor_pos_arr);
 }
 
-void ShaderContext::set_sprite_pos(size_t num_sprites, const float* sprite_pos_arr)
+void ShaderContext::set_universe_dim(const GLint* universe_dim_arr)
 {
-    m_var_uniforms[Program::var_uniform_type_sprite_pos]->uniform_2fv(num_sprites, sprite_pos_arr);
+    m_var_uniforms[Program::var_uniform_type_universe_dim]->uniform_2iv(1, universe_dim_arr);
 }
 
 void ShaderContext::set_sprite_count(GLint sprite_count)
@@ -320,4 +344,27 @@ void ShaderContext::set_sprite_count(GLint sprite_count)
     m_var_uniforms[Program::var_uniform_type_sprite_count]->uniform_1i(sprite_count);
 }
 
+void ShaderContext::set_sprite_texture_index(GLint texture_id)
+{
+    assert(texture_id >= 0 && texture_id < static_cast<int>(m_textures.size()));
+    m_var_uniforms[Program::var_uniform_type_sprite_texture]->uniform_1i(texture_id);
+}
+
+void ShaderContext::set_occupancy_texture_index(GLint texture_id)
+{
+    assert(texture_id >= 0 && texture_id < static_cast<int>(m_textures.size()));
+    m_var_uniforms[Program::var_uniform_type_occupancy_texture]->uniform_1i(texture_id);
+}
+
+void ShaderContext::set_decay_texture_index(GLint texture_id)
+{
+    assert(texture_id >= 0 && texture_id < static_cast<int>(m_textures.size()));
+    m_var_uniforms[Program::var_uniform_type_decay_texture]->uniform_1i(texture_id);
+}
+
+void ShaderContext::set_random_seed(GLint random_seed)
+{
+    m_var_uniforms[Program::var_uniform_type_random_seed]->uniform_1i(random_seed);
+}
+
 }
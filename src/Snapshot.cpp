@@ -0,0 +1,673 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <Snapshot.h>
+#include <BitBoard.h>
+#include <ConwayEngine.h>
+#include <GenerationsEngine.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+namespace vt {
+
+// LEB128; runs are mostly short, so most take one byte
+void Snapshot::put_varint(std::vector<uint8_t>* out, uint64_t value)
+{
+    while(value >= 0x80) {
+        out->push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+bool Snapshot::get_varint(const uint8_t** p, const uint8_t* end, uint64_t* value)
+{
+    *value = 0;
+    for(int shift = 0; *p < end && shift < 64; shift += 7) {
+        uint8_t byte = *(*p)++;
+        *value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline uint64_t get_bit_mask(int bits)
+{
+    return (bits >= 64) ? ~0ULL : ((1ULL << bits) - 1);
+}
+
+static inline void put_bits(uint64_t* dest, uint64_t bits, bool apply_xor) // IN/OUT
+{
+    *dest = apply_xor ? (*dest ^ bits) : (*dest | bits);
+}
+
+Snapshot::Snapshot()
+    : m_dim(0),
+      m_cells(SNAPSHOT_CELLS_BIT),
+      m_row_size(0),
+      m_generation(0),
+      m_rule(LIFE_RULE_CONWAY),
+      m_states(2)
+{
+}
+
+glm::ivec2 Snapshot::get_tile_dim() const
+{
+    return (m_dim + glm::ivec2(SNAPSHOT_TILE_DIM - 1)) / SNAPSHOT_TILE_DIM;
+}
+
+int Snapshot::get_cell_size() const
+{
+    switch(m_cells) {
+        case SNAPSHOT_CELLS_BYTE:  return sizeof(uint8_t);
+        case SNAPSHOT_CELLS_FLOAT: return sizeof(float);
+        default:
+            break;
+    }
+    return 0;
+}
+
+void Snapshot::resize(glm::ivec2 dim, snapshot_cells_t cells)
+{
+    m_dim   = dim;
+    m_cells = cells;
+    m_row_size = (cells == SNAPSHOT_CELLS_BIT) ? ((dim.x + 63) / 64) * sizeof(uint64_t)
+                                               : static_cast<size_t>(dim.x) * get_cell_size();
+    m_data.assign((m_row_size * dim.y + sizeof(uint64_t) - 1) / sizeof(uint64_t) + 1, 0); // never empty
+}
+
+size_t Snapshot::get_population() const
+{
+    size_t population = 0;
+    int cell_size = get_cell_size();
+    for(int y = 0; y < m_dim.y; y++) {
+        const uint8_t* row = get_row(y);
+        if(!cell_size) {
+            const uint64_t* words = reinterpret_cast<const uint64_t*>(row);
+            for(int i = 0; i < (m_dim.x + 63) / 64; i++) {
+                population += __builtin_popcountll(words[i]);
+            }
+            continue;
+        }
+        for(int x = 0; x < m_dim.x; x++) {
+            const uint8_t* cell = row + x * cell_size;
+            bool live = false;
+            for(int i = 0; i < cell_size; i++) {
+                live = live || cell[i];
+            }
+            population += live;
+        }
+    }
+    return population;
+}
+
+void Snapshot::xor_cells(const Snapshot& other)
+{
+    for(size_t i = 0; i < m_data.size(); i++) {
+        m_data[i] ^= other.m_data[i];
+    }
+}
+
+//==================
+// capture/restore
+//==================
+
+void Snapshot::capture(const BitBoard& board)
+{
+    resize(board.get_dim(), SNAPSHOT_CELLS_BIT);
+    for(int y = 0; y < m_dim.y; y++) {
+        memcpy(get_row(y), board.get_row(y), m_row_size);
+    }
+    m_generation = board.get_generation();
+    m_rule       = board.get_rule();
+    m_states     = 2;
+}
+
+void Snapshot::capture_r32f(const float* pixels, glm::ivec2 dim, snapshot_cells_t cells)
+{
+    if(cells != SNAPSHOT_CELLS_BIT) {
+        resize(dim, SNAPSHOT_CELLS_FLOAT);
+        memcpy(get_row(0), pixels, sizeof(float) * dim.x * dim.y);
+        return;
+    }
+    resize(dim, SNAPSHOT_CELLS_BIT);
+    for(int y = 0; y < dim.y; y++) {
+        const float* src  = &pixels[y * dim.x];
+        uint64_t*    dest = reinterpret_cast<uint64_t*>(get_row(y));
+        for(int x = 0; x < dim.x; x++) {
+            if(src[x] > 0) {
+                dest[x / 64] |= 1ULL << (x % 64);
+            }
+        }
+    }
+}
+
+void Snapshot::capture_r8(const uint8_t* pixels, glm::ivec2 dim)
+{
+    resize(dim, SNAPSHOT_CELLS_BYTE);
+    memcpy(get_row(0), pixels, dim.x * dim.y);
+}
+
+// NOTE: clear() marks every tile changed, so the board steps everything once
+bool Snapshot::restore(BitBoard* board) const
+{
+    if(board->get_dim() != m_dim) {
+        return false;
+    }
+    board->clear();
+    for(int y = 0; y < m_dim.y; y++) {
+        uint64_t* dest = board->get_row(y);
+        if(m_cells == SNAPSHOT_CELLS_BIT) {
+            memcpy(dest, get_row(y), m_row_size);
+            continue;
+        }
+        for(int x = 0; x < m_dim.x; x++) {
+            bool alive = (m_cells == SNAPSHOT_CELLS_BYTE) ? get_row(y)[x] == GENERATIONS_ALIVE
+                                                          : reinterpret_cast<const float*>(get_row(y))[x] > 0;
+            if(alive) {
+                dest[x / BITBOARD_WORD_BITS] |= 1ULL << (x % BITBOARD_WORD_BITS);
+            }
+        }
+    }
+    return true;
+}
+
+bool Snapshot::restore_r32f(float* pixels, glm::ivec2 dim) const
+{
+    if(dim != m_dim) {
+        return false;
+    }
+    if(m_cells == SNAPSHOT_CELLS_FLOAT) {
+        memcpy(pixels, get_row(0), sizeof(float) * dim.x * dim.y);
+        return true;
+    }
+    for(int y = 0; y < dim.y; y++) {
+        const uint8_t* src  = get_row(y);
+        float*         dest = &pixels[y * dim.x];
+        for(int x = 0; x < dim.x; x++) {
+            bool alive = (m_cells == SNAPSHOT_CELLS_BIT) ? (reinterpret_cast<const uint64_t*>(src)[x / 64] >> (x % 64)) & 1
+                                                         : src[x] == GENERATIONS_ALIVE;
+            dest[x] = alive ? CONWAY_LIVE_COLOR : CONWAY_DIE_COLOR;
+        }
+    }
+    return true;
+}
+
+bool Snapshot::restore_r8(uint8_t* pixels, glm::ivec2 dim) const
+{
+    if(dim != m_dim) {
+        return false;
+    }
+    if(m_cells == SNAPSHOT_CELLS_BYTE) {
+        memcpy(pixels, get_row(0), dim.x * dim.y);
+        return true;
+    }
+    for(int y = 0; y < dim.y; y++) {
+        const uint8_t* src  = get_row(y);
+        uint8_t*       dest = &pixels[y * dim.x];
+        for(int x = 0; x < dim.x; x++) {
+            bool alive = (m_cells == SNAPSHOT_CELLS_BIT) ? (reinterpret_cast<const uint64_t*>(src)[x / 64] >> (x % 64)) & 1
+                                                         : reinterpret_cast<const float*>(src)[x] > 0;
+            dest[x] = alive ? GENERATIONS_ALIVE : GENERATIONS_DEAD;
+        }
+    }
+    return true;
+}
+
+//==================
+// file i/o
+//==================
+
+bool Snapshot::save(const std::string& filename) const
+{
+    std::string tmp_filename = filename + ".tmp";
+    FILE* file = fopen(tmp_filename.c_str(), "wb");
+    if(!file) {
+        return false;
+    }
+    snapshot_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version    = SNAPSHOT_VERSION;
+    header.cells      = m_cells;
+    header.width      = m_dim.x;
+    header.height     = m_dim.y;
+    header.tile_dim   = SNAPSHOT_TILE_DIM;
+    header.rule       = m_rule;
+    header.states     = m_states;
+    header.generation = m_generation;
+    fwrite(&header, sizeof(header), 1, file); // index offset filled in last
+
+    glm::ivec2 tile_dim = get_tile_dim();
+    std::vector<snapshot_tile_t> index(tile_dim.x * tile_dim.y);
+    std::vector<uint8_t> payload;
+    uint64_t offset = sizeof(header);
+    for(int tile_y = 0; tile_y < tile_dim.y; tile_y++) {
+        for(int tile_x = 0; tile_x < tile_dim.x; tile_x++) {
+            snapshot_tile_t& tile = index[tile_y * tile_dim.x + tile_x];
+            tile.encoding = encode_tile(glm::ivec2(tile_x, tile_y), &payload);
+            tile.offset   = offset;
+            tile.size     = payload.size();
+            if(!payload.empty()) {
+                fwrite(&payload[0], 1, payload.size(), file);
+            }
+            offset += payload.size();
+        }
+    }
+    header.index_offset = offset;
+    fwrite(&index[0], sizeof(snapshot_tile_t), index.size(), file);
+    fseek(file, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, file);
+    bool result = !ferror(file);
+    result = !fclose(file) && result;
+    if(!result || rename(tmp_filename.c_str(), filename.c_str())) {
+        remove(tmp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Snapshot::load(const std::string& filename)
+{
+    return load(filename, glm::ivec2(0), glm::ivec2(0), true);
+}
+
+bool Snapshot::load_region(const std::string& filename, glm::ivec2 pos, glm::ivec2 dim)
+{
+    return load(filename, pos, dim, false);
+}
+
+bool Snapshot::load(const std::string& filename, glm::ivec2 pos, glm::ivec2 dim, bool whole)
+{
+    FILE* file = fopen(filename.c_str(), "rb");
+    if(!file) {
+        return false;
+    }
+    snapshot_header_t header;
+    if(fread(&header, sizeof(header), 1, file) != 1 ||
+       memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) ||
+       header.version != SNAPSHOT_VERSION ||
+       header.tile_dim != SNAPSHOT_TILE_DIM ||
+       (header.cells != SNAPSHOT_CELLS_BIT && header.cells != SNAPSHOT_CELLS_BYTE && header.cells != SNAPSHOT_CELLS_FLOAT) ||
+       header.width <= 0 || header.height <= 0) {
+        fclose(file);
+        return false;
+    }
+    glm::ivec2 board_dim(header.width, header.height);
+    if(whole) {
+        pos = glm::ivec2(0);
+        dim = board_dim;
+    }
+    if(pos.x < 0 || pos.y < 0 || dim.x <= 0 || dim.y <= 0 || pos.x + dim.x > board_dim.x || pos.y + dim.y > board_dim.y) {
+        fclose(file);
+        return false;
+    }
+    resize(dim, static_cast<snapshot_cells_t>(header.cells));
+    m_generation = header.generation;
+    m_rule       = header.rule;
+    m_states     = header.states;
+
+    // whole index, then only the tiles that overlap the region (in file order)
+    glm::ivec2 tile_dim = (board_dim + glm::ivec2(SNAPSHOT_TILE_DIM - 1)) / SNAPSHOT_TILE_DIM;
+    std::vector<snapshot_tile_t> index(tile_dim.x * tile_dim.y);
+    bool result = !fseek(file, header.index_offset, SEEK_SET) &&
+                  fread(&index[0], sizeof(snapshot_tile_t), index.size(), file) == index.size();
+    glm::ivec2 tile_min = pos / SNAPSHOT_TILE_DIM;
+    glm::ivec2 tile_max = (pos + dim - glm::ivec2(1)) / SNAPSHOT_TILE_DIM;
+    std::vector<uint8_t> payload;
+    std::vector<uint8_t> cells;
+    uint64_t file_pos = ~0ULL;
+    for(int tile_y = tile_min.y; result && tile_y <= tile_max.y; tile_y++) {
+        for(int tile_x = tile_min.x; result && tile_x <= tile_max.x; tile_x++) {
+            const snapshot_tile_t& tile = index[tile_y * tile_dim.x + tile_x];
+            if(tile.encoding == SNAPSHOT_ENCODING_EMPTY) {
+                continue; // already zero
+            }
+            payload.resize(tile.size);
+            if(tile.offset != file_pos && fseek(file, tile.offset, SEEK_SET)) {
+                result = false;
+                break;
+            }
+            if(tile.size && fread(&payload[0], 1, tile.size, file) != tile.size) {
+                result = false;
+                break;
+            }
+            file_pos = tile.offset + tile.size;
+            glm::ivec2 tile_pos(tile_x * SNAPSHOT_TILE_DIM, tile_y * SNAPSHOT_TILE_DIM);
+            glm::ivec2 cell_dim = glm::min(board_dim - tile_pos, glm::ivec2(SNAPSHOT_TILE_DIM));
+            result = decode_tile(static_cast<snapshot_encoding_t>(tile.encoding),
+                                 payload.empty() ? NULL : &payload[0],
+                                 payload.size(),
+                                 cell_dim,
+                                 &cells);
+            if(result) {
+                blit_tile(cells, cell_dim, tile_pos - pos);
+            }
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+void Snapshot::swap(Snapshot& other)
+{
+    std::swap(m_dim,        other.m_dim);
+    std::swap(m_cells,      other.m_cells);
+    std::swap(m_row_size,   other.m_row_size);
+    std::swap(m_generation, other.m_generation);
+    std::swap(m_rule,       other.m_rule);
+    std::swap(m_states,     other.m_states);
+    m_data.swap(other.m_data);
+}
+
+//==================
+// tile codec
+//==================
+
+// runs are taken along the tile's rows as if they were one string; the raw form wins whenever runs would not be
+// smaller (noise), so a tile never costs more than its packed cells
+snapshot_encoding_t Snapshot::encode_tile(glm::ivec2 tile_pos, std::vector<uint8_t>* payload) const
+{
+    payload->clear();
+    int x0 = tile_pos.x * SNAPSHOT_TILE_DIM;
+    int y0 = tile_pos.y * SNAPSHOT_TILE_DIM;
+    int w  = std::min(SNAPSHOT_TILE_DIM, m_dim.x - x0);
+    int h  = std::min(SNAPSHOT_TILE_DIM, m_dim.y - y0);
+    if(m_cells == SNAPSHOT_CELLS_BIT) {
+        uint64_t mask = get_bit_mask(w);
+        uint64_t words[SNAPSHOT_TILE_DIM];
+        uint64_t any  = 0;
+        for(int r = 0; r < h; r++) {
+            words[r] = reinterpret_cast<const uint64_t*>(get_row(y0 + r))[tile_pos.x] & mask;
+            any |= words[r];
+        }
+        if(!any) {
+            return SNAPSHOT_ENCODING_EMPTY;
+        }
+        size_t raw_size = h * sizeof(uint64_t);
+        uint64_t run   = 0;
+        bool     value = false;
+        for(int r = 0; r < h && payload->size() < raw_size; r++) {
+            int pos = 0;
+            while(pos < w) {
+                uint64_t differ = (value ? ~words[r] : words[r]) >> pos;
+                int n = differ ? std::min(__builtin_ctzll(differ), w - pos) : w - pos;
+                run += n;
+                pos += n;
+                if(pos < w) {
+                    put_varint(payload, run);
+                    run   = 0;
+                    value = !value;
+                }
+            }
+        }
+        put_varint(payload, run);
+        if(payload->size() < raw_size) {
+            return SNAPSHOT_ENCODING_RUNS;
+        }
+        payload->resize(raw_size);
+        memcpy(&(*payload)[0], words, raw_size);
+        return SNAPSHOT_ENCODING_RAW;
+    }
+    int    cell_size = get_cell_size();
+    size_t raw_size  = static_cast<size_t>(w) * h * cell_size;
+    bool any = false;
+    for(int r = 0; r < h && !any; r++) {
+        const uint8_t* row = get_row(y0 + r) + x0 * cell_size;
+        for(int i = 0; i < w * cell_size; i++) {
+            if(row[i]) {
+                any = true;
+                break;
+            }
+        }
+    }
+    if(!any) {
+        return SNAPSHOT_ENCODING_EMPTY;
+    }
+    const uint8_t* value = get_row(y0) + x0 * cell_size;
+    uint64_t run = 0;
+    for(int r = 0; r < h && payload->size() < raw_size; r++) {
+        const uint8_t* cell = get_row(y0 + r) + x0 * cell_size;
+        for(int x = 0; x < w; x++, cell += cell_size) {
+            if(!memcmp(cell, value, cell_size)) {
+                run++;
+                continue;
+            }
+            put_varint(payload, run);
+            payload->insert(payload->end(), value, value + cell_size);
+            value = cell;
+            run   = 1;
+        }
+    }
+    put_varint(payload, run);
+    payload->insert(payload->end(), value, value + cell_size);
+    if(payload->size() < raw_size) {
+        return SNAPSHOT_ENCODING_RUNS;
+    }
+    payload->resize(raw_size);
+    for(int r = 0; r < h; r++) {
+        memcpy(&(*payload)[r * w * cell_size], get_row(y0 + r) + x0 * cell_size, w * cell_size);
+    }
+    return SNAPSHOT_ENCODING_RAW;
+}
+
+bool Snapshot::decode_tile(snapshot_encoding_t   encoding,
+                           const uint8_t*        payload,
+                           size_t                size,
+                           glm::ivec2            tile_dim,
+                           std::vector<uint8_t>* cells) const
+{
+    int    cell_size = get_cell_size();
+    size_t row_size  = cell_size ? tile_dim.x * cell_size : sizeof(uint64_t);
+    size_t raw_size  = row_size * tile_dim.y;
+    cells->assign(raw_size, 0);
+    if(encoding == SNAPSHOT_ENCODING_EMPTY) {
+        return true;
+    }
+    if(encoding == SNAPSHOT_ENCODING_RAW) {
+        if(size != raw_size) {
+            return false;
+        }
+        memcpy(&(*cells)[0], payload, raw_size);
+        return true;
+    }
+    if(encoding != SNAPSHOT_ENCODING_RUNS) {
+        return false;
+    }
+    const uint8_t* p   = payload;
+    const uint8_t* end = payload + size;
+    uint64_t cell_count = static_cast<uint64_t>(tile_dim.x) * tile_dim.y;
+    uint64_t i = 0;
+    bool value = false;
+    while(p < end) {
+        uint64_t run;
+        if(!get_varint(&p, end, &run) || run > cell_count - i) {
+            return false;
+        }
+        if(!cell_size) {
+            for(uint64_t j = i; value && j < i + run; j++) {
+                int x = j % tile_dim.x;
+                int y = j / tile_dim.x;
+                reinterpret_cast<uint64_t*>(&(*cells)[0])[y] |= 1ULL << x;
+            }
+            value = !value;
+        } else {
+            if(end - p < cell_size) {
+                return false;
+            }
+            for(uint64_t j = i; j < i + run; j++) {
+                memcpy(&(*cells)[j * cell_size], p, cell_size);
+            }
+            p += cell_size;
+        }
+        i += run;
+    }
+    return i == cell_count;
+}
+
+// NOTE: bit tiles are shifted into place a word at a time, so a region need not start on a tile boundary
+void Snapshot::blit_tile(const std::vector<uint8_t>& cells, glm::ivec2 tile_dim, glm::ivec2 pos, bool apply_xor)
+{
+    int cell_size = get_cell_size();
+    int lo = std::max(0, -pos.x);
+    int hi = std::min(tile_dim.x, m_dim.x - pos.x);
+    if(lo >= hi) {
+        return;
+    }
+    for(int r = 0; r < tile_dim.y; r++) {
+        int y = pos.y + r;
+        if(y < 0 || y >= m_dim.y) {
+            continue;
+        }
+        if(cell_size && apply_xor) {
+            uint8_t*       dest   = get_row(y) + (pos.x + lo) * cell_size;
+            const uint8_t* source = &cells[(r * tile_dim.x + lo) * cell_size];
+            for(int i = 0; i < (hi - lo) * cell_size; i++) {
+                dest[i] ^= source[i];
+            }
+            continue;
+        }
+        if(cell_size) {
+            memcpy(get_row(y) + (pos.x + lo) * cell_size, &cells[(r * tile_dim.x + lo) * cell_size], (hi - lo) * cell_size);
+            continue;
+        }
+        uint64_t  word = reinterpret_cast<const uint64_t*>(&cells[0])[r] & (get_bit_mask(hi) & ~get_bit_mask(lo));
+        uint64_t* dest = reinterpret_cast<uint64_t*>(get_row(y));
+        if(pos.x < 0) {
+            put_bits(&dest[0], word >> -pos.x, apply_xor);
+            continue;
+        }
+        int shift = pos.x % 64;
+        put_bits(&dest[pos.x / 64], word << shift, apply_xor);
+        if(shift && (pos.x / 64 + 1) * 64 < m_dim.x) {
+            put_bits(&dest[pos.x / 64 + 1], word >> (64 - shift), apply_xor);
+        }
+    }
+}
+
+//==================
+// background writer
+//==================
+
+SnapshotWriter::SnapshotWriter()
+    : m_busy(false),
+      m_quit(false),
+      m_written(0),
+      m_skipped(0),
+      m_failed(0),
+      m_write_time(0)
+{
+    m_thread = std::thread(&SnapshotWriter::run, this);
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start_cond.notify_all();
+    m_thread.join();
+}
+
+bool SnapshotWriter::submit(Snapshot* snapshot, const std::string& filename)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(m_busy) {
+            m_skipped++;
+            return false;
+        }
+        m_snapshot.swap(*snapshot);
+        m_filename = filename;
+        m_busy     = true;
+    }
+    m_start_cond.notify_all();
+    return true;
+}
+
+bool SnapshotWriter::is_busy() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_busy;
+}
+
+void SnapshotWriter::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_cond.wait(lock, [this] { return !m_busy; });
+}
+
+long SnapshotWriter::get_written() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_written;
+}
+
+long SnapshotWriter::get_skipped() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_skipped;
+}
+
+long SnapshotWriter::get_failed() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+double SnapshotWriter::get_write_time() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_write_time;
+}
+
+// NOTE: a pending write is finished before quitting
+void SnapshotWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for(;;) {
+        m_start_cond.wait(lock, [this] { return m_busy || m_quit; });
+        if(!m_busy) {
+            return;
+        }
+        lock.unlock();
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        bool result = m_snapshot.save(m_filename);
+        std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+        lock.lock();
+        if(result) {
+            m_written++;
+        } else {
+            m_failed++;
+        }
+        m_write_time += delta_time.count();
+        m_busy = false;
+        m_done_cond.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,456 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <StripBoard.h>
+#include <BitBoard.h>
+#include <ConwayEngine.h>
+#include <LifeKernel.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <vector>
+#include <fcntl.h>
+#include <memory.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CACHE_LINE 64 // bytes; every atomic gets a line of its own, so strips never false-share
+
+namespace vt {
+
+struct strip_control_t
+{
+    std::atomic<uint64_t> command_seq; // bumped after command and generations are written
+    uint32_t              command;
+    long                  generations;
+};
+
+struct strip_worker_t
+{
+    std::atomic<uint64_t> done_seq; // the last command finished
+    double                compute_time;
+    double                halo_time;
+    uint64_t              halo_bytes;
+};
+
+static size_t round_up(size_t size)
+{
+    return (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
+
+// spin, then yield, then sleep: boundary rows usually arrive within microseconds, commands can take seconds
+static void backoff(int attempt)
+{
+    if(attempt < 64) {
+        return;
+    }
+    if(attempt < 1024) {
+        sched_yield();
+        return;
+    }
+    struct timespec delay = {0, 20000}; // 20us
+    nanosleep(&delay, NULL);
+}
+
+//==================
+// halo rings
+//==================
+
+// NOTE: a ring is a consumed counter on its own line, then STRIP_BOARD_RING_DEPTH slots, each a sequence number on
+//       its own line followed by one row; generation g's row goes to slot g % depth and is published by storing g as
+//       the slot's sequence number, and a slot is only reused once its reader has consumed the generation before
+
+static size_t get_slot_size(int words)
+{
+    return CACHE_LINE + round_up(words * sizeof(uint64_t));
+}
+
+static size_t get_ring_size(int words)
+{
+    return CACHE_LINE + STRIP_BOARD_RING_DEPTH * get_slot_size(words);
+}
+
+static std::atomic<uint64_t>* get_consumed(uint8_t* ring)
+{
+    return reinterpret_cast<std::atomic<uint64_t>*>(ring);
+}
+
+static uint8_t* get_slot(uint8_t* ring, int words, uint64_t sequence)
+{
+    return ring + CACHE_LINE + (sequence % STRIP_BOARD_RING_DEPTH) * get_slot_size(words);
+}
+
+static void init_ring(uint8_t* ring, int words)
+{
+    new(get_consumed(ring)) std::atomic<uint64_t>(0);
+    for(int i = 0; i < STRIP_BOARD_RING_DEPTH; i++) {
+        new(get_slot(ring, words, i)) std::atomic<uint64_t>(0);
+    }
+}
+
+static void push_row(uint8_t* ring, int words, uint64_t sequence, const uint64_t* row)
+{
+    uint8_t* slot = get_slot(ring, words, sequence);
+    for(int i = 0; sequence > STRIP_BOARD_RING_DEPTH &&
+                   get_consumed(ring)->load(std::memory_order_acquire) < sequence - STRIP_BOARD_RING_DEPTH; i++) {
+        backoff(i);
+    }
+    memcpy(slot + CACHE_LINE, row, words * sizeof(uint64_t));
+    reinterpret_cast<std::atomic<uint64_t>*>(slot)->store(sequence, std::memory_order_release);
+}
+
+static void pull_row(uint8_t* ring, int words, uint64_t sequence, uint64_t* row)
+{
+    uint8_t* slot = get_slot(ring, words, sequence);
+    for(int i = 0; reinterpret_cast<std::atomic<uint64_t>*>(slot)->load(std::memory_order_acquire) != sequence; i++) {
+        backoff(i);
+    }
+    memcpy(row, slot + CACHE_LINE, words * sizeof(uint64_t));
+    get_consumed(ring)->store(sequence, std::memory_order_release);
+}
+
+//==================
+// strip board
+//==================
+
+// NOTE: the segment is unlinked as soon as it is mapped; the workers inherit the mapping across fork, so nothing
+//       is left behind in /dev/shm however the processes end
+StripBoard::StripBoard(glm::ivec2 dim, int process_count)
+    : m_dim(dim),
+      m_process_count(std::max(1, std::min(process_count, dim.y))),
+      m_words_per_row((dim.x + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS),
+      m_rule(LIFE_RULE_CONWAY),
+      m_kernel_type(life_kernel_best()),
+      m_skip_stable_tiles(true),
+      m_cursor_pos(-1),
+      m_segment(NULL),
+      m_segment_size(0),
+      m_ring_size(get_ring_size(m_words_per_row)),
+      m_control(NULL),
+      m_workers(NULL),
+      m_cells(NULL),
+      m_grow_cells(NULL),
+      m_failed(false),
+      m_generation(0),
+      m_elapsed_time(0)
+{
+    static_assert(sizeof(strip_control_t) <= CACHE_LINE && sizeof(strip_worker_t) <= CACHE_LINE,
+                  "strip_control_t and strip_worker_t must fit in a cache line");
+    size_t plane_size = round_up(static_cast<size_t>(m_words_per_row) * dim.y * sizeof(uint64_t));
+    m_segment_size = CACHE_LINE * (1 + m_process_count) + 2 * m_process_count * m_ring_size + 2 * plane_size;
+    char name[64];
+    snprintf(name, sizeof(name), "/vt_strip_board_%d_%p", static_cast<int>(getpid()), static_cast<void*>(this));
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd < 0) {
+        return;
+    }
+    shm_unlink(name);
+    void* segment = MAP_FAILED;
+    if(!ftruncate(fd, m_segment_size)) {
+        segment = mmap(NULL, m_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(segment == MAP_FAILED) {
+        return;
+    }
+    m_segment = reinterpret_cast<uint8_t*>(segment);
+    m_control = new(m_segment) strip_control_t();
+    m_control->command_seq.store(0);
+    m_workers = reinterpret_cast<strip_worker_t*>(m_segment + CACHE_LINE);
+    for(int i = 0; i < m_process_count; i++) {
+        strip_worker_t* worker = new(m_segment + CACHE_LINE * (1 + i)) strip_worker_t();
+        worker->done_seq.store(0);
+        worker->compute_time = 0;
+        worker->halo_time    = 0;
+        worker->halo_bytes   = 0;
+    }
+    for(int i = 0; i < 2 * m_process_count; i++) {
+        init_ring(get_ring(i / 2, i % 2), m_words_per_row);
+    }
+    m_cells      = reinterpret_cast<uint64_t*>(m_segment + CACHE_LINE * (1 + m_process_count) + 2 * m_process_count * m_ring_size);
+    m_grow_cells = reinterpret_cast<uint64_t*>(reinterpret_cast<uint8_t*>(m_cells) + plane_size);
+}
+
+StripBoard::~StripBoard()
+{
+    if(!m_pids.empty() && !run_command(COMMAND_QUIT)) {
+        for(size_t i = 0; i < m_pids.size(); i++) {
+            kill(m_pids[i], SIGKILL);
+        }
+    }
+    for(size_t i = 0; i < m_pids.size(); i++) {
+        waitpid(m_pids[i], NULL, 0);
+    }
+    if(m_segment) {
+        munmap(m_segment, m_segment_size);
+    }
+}
+
+double StripBoard::get_generations_per_sec() const
+{
+    return m_elapsed_time ? m_generation / m_elapsed_time : 0;
+}
+
+size_t StripBoard::get_population()
+{
+    if(!run_command(COMMAND_STORE)) {
+        return 0;
+    }
+    size_t population = 0;
+    size_t n = static_cast<size_t>(m_words_per_row) * m_dim.y;
+    for(size_t i = 0; i < n; i++) {
+        population += __builtin_popcountll(m_cells[i]);
+    }
+    return population;
+}
+
+double StripBoard::get_compute_time(int process_index) const
+{
+    return m_workers[process_index].compute_time;
+}
+
+double StripBoard::get_halo_time(int process_index) const
+{
+    return m_workers[process_index].halo_time;
+}
+
+uint64_t StripBoard::get_halo_bytes() const
+{
+    uint64_t halo_bytes = 0;
+    for(int i = 0; i < m_process_count; i++) {
+        halo_bytes += m_workers[i].halo_bytes;
+    }
+    return halo_bytes;
+}
+
+bool StripBoard::start()
+{
+    if(!is_open() || !m_pids.empty()) {
+        return false;
+    }
+    for(int i = 0; i < m_process_count; i++) {
+        pid_t pid = fork();
+        if(pid < 0) {
+            m_failed = true;
+            break;
+        }
+        if(!pid) {
+            run_worker(i);
+            _exit(0); // no atexit handlers or destructors of the parent's objects
+        }
+        m_pids.push_back(pid);
+    }
+    return !m_failed;
+}
+
+//==================
+// texture interop
+//==================
+
+bool StripBoard::load_r32f(const float* pixels)
+{
+    if(!is_open()) {
+        return false;
+    }
+    memset(m_cells,      0, sizeof(uint64_t) * m_words_per_row * m_dim.y);
+    memset(m_grow_cells, 0, sizeof(uint64_t) * m_words_per_row * m_dim.y);
+    for(int y = 0; y < m_dim.y; y++) {
+        const float* src      = &pixels[y * m_dim.x];
+        uint64_t*    row      = &m_cells[y * m_words_per_row];
+        uint64_t*    grow_row = &m_grow_cells[y * m_words_per_row];
+        for(int x = 0; x < m_dim.x; x++) {
+            if(src[x] == CONWAY_DIE_COLOR) {
+                continue;
+            }
+            uint64_t bit = 1ULL << (x % BITBOARD_WORD_BITS);
+            row[x / BITBOARD_WORD_BITS] |= bit;
+            if(src[x] == CONWAY_GROW_COLOR) {
+                grow_row[x / BITBOARD_WORD_BITS] |= bit;
+            }
+        }
+    }
+    return run_command(COMMAND_LOAD);
+}
+
+bool StripBoard::store_r32f(float* pixels)
+{
+    if(!run_command(COMMAND_STORE)) {
+        return false;
+    }
+    for(int y = 0; y < m_dim.y; y++) {
+        const uint64_t* row      = &m_cells[y * m_words_per_row];
+        const uint64_t* grow_row = &m_grow_cells[y * m_words_per_row];
+        float*          dest     = &pixels[y * m_dim.x];
+        for(int x = 0; x < m_dim.x; x++) {
+            int shift = x % BITBOARD_WORD_BITS;
+            if(!((row[x / BITBOARD_WORD_BITS] >> shift) & 1)) {
+                dest[x] = CONWAY_DIE_COLOR;
+                continue;
+            }
+            dest[x] = ((grow_row[x / BITBOARD_WORD_BITS] >> shift) & 1) ? CONWAY_GROW_COLOR : CONWAY_LIVE_COLOR;
+        }
+    }
+    return true;
+}
+
+//===================
+// core functionality
+//===================
+
+bool StripBoard::step(int iters)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    bool result = run_command(COMMAND_STEP, iters);
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    m_elapsed_time += delta_time.count();
+    if(result) {
+        m_generation += iters;
+    }
+    return result;
+}
+
+// NOTE: the workers are idle between commands, so their counters can be cleared from here
+void StripBoard::reset_stats()
+{
+    m_generation   = 0;
+    m_elapsed_time = 0;
+    for(int i = 0; i < m_process_count; i++) {
+        m_workers[i].compute_time = 0;
+        m_workers[i].halo_time    = 0;
+        m_workers[i].halo_bytes   = 0;
+    }
+}
+
+uint8_t* StripBoard::get_ring(int process_index, bool up) const
+{
+    return m_segment + CACHE_LINE * (1 + m_process_count) + (2 * process_index + up) * m_ring_size;
+}
+
+// NOTE: a worker that dies leaves its neighbors (and so the parent) waiting forever, so the wait checks on all of them
+bool StripBoard::run_command(command_t command, long generations)
+{
+    if(!is_open() || m_failed || m_pids.empty()) {
+        return false;
+    }
+    m_control->command     = command;
+    m_control->generations = generations;
+    uint64_t command_seq = m_control->command_seq.load(std::memory_order_relaxed) + 1;
+    m_control->command_seq.store(command_seq, std::memory_order_release);
+    for(int i = 0; i < m_process_count; i++) {
+        for(int j = 0; m_workers[i].done_seq.load(std::memory_order_acquire) < command_seq; j++) {
+            backoff(j);
+            if(command == COMMAND_QUIT || j % 1024 != 1023) {
+                continue;
+            }
+            for(size_t k = 0; k < m_pids.size(); k++) {
+                if(waitpid(m_pids[k], NULL, WNOHANG)) {
+                    fprintf(stderr, "Error: strip worker %d (pid %d) died\n", static_cast<int>(k), static_cast<int>(m_pids[k]));
+                    m_pids.erase(m_pids.begin() + k);
+                    m_failed = true;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// NOTE: every generation pushes this strip's bottom and top rows down and up, then pulls the neighbors' rows into
+//       the guard rows; off the board the halo stays dead
+void StripBoard::run_worker(int process_index)
+{
+    int row_begin = get_row_begin(process_index);
+    int rows      = get_row_begin(process_index + 1) - row_begin;
+    int words     = m_words_per_row;
+    BitBoard board(glm::ivec2(m_dim.x, rows));
+    board.set_rule(m_rule);
+    board.set_kernel_type(m_kernel_type);
+    board.set_skip_stable_tiles(m_skip_stable_tiles);
+    board.set_cursor_pos((m_cursor_pos.y >= row_begin && m_cursor_pos.y < row_begin + rows) ?
+                         m_cursor_pos - glm::ivec2(0, row_begin) : glm::ivec2(-1));
+    strip_worker_t* worker = &m_workers[process_index];
+    uint8_t* up_ring    = (process_index < m_process_count - 1) ? get_ring(process_index, true) : NULL;
+    uint8_t* down_ring  = (process_index > 0) ? get_ring(process_index, false) : NULL;
+    uint8_t* above_ring = up_ring ? get_ring(process_index + 1, false) : NULL; // the strip above pushes down
+    uint8_t* below_ring = down_ring ? get_ring(process_index - 1, true) : NULL;
+    std::vector<uint64_t> above(words);
+    std::vector<uint64_t> below(words);
+    uint64_t command_seq = 0;
+    uint64_t sequence    = 0; // generations stepped, numbering the boundary rows
+    for(;;) {
+        for(int i = 0; m_control->command_seq.load(std::memory_order_acquire) == command_seq; i++) {
+            backoff(i);
+        }
+        command_seq++;
+        switch(m_control->command) {
+            case COMMAND_LOAD:
+                board.clear();
+                for(int r = 0; r < rows; r++) {
+                    memcpy(board.get_row(r),      &m_cells[(row_begin + r) * words],      words * sizeof(uint64_t));
+                    memcpy(board.get_grow_row(r), &m_grow_cells[(row_begin + r) * words], words * sizeof(uint64_t));
+                }
+                break;
+            case COMMAND_STORE:
+                for(int r = 0; r < rows; r++) {
+                    memcpy(&m_cells[(row_begin + r) * words],      board.get_row(r),      words * sizeof(uint64_t));
+                    memcpy(&m_grow_cells[(row_begin + r) * words], board.get_grow_row(r), words * sizeof(uint64_t));
+                }
+                break;
+            case COMMAND_STEP:
+                for(long g = 0; g < m_control->generations; g++) {
+                    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+                    sequence++;
+                    if(down_ring) {
+                        push_row(down_ring, words, sequence, board.get_row(0));
+                    }
+                    if(up_ring) {
+                        push_row(up_ring, words, sequence, board.get_row(rows - 1));
+                    }
+                    if(below_ring) {
+                        pull_row(below_ring, words, sequence, &below[0]);
+                    }
+                    if(above_ring) {
+                        pull_row(above_ring, words, sequence, &above[0]);
+                    }
+                    board.set_guard_rows(above_ring ? &above[0] : NULL, below_ring ? &below[0] : NULL);
+                    std::chrono::steady_clock::time_point halo_time = std::chrono::steady_clock::now();
+                    board.step(1);
+                    std::chrono::duration<double> delta_halo_time    = halo_time - start_time;
+                    std::chrono::duration<double> delta_compute_time = std::chrono::steady_clock::now() - halo_time;
+                    worker->halo_time    += delta_halo_time.count();
+                    worker->compute_time += delta_compute_time.count();
+                    worker->halo_bytes   += ((down_ring != NULL) + (up_ring != NULL)) * words * sizeof(uint64_t);
+                }
+                break;
+            case COMMAND_QUIT:
+                worker->done_seq.store(command_seq, std::memory_order_release);
+                return;
+        }
+        worker->done_seq.store(command_seq, std::memory_order_release);
+    }
+}
+
+}
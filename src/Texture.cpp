@@ -330,10 +330,12 @@ size_t Texture::size() const
         return m_dim.x * m_dim.y * sizeof(unsigned char) * 4; // per cube face
     }
     switch(m_internal_format) {
-        case Texture::RGBA:  return m_dim.x * m_dim.y * sizeof(unsigned char) * 4;
-        case Texture::RGB:   assert(false); break;
-        case Texture::RED:   return m_dim.x * m_dim.y * sizeof(unsigned char) * 4;
-        case Texture::DEPTH: return m_dim.x * m_dim.y * sizeof(float);
+        case Texture::RGBA:    return m_dim.x * m_dim.y * sizeof(unsigned char) * 4;
+        case Texture::RGB:     assert(false); break;
+        case Texture::RED:     return m_dim.x * m_dim.y * sizeof(unsigned char) * 4;
+        case Texture::DEPTH:   return m_dim.x * m_dim.y * sizeof(float);
+        case Texture::R8:      return m_dim.x * m_dim.y * sizeof(unsigned char);
+        case Texture::RGBA32F: return m_dim.x * m_dim.y * sizeof(float) * 4;
         default:
             break;
     }
@@ -386,6 +388,23 @@ void Texture::randomize(bool binary)
                 }
             }
             break;
+        case Texture::R8:
+            {
+                size_t n = m_dim.x * m_dim.y;
+                for(int i = 0; i < static_cast<int>(n); i++) {
+                    m_pixels[i] = (static_cast<float>(rand()) / RAND_MAX) > 0.5;
+                }
+            }
+            break;
+        case Texture::RGBA32F:
+            {
+                float* pixels = reinterpret_cast<float*>(m_pixels);
+                size_t n = m_dim.x * m_dim.y * 4;
+                for(int i = 0; i < static_cast<int>(n); i++) {
+                    pixels[i] = static_cast<float>(rand()) / RAND_MAX;
+                }
+            }
+            break;
         default:
             assert(false);
             break;
@@ -425,6 +444,18 @@ void Texture::draw_x()
                 }
             }
             break;
+        case Texture::R8:
+            {
+                size_t min_dim = std::min(m_dim.x, m_dim.y);
+                for(int i = 0; i < static_cast<int>(min_dim); i++) {
+                    m_pixels[i * m_dim.x + i]                 = 1;
+                    m_pixels[i * m_dim.x + (m_dim.x - 1 - i)] = 1;
+                }
+            }
+            break;
+        case Texture::RGBA32F:
+            memset(m_pixels, 0, size()); // NOTE: float state (e.g. sprites in main_maze) has no test pattern
+            break;
         default:
             assert(false);
             break;
@@ -478,6 +509,21 @@ void Texture::draw_frame()
                 }
             }
             break;
+        case Texture::R8:
+            {
+                for(int x = 0; x < m_dim.x; x++) {
+                    m_pixels[0             * m_dim.x + x] = 1;
+                    m_pixels[(m_dim.y - 1) * m_dim.x + x] = 1;
+                }
+                for(int y = 1; y < m_dim.y - 1; y++) {
+                    m_pixels[y * m_dim.x + 0]             = 1;
+                    m_pixels[y * m_dim.x + (m_dim.x - 1)] = 1;
+                }
+            }
+            break;
+        case Texture::RGBA32F:
+            memset(m_pixels, 0, size()); // NOTE: float state (e.g. sprites in main_maze) has no test pattern
+            break;
         default:
             assert(false);
             break;
@@ -584,6 +630,96 @@ void Texture::set_color_r32f(float color)
     }
 }
 
+//==========================
+// basic modifiers -- r8 only
+//==========================
+
+unsigned char Texture::get_pixel_r8(glm::ivec2 pos) const
+{
+    if(!m_pixels) {
+        return 0;
+    }
+    return m_pixels[pos.y * m_dim.x + pos.x];
+}
+
+void Texture::set_pixel_r8(glm::ivec2 pos, unsigned char color)
+{
+    if(!m_pixels) {
+        return;
+    }
+    m_pixels[pos.y * m_dim.x + pos.x] = color;
+}
+
+void Texture::set_color_r8(unsigned char color)
+{
+    if(m_skybox) {
+        return;
+    }
+    if(!m_pixels) {
+        return;
+    }
+    switch(m_internal_format) {
+        case Texture::R8:
+            memset(m_pixels, color, size());
+            break;
+        default:
+            assert(false);
+            break;
+    }
+}
+
+//===============================
+// basic modifiers -- rgba32f only
+//===============================
+
+glm::vec4 Texture::get_pixel_rgba32f(glm::ivec2 pos) const
+{
+    if(!m_pixels) {
+        return glm::vec4(0);
+    }
+    const float* pixel = reinterpret_cast<const float*>(m_pixels) + (pos.y * m_dim.x + pos.x) * 4;
+    return glm::vec4(pixel[0], pixel[1], pixel[2], pixel[3]);
+}
+
+void Texture::set_pixel_rgba32f(glm::ivec2 pos, glm::vec4 color)
+{
+    if(!m_pixels) {
+        return;
+    }
+    float* pixel = reinterpret_cast<float*>(m_pixels) + (pos.y * m_dim.x + pos.x) * 4;
+    pixel[0] = color.r;
+    pixel[1] = color.g;
+    pixel[2] = color.b;
+    pixel[3] = color.a;
+}
+
+void Texture::set_color_rgba32f(glm::vec4 color)
+{
+    if(m_skybox) {
+        return;
+    }
+    if(!m_pixels) {
+        return;
+    }
+    switch(m_internal_format) {
+        case Texture::RGBA32F:
+            {
+                float* pixels = reinterpret_cast<float*>(m_pixels);
+                size_t n = m_dim.x * m_dim.y;
+                for(int i = 0; i < static_cast<int>(n); i++) {
+                    pixels[i * 4 + 0] = color.r;
+                    pixels[i * 4 + 1] = color.g;
+                    pixels[i * 4 + 2] = color.b;
+                    pixels[i * 4 + 3] = color.a;
+                }
+            }
+            break;
+        default:
+            assert(false);
+            break;
+    }
+}
+
 //===================
 // core functionality
 //===================
@@ -702,6 +838,30 @@ void Texture::update()
                          GL_FLOAT,           // type
                          m_pixels);
             break;
+        case Texture::R8:
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows are not padded to 4 bytes
+            glTexImage2D(GL_TEXTURE_2D,    // target
+                         0,                // level, 0 = base, no mipmap,
+                         GL_R8,            // internal format
+                         m_dim.x,          // width
+                         m_dim.y,          // height
+                         0,                // border, always 0 in OpenGL ES
+                         GL_RED,           // format
+                         GL_UNSIGNED_BYTE, // type
+                         m_pixels);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            break;
+        case Texture::RGBA32F:
+            glTexImage2D(GL_TEXTURE_2D, // target
+                         0,             // level, 0 = base, no mipmap,
+                         GL_RGBA32F,    // internal format
+                         m_dim.x,       // width
+                         m_dim.y,       // height
+                         0,             // border, always 0 in OpenGL ES
+                         GL_RGBA,       // format
+                         GL_FLOAT,      // type
+                         m_pixels);
+            break;
         default:
             break;
     }
@@ -781,9 +941,45 @@ void Texture::refresh()
                           GL_FLOAT,           // type
                           m_pixels);
             break;
+        case Texture::R8:
+            glPixelStorei(GL_PACK_ALIGNMENT, 1); // rows are not padded to 4 bytes
+            glGetTexImage(GL_TEXTURE_2D,    // target
+                          0,                // level, 0 = base, no mipmap,
+                          GL_RED,           // format
+                          GL_UNSIGNED_BYTE, // type
+                          m_pixels);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            break;
+        case Texture::RGBA32F:
+            glGetTexImage(GL_TEXTURE_2D, // target
+                          0,             // level, 0 = base, no mipmap,
+                          GL_RGBA,       // format
+                          GL_FLOAT,      // type
+                          m_pixels);
+            break;
         default:
             break;
     }
 }
 
+// NOTE: a zero border reads as a dead cell in every cell encoding (DIE_COLOR, GENERATIONS_DEAD, EMPTY_COLOR)
+void Texture::set_boundary_mode(boundary_mode_t boundary_mode)
+{
+    if(!m_id || m_skybox) {
+        return;
+    }
+    GLint wrap_mode = GL_CLAMP_TO_BORDER;
+    switch(boundary_mode) {
+        case BOUNDARY_TORUS:  wrap_mode = GL_REPEAT;          break;
+        case BOUNDARY_MIRROR: wrap_mode = GL_MIRRORED_REPEAT; break;
+        default:
+            break;
+    }
+    static const GLfloat border_color[4] = {0, 0, 0, 0};
+    glBindTexture(GL_TEXTURE_2D, m_id);
+    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, border_color);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_mode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_mode);
+}
+
 }
@@ -0,0 +1,171 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <ThreadPool.h>
+#include <algorithm>
+#include <chrono>
+
+namespace vt {
+
+ThreadPool::ThreadPool(int thread_count)
+    : m_func(NULL),
+      m_epoch(0),
+      m_busy_workers(0),
+      m_quit(false)
+{
+    if(thread_count <= 0) {
+        thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for(int i = 0; i < thread_count; i++) {
+        m_workers.push_back(new Worker());
+    }
+    reset_stats();
+    for(int j = 0; j < thread_count; j++) {
+        m_workers[j]->m_thread = std::thread(&ThreadPool::worker_main, this, j);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start_cond.notify_all();
+    for(std::vector<Worker*>::iterator p = m_workers.begin(); p != m_workers.end(); ++p) {
+        (*p)->m_thread.join();
+        delete *p;
+    }
+}
+
+double ThreadPool::get_imbalance() const
+{
+    double max_busy_time = 0;
+    double sum_busy_time = 0;
+    for(std::vector<Worker*>::const_iterator p = m_workers.begin(); p != m_workers.end(); ++p) {
+        max_busy_time  = std::max(max_busy_time, (*p)->m_stats.busy_time);
+        sum_busy_time += (*p)->m_stats.busy_time;
+    }
+    if(sum_busy_time <= 0) {
+        return 1;
+    }
+    return max_busy_time / (sum_busy_time / m_workers.size());
+}
+
+void ThreadPool::reset_stats()
+{
+    for(std::vector<Worker*>::iterator p = m_workers.begin(); p != m_workers.end(); ++p) {
+        (*p)->m_stats.busy_time = 0;
+        (*p)->m_stats.tasks     = 0;
+        (*p)->m_stats.steals    = 0;
+    }
+}
+
+void ThreadPool::parallel_for(int task_count, const task_func_t& func)
+{
+    if(task_count <= 0) {
+        return;
+    }
+
+    // contiguous chunk per thread
+    int thread_count = get_thread_count();
+    for(int i = 0; i < thread_count; i++) {
+        int begin = static_cast<long>(task_count) * i       / thread_count;
+        int end   = static_cast<long>(task_count) * (i + 1) / thread_count;
+        std::unique_lock<std::mutex> lock(m_workers[i]->m_mutex);
+        for(int j = begin; j < end; j++) {
+            m_workers[i]->m_tasks.push_back(j);
+        }
+    }
+
+    // start batch, then wait for every worker to run dry (barrier)
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_func         = &func;
+    m_busy_workers = thread_count;
+    m_epoch++;
+    m_start_cond.notify_all();
+    m_done_cond.wait(lock, [this] { return m_busy_workers == 0; });
+    m_func = NULL;
+}
+
+void ThreadPool::worker_main(int thread_index)
+{
+    Worker* worker = m_workers[thread_index];
+    long epoch = 0;
+    for(;;) {
+        const task_func_t* func = NULL;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_cond.wait(lock, [this, epoch] { return m_quit || m_epoch != epoch; });
+            if(m_quit) {
+                return;
+            }
+            epoch = m_epoch;
+            func  = m_func;
+        }
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        int  task_index = 0;
+        bool stolen     = false;
+        while(pop_task(thread_index, &task_index, &stolen)) {
+            (*func)(task_index, thread_index);
+            worker->m_stats.tasks++;
+            if(stolen) {
+                worker->m_stats.steals++;
+            }
+        }
+        std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+        worker->m_stats.busy_time += delta_time.count();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if(--m_busy_workers == 0) {
+                m_done_cond.notify_one();
+            }
+        }
+    }
+}
+
+bool ThreadPool::pop_task(int thread_index, int* task_index, bool* stolen)
+{
+    // own queue first (front)
+    {
+        Worker* worker = m_workers[thread_index];
+        std::unique_lock<std::mutex> lock(worker->m_mutex);
+        if(!worker->m_tasks.empty()) {
+            *task_index = worker->m_tasks.front();
+            worker->m_tasks.pop_front();
+            *stolen = false;
+            return true;
+        }
+    }
+
+    // steal from other queues (back)
+    int thread_count = get_thread_count();
+    for(int i = 1; i < thread_count; i++) {
+        Worker* victim = m_workers[(thread_index + i) % thread_count];
+        std::unique_lock<std::mutex> lock(victim->m_mutex);
+        if(!victim->m_tasks.empty()) {
+            *task_index = victim->m_tasks.back();
+            victim->m_tasks.pop_back();
+            *stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
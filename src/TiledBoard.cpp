@@ -0,0 +1,441 @@
+// This file is part of dexvt-lite.
+// -- 3D Inverse Kinematics (Cyclic Coordinate Descent) with Constraints
+// Copyright (C) 2018 onlyuser <mailto:onlyuser@gmail.com>
+//
+// dexvt-lite is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// dexvt-lite is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with dexvt-lite.  If not, see <http://www.gnu.org/licenses/>.
+
+
+
+#include <TiledBoard.h>
+#include <BitBoard.h>
+#include <ConwayEngine.h>
+#include <LifeKernel.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <memory.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace vt {
+
+TiledBoard::TiledBoard(glm::ivec2 dim, const std::string& filename, size_t cache_tiles)
+    : m_dim(dim),
+      m_tile_dim((dim.x + TILED_BOARD_TILE_DIM - 1) / TILED_BOARD_TILE_DIM,
+                 (dim.y + TILED_BOARD_TILE_DIM - 1) / TILED_BOARD_TILE_DIM),
+      m_filename(filename),
+      m_fd(-1),
+      m_map(NULL),
+      m_map_size(0),
+      m_buffer(0),
+      m_kernel_type(life_kernel_best()),
+      m_kernel(get_life_kernel(m_kernel_type)),
+      m_rule(LIFE_RULE_CONWAY),
+      m_lru_head(-1),
+      m_lru_tail(-1),
+      m_resident_count(0),
+      m_cache_tiles(std::max(cache_tiles, static_cast<size_t>(1))),
+      m_page_ins(0),
+      m_evictions(0),
+      m_tiles_stepped(0),
+      m_generation(0),
+      m_elapsed_time(0)
+{
+    m_occupied.resize(get_tile_count(), 0);
+    m_occupied2.resize(get_tile_count(), 0);
+    m_lru_prev.resize(get_tile_count(), -1);
+    m_lru_next.resize(get_tile_count(), -1);
+    m_resident.resize(get_tile_count(), 0);
+    m_scratch.resize((TILED_BOARD_TILE_DIM + 2) * (TILED_BOARD_TILE_WORDS + 2), 0);
+    m_scratch_out.resize(TILED_BOARD_TILE_SIZE, 0);
+    m_scratch_grow.resize(TILED_BOARD_TILE_WORDS, 0);
+
+    // NOTE: sparse file; blocks are only allocated for tiles that are written
+    m_map_size = static_cast<size_t>(get_tile_count()) * 2 * TILED_BOARD_TILE_SIZE * sizeof(uint64_t);
+    m_fd = open(m_filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(m_fd < 0) {
+        return;
+    }
+    if(ftruncate(m_fd, m_map_size) < 0) {
+        return;
+    }
+    void* map = mmap(NULL, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if(map == MAP_FAILED) {
+        return;
+    }
+    m_map = reinterpret_cast<uint64_t*>(map);
+}
+
+TiledBoard::~TiledBoard()
+{
+    if(m_map) {
+        munmap(m_map, m_map_size);
+    }
+    if(m_fd >= 0) {
+        close(m_fd);
+        unlink(m_filename.c_str());
+    }
+}
+
+double TiledBoard::get_generations_per_sec() const
+{
+    if(m_elapsed_time <= 0) {
+        return 0;
+    }
+    return m_generation / m_elapsed_time;
+}
+
+size_t TiledBoard::get_population()
+{
+    size_t population = 0;
+    for(int i = 0; i < get_tile_count(); i++) {
+        if(!m_occupied[i]) {
+            continue;
+        }
+        touch_tile(i);
+        const uint64_t* tile = get_tile(i, m_buffer);
+        for(int j = 0; j < TILED_BOARD_TILE_SIZE; j++) {
+            population += __builtin_popcountll(tile[j]);
+        }
+    }
+    return population;
+}
+
+size_t TiledBoard::get_occupied_tile_count() const
+{
+    return std::count(m_occupied.begin(), m_occupied.end(), 1);
+}
+
+bool TiledBoard::set_kernel_type(life_kernel_type_t kernel_type)
+{
+    life_kernel_t kernel = get_life_kernel(kernel_type, m_rule);
+    if(!kernel) {
+        return false;
+    }
+    m_kernel_type = kernel_type;
+    m_kernel      = kernel;
+    return true;
+}
+
+bool TiledBoard::set_rule(life_rule_t rule)
+{
+    if(get_life_rule_birth(rule) & 1) {
+        return false;
+    }
+    m_rule   = rule;
+    m_kernel = get_life_kernel(m_kernel_type, m_rule);
+    return true;
+}
+
+void TiledBoard::set_cache_tiles(size_t cache_tiles)
+{
+    m_cache_tiles = std::max(cache_tiles, static_cast<size_t>(1));
+    while(m_resident_count > m_cache_tiles) {
+        evict_tile();
+    }
+}
+
+//================
+// basic modifiers
+//================
+
+bool TiledBoard::get_cell(glm::ivec2 pos)
+{
+    int tile_index = (pos.y / TILED_BOARD_TILE_DIM) * m_tile_dim.x + pos.x / TILED_BOARD_TILE_DIM;
+    if(!m_occupied[tile_index]) {
+        return false;
+    }
+    touch_tile(tile_index);
+    int x = pos.x % TILED_BOARD_TILE_DIM;
+    int y = pos.y % TILED_BOARD_TILE_DIM;
+    return (get_tile(tile_index, m_buffer)[y * TILED_BOARD_TILE_WORDS + x / BITBOARD_WORD_BITS] >> (x % BITBOARD_WORD_BITS)) & 1;
+}
+
+// NOTE: an unoccupied tile may hold stale cells from an earlier generation, so it is cleared before first use
+void TiledBoard::set_cell(glm::ivec2 pos, bool alive)
+{
+    int tile_index = (pos.y / TILED_BOARD_TILE_DIM) * m_tile_dim.x + pos.x / TILED_BOARD_TILE_DIM;
+    if(!m_occupied[tile_index] && !alive) {
+        return;
+    }
+    touch_tile(tile_index);
+    uint64_t* tile = get_tile(tile_index, m_buffer);
+    if(!m_occupied[tile_index]) {
+        memset(tile, 0, sizeof(uint64_t) * TILED_BOARD_TILE_SIZE);
+        m_occupied[tile_index] = 1;
+    }
+    int x = pos.x % TILED_BOARD_TILE_DIM;
+    int y = pos.y % TILED_BOARD_TILE_DIM;
+    uint64_t  bit  = 1ULL << (x % BITBOARD_WORD_BITS);
+    uint64_t* word = &tile[y * TILED_BOARD_TILE_WORDS + x / BITBOARD_WORD_BITS];
+    if(alive) {
+        *word |= bit;
+    } else {
+        *word &= ~bit;
+    }
+}
+
+void TiledBoard::clear()
+{
+    std::fill(m_occupied.begin(), m_occupied.end(), 0);
+}
+
+void TiledBoard::draw_x()
+{
+    int min_dim = std::min(m_dim.x, m_dim.y);
+    for(int i = 0; i < min_dim; i++) {
+        set_cell(glm::ivec2(i, i), true);
+        set_cell(glm::ivec2(m_dim.x - 1 - i, i), true);
+    }
+}
+
+void TiledBoard::randomize()
+{
+    uint64_t state = (static_cast<uint64_t>(rand()) << 32) ^ rand() ^ 0x9E3779B97F4A7C15ULL;
+    for(int tile_y = 0; tile_y < m_tile_dim.y; tile_y++) {
+        for(int tile_x = 0; tile_x < m_tile_dim.x; tile_x++) {
+            int tile_index = tile_y * m_tile_dim.x + tile_x;
+            int words      = get_tile_words(tile_x);
+            int rows       = get_tile_rows(tile_y);
+            int last_bits  = std::min(m_dim.x - (tile_x * TILED_BOARD_TILE_WORDS + words - 1) * BITBOARD_WORD_BITS, BITBOARD_WORD_BITS);
+            uint64_t last_word_mask = (last_bits == BITBOARD_WORD_BITS) ? ~0ULL : ((1ULL << last_bits) - 1);
+            touch_tile(tile_index);
+            uint64_t* tile = get_tile(tile_index, m_buffer);
+            memset(tile, 0, sizeof(uint64_t) * TILED_BOARD_TILE_SIZE);
+            for(int y = 0; y < rows; y++) {
+                for(int i = 0; i < words; i++) {
+                    state ^= state << 13; // xorshift64
+                    state ^= state >> 7;
+                    state ^= state << 17;
+                    tile[y * TILED_BOARD_TILE_WORDS + i] = (i == words - 1) ? (state & last_word_mask) : state;
+                }
+            }
+            m_occupied[tile_index] = 1;
+        }
+    }
+}
+
+//==================
+// texture interop
+//==================
+
+void TiledBoard::load_r32f(const float* pixels)
+{
+    if(!pixels) {
+        return;
+    }
+    clear();
+    for(int y = 0; y < m_dim.y; y++) {
+        for(int x = 0; x < m_dim.x; x++) {
+            if(pixels[y * m_dim.x + x] > 0) {
+                set_cell(glm::ivec2(x, y), true);
+            }
+        }
+    }
+}
+
+void TiledBoard::store_r32f(float* pixels)
+{
+    if(!pixels) {
+        return;
+    }
+    for(int y = 0; y < m_dim.y; y++) {
+        for(int x = 0; x < m_dim.x; x++) {
+            pixels[y * m_dim.x + x] = get_cell(glm::ivec2(x, y)) ? CONWAY_LIVE_COLOR : CONWAY_DIE_COLOR;
+        }
+    }
+}
+
+//===================
+// core functionality
+//===================
+
+// NOTE: a tile whose 3x3 neighborhood is empty stays empty (no B0), so it is neither stepped nor touched
+void TiledBoard::step(int iters)
+{
+    if(!m_map) {
+        return;
+    }
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    for(int i = 0; i < iters; i++) {
+        for(int tile_y = 0; tile_y < m_tile_dim.y; tile_y++) {
+            for(int tile_x = 0; tile_x < m_tile_dim.x; tile_x++) {
+                bool active = false;
+                for(int y = std::max(tile_y - 1, 0); !active && y <= std::min(tile_y + 1, m_tile_dim.y - 1); y++) {
+                    for(int x = std::max(tile_x - 1, 0); x <= std::min(tile_x + 1, m_tile_dim.x - 1); x++) {
+                        if(m_occupied[y * m_tile_dim.x + x]) {
+                            active = true;
+                            break;
+                        }
+                    }
+                }
+                int tile_index = tile_y * m_tile_dim.x + tile_x;
+                if(active) {
+                    step_tile(tile_index);
+                } else {
+                    m_occupied2[tile_index] = 0;
+                }
+            }
+        }
+        m_occupied.swap(m_occupied2);
+        m_buffer ^= 1; // the elusive ping-pong swap
+        m_generation++;
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    m_elapsed_time += delta_time.count();
+}
+
+void TiledBoard::reset_stats()
+{
+    m_generation    = 0;
+    m_page_ins      = 0;
+    m_evictions     = 0;
+    m_tiles_stepped = 0;
+    m_elapsed_time  = 0;
+}
+
+int TiledBoard::get_tile_words(int tile_x) const
+{
+    int words_per_row = (m_dim.x + BITBOARD_WORD_BITS - 1) / BITBOARD_WORD_BITS;
+    return std::min(TILED_BOARD_TILE_WORDS, words_per_row - tile_x * TILED_BOARD_TILE_WORDS);
+}
+
+int TiledBoard::get_tile_rows(int tile_y) const
+{
+    return std::min(TILED_BOARD_TILE_DIM, m_dim.y - tile_y * TILED_BOARD_TILE_DIM);
+}
+
+void TiledBoard::touch_tile(int tile_index)
+{
+    if(m_resident[tile_index]) {
+        if(tile_index == m_lru_head) {
+            return;
+        }
+        // unlink
+        int prev = m_lru_prev[tile_index];
+        int next = m_lru_next[tile_index];
+        m_lru_next[prev] = next;
+        if(next >= 0) {
+            m_lru_prev[next] = prev;
+        } else {
+            m_lru_tail = prev;
+        }
+    } else {
+        m_resident[tile_index] = 1;
+        m_resident_count++;
+        m_page_ins++;
+    }
+    m_lru_prev[tile_index] = -1;
+    m_lru_next[tile_index] = m_lru_head;
+    if(m_lru_head >= 0) {
+        m_lru_prev[m_lru_head] = tile_index;
+    }
+    m_lru_head = tile_index;
+    if(m_lru_tail < 0) {
+        m_lru_tail = tile_index;
+    }
+    while(m_resident_count > m_cache_tiles) {
+        evict_tile();
+    }
+}
+
+// NOTE: dirty pages of a shared file mapping survive MADV_DONTNEED in the page cache, so nothing is lost
+void TiledBoard::evict_tile()
+{
+    int tile_index = m_lru_tail;
+    if(tile_index < 0) {
+        return;
+    }
+    m_lru_tail = m_lru_prev[tile_index];
+    if(m_lru_tail >= 0) {
+        m_lru_next[m_lru_tail] = -1;
+    } else {
+        m_lru_head = -1;
+    }
+    m_resident[tile_index] = 0;
+    m_resident_count--;
+    m_evictions++;
+    madvise(get_tile(tile_index, 0), sizeof(uint64_t) * TILED_BOARD_TILE_SIZE * 2, MADV_DONTNEED);
+}
+
+// tile plus halo into scratch (empty neighbors read as zero), one kernel pass, and the result is only written
+// back (and the tile only touched) if it holds live cells
+void TiledBoard::step_tile(int tile_index)
+{
+    const int stride = TILED_BOARD_TILE_WORDS + 2;
+    int tile_x = tile_index % m_tile_dim.x;
+    int tile_y = tile_index / m_tile_dim.x;
+    std::fill(m_scratch.begin(), m_scratch.end(), 0);
+    for(int dy = -1; dy <= 1; dy++) {
+        for(int dx = -1; dx <= 1; dx++) {
+            int x = tile_x + dx;
+            int y = tile_y + dy;
+            if(x < 0 || x >= m_tile_dim.x || y < 0 || y >= m_tile_dim.y || !m_occupied[y * m_tile_dim.x + x]) {
+                continue;
+            }
+            int neighbor_index = y * m_tile_dim.x + x;
+            touch_tile(neighbor_index);
+            const uint64_t* src = get_tile(neighbor_index, m_buffer);
+
+            // scratch row r + 1 holds tile row r; scratch word j + 1 holds tile word j
+            int row_begin = (dy < 0) ? TILED_BOARD_TILE_DIM - 1 : 0;
+            int row_end   = (dy > 0) ? 1 : TILED_BOARD_TILE_DIM;
+            int word_begin = (dx < 0) ? TILED_BOARD_TILE_WORDS - 1 : 0;
+            int word_end   = (dx > 0) ? 1 : TILED_BOARD_TILE_WORDS;
+            for(int r = row_begin; r < row_end; r++) {
+                int scratch_r = (dy < 0) ? 0 : (dy > 0) ? TILED_BOARD_TILE_DIM + 1 : r + 1;
+                for(int j = word_begin; j < word_end; j++) {
+                    int scratch_j = (dx < 0) ? 0 : (dx > 0) ? TILED_BOARD_TILE_WORDS + 1 : j + 1;
+                    m_scratch[scratch_r * stride + scratch_j] = src[r * TILED_BOARD_TILE_WORDS + j];
+                }
+            }
+        }
+    }
+
+    int words = get_tile_words(tile_x);
+    int rows  = get_tile_rows(tile_y);
+    int last_bits = m_dim.x - ((tile_x * TILED_BOARD_TILE_WORDS) + words - 1) * BITBOARD_WORD_BITS;
+    uint64_t last_word_mask = (last_bits >= BITBOARD_WORD_BITS) ? ~0ULL : ((1ULL << last_bits) - 1);
+    uint64_t occupied = 0;
+    for(int r = 0; r < rows; r++) {
+        uint64_t* out = &m_scratch_out[r * TILED_BOARD_TILE_WORDS];
+        m_kernel(&m_scratch[(r + 2) * stride + 1],
+                 &m_scratch[(r + 1) * stride + 1],
+                 &m_scratch[r * stride + 1],
+                 out,
+                 &m_scratch_grow[0],
+                 words,
+                 last_word_mask,
+                 m_rule);
+        for(int j = 0; j < words; j++) {
+            occupied |= out[j];
+        }
+    }
+    m_tiles_stepped++;
+    m_occupied2[tile_index] = (occupied != 0);
+    if(!occupied) {
+        return;
+    }
+    touch_tile(tile_index);
+    uint64_t* dest = get_tile(tile_index, m_buffer ^ 1);
+    for(int r = 0; r < TILED_BOARD_TILE_DIM; r++) {
+        for(int j = 0; j < TILED_BOARD_TILE_WORDS; j++) {
+            dest[r * TILED_BOARD_TILE_WORDS + j] = (r < rows && j < words) ? m_scratch_out[r * TILED_BOARD_TILE_WORDS + j] : 0;
+        }
+    }
+}
+
+}
@@ -9,17 +9,44 @@
 #include <GL/glew.h>
 /* Using the GLUT library for the base windowing setup */
 #include <GL/glut.h>
+#include <Boundary.h>
+#include <Buffer.h>
 #include <Camera.h>
+#include <ConwayBatch.h>
+#include <ConwayEngine.h>
+#include <CycleDetector.h>
+#include <FilePattern.h>
 #include <FrameBuffer.h>
+#include <FrameGovernor.h>
+#include <GenerationsEngine.h>
+#include <HashLife.h>
+#include <LifeRule.h>
 #include <Material.h>
 #include <Mesh.h>
 #include <PrimitiveFactory.h>
+#include <Recording.h>
 #include <Scene.h>
+#include <Snapshot.h>
 #include <Texture.h>
 #include <sstream> // std::stringstream
 #include <iomanip> // std::setprecision
+#include <iostream> // std::cout
+#include <vector> // std::vector
+#include <algorithm> // std::min
+#include <string> // std::string
+#include <string.h> // strcmp, memcpy
 
 #define HI_RES_TEX_DIM 128
+#define HASHLIFE_STEP_LOG2 10
+#define CONWAY_TILE_DIM 16 // NOTE: must match "src/shaders/overlay_conway_diff.f.glsl"
+#define CONWAY_STATS 6 // NOTE: must match "src/shaders/overlay_conway_reduce.f.glsl"
+#define CONWAY_STATS_LAG 2 // frames between issuing a stats read and mapping it
+#define CONWAY_DIFF_LAG 1 // generations the tile change mask is read back behind the step that uses it
+#define CONWAY_HASH_LAG 2 // generations between issuing a cycle hash read and mapping it
+#define CONWAY_SNAPSHOT_FILE "conway.snap"
+#define CONWAY_RECORDING_FILE "conway.rec"
+#define CONWAY_MAX_STEPS_PER_FRAME 1024
+#define CONWAY_FRAME_BUDGET_MS 12 // of a 16.7 ms frame; the rest is for the display pass and the swap
 
 const char* DEFAULT_CAPTION = "";
 
@@ -28,26 +55,141 @@ int init_screen_width  = 800,
 vt::Camera* camera = NULL;
 vt::Mesh *mesh = NULL;
 vt::Texture *conway_texture  = NULL, // input/output
-            *conway_texture2 = NULL; // input/output
+            *conway_texture2 = NULL, // input/output
+            *conway_diff_texture = NULL, // one texel per tile
+            *conway_population_texture = NULL, // one texel per universe
+            *conway_hash_texture = NULL; // one texel per tile-wide run of a row
 vt::Material *write_through_material  = NULL,
              *conway_color_material = NULL,
-             *conway_material         = NULL;
+             *conway_material         = NULL,
+             *conway_diff_material    = NULL,
+             *conway_population_material = NULL,
+             *conway_hash_material = NULL,
+             *conway_reduce_init_material = NULL,
+             *conway_reduce_material = NULL;
 vt::FrameBuffer *conway_fb  = NULL, // input/output
-                *conway_fb2 = NULL; // input/output
+                *conway_fb2 = NULL, // input/output
+                *conway_diff_fb = NULL, // output
+                *conway_population_fb = NULL, // output
+                *conway_hash_fb = NULL; // output
+vt::ConwayEngine* conway_engine = NULL; // cpu alternative to conway_material
+vt::ConwayBatch* conway_batch = NULL; // cpu alternative to conway_material (universe_count > 1)
+vt::GenerationsEngine* generations_engine = NULL; // cpu alternative to conway_material (conway_states > 2)
+vt::HashLife* hashlife = NULL; // jumps 2^hashlife_step_log2 generations at once
+vt::FrameGovernor* frame_governor = NULL; // generations per frame from measured gpu/cpu time, if use_frame_governor
+int hashlife_step_log2 = HASHLIFE_STEP_LOG2;
+vt::life_rule_t conway_rule = LIFE_RULE_CONWAY;
+int conway_states = 2; // > 2 for "Generations" rules, one byte per cell (Texture::R8)
+int universe_count = 1; // > 1 for independent universes batched into one atlas (see ConwayBatch)
+vt::boundary_mode_t conway_boundary_mode = vt::BOUNDARY_DEAD; // sampler wrap state of the conway textures
+std::string conway_pattern_filename; // RLE, plaintext or Macrocell file instead of the "x" (see FilePattern.h)
+glm::ivec2 conway_dim(HI_RES_TEX_DIM); // whole atlas if batched
+glm::ivec2 conway_tile_dim; // in tiles
+std::vector<float> universe_populations;
+vt::CycleDetector cycle_detector; // stops the animation once the board repeats
+std::vector<uint8_t> conway_cycle_pixels; // board when cycle_detector found a period, compared one period later
+glm::ivec2 conway_cycle_cursor; // cursor then (it seeds a cell every generation)
+long conway_cycle_period = 0; // period to confirm, 0 if none
+long conway_cycle_confirm_generation = -1; // generation to compare the board at, -1 if no period to confirm
+vt::Snapshot conway_snapshot; // reused capture buffer
+vt::SnapshotWriter* snapshot_writer = NULL; // encodes and writes conway_snapshot in the background
+vt::Recorder conway_recorder; // every generation while open
+vt::Snapshot conway_record_frame; // reused capture buffer
+std::vector<uint8_t> conway_record_pixels; // last recorded generation, patched tile by tile from the gpu
+long conway_record_generation = -1; // of the last frame recorded
+std::vector<vt::Texture*> conway_reduce_textures; // successively halved, CONWAY_STATS texels per block
+std::vector<vt::FrameBuffer*> conway_reduce_fbs;
+std::vector<vt::Buffer*> conway_stats_buffers; // pixel pack buffers, a ring of CONWAY_STATS_LAG + 1
+std::vector<long> conway_stats_buffer_generations(CONWAY_STATS_LAG + 1, -1); // -1 if nothing to map
+long conway_stats_reads = 0;
+float conway_stats[CONWAY_STATS] = {0}; // live, changed, -min x, -min y, max x, max y
+long conway_stats_generation = -1; // generation conway_stats describe
+long conway_generation = 0;
+std::vector<char> conway_active_tiles; // re-evaluated in the next generation
+std::vector<vt::Buffer*> conway_diff_buffers; // pixel pack buffers, a ring of CONWAY_DIFF_LAG + 1
+std::vector<char> conway_diff_buffer_valid(CONWAY_DIFF_LAG + 1, 0); // 0 if nothing to map, or read before a reset
+long conway_diff_reads = 0;
+std::vector<glm::ivec2> conway_cursor_tiles(CONWAY_DIFF_LAG + 2, glm::ivec2(-1)); // this generation's first
+std::vector<vt::Buffer*> conway_hash_buffers; // pixel pack buffers, a ring of CONWAY_HASH_LAG + 1
+std::vector<long> conway_hash_buffer_generations(CONWAY_HASH_LAG + 1, -1); // -1 if nothing to map
+std::vector<uint64_t> conway_hash_buffer_seeds(CONWAY_HASH_LAG + 1, 0); // cursor hash at the time of the read
+long conway_hash_reads = 0;
+int conway_active_tile_count = 0;
+int conway_steps_per_frame = 1; // generations per displayed frame, unless use_frame_budget or use_frame_governor
+int conway_frame_steps = 0; // generations in the last frame
 
 bool left_mouse_down  = false,
      right_mouse_down = false;
 glm::vec2 prev_mouse_coord,
           mouse_drag;
 float orbit_radius = 8;
-bool show_fps      = false,
-     do_animation  = true;
+bool show_fps       = false,
+     do_animation   = true,
+     use_cpu_engine = false,
+     skip_stable_tiles = true,
+     stop_on_cycle = true,
+     show_stats = false, // print stats for the last generation of every frame
+     use_frame_budget = false, // as many generations per frame as fit in CONWAY_FRAME_BUDGET_MS
+     use_frame_governor = false, // as many generations per frame as frame_governor allows
+     conway_tiles_dirty = true; // conway_diff_texture is stale, re-evaluate every tile
+
+// universes must not touch through the gutters between them
+void clear_conway_gutters(vt::Texture* texture)
+{
+    for(int y = 0; y < conway_dim.y; y++) {
+        for(int x = 0; x < conway_dim.x; x++) {
+            if(x % (HI_RES_TEX_DIM + 1) == HI_RES_TEX_DIM || y % (HI_RES_TEX_DIM + 1) == HI_RES_TEX_DIM) {
+                texture->set_pixel_r32f(glm::ivec2(x, y), 0);
+            }
+        }
+    }
+}
+
+// forget the hash history, the pending reads and any period waiting to be confirmed (the board changed)
+void reset_conway_cycle_detection()
+{
+    cycle_detector.reset();
+    std::fill(conway_hash_buffer_generations.begin(), conway_hash_buffer_generations.end(), -1);
+    conway_cycle_period             = 0;
+    conway_cycle_confirm_generation = -1;
+}
 
 void init_conway()
 {
     // initial pattern
-    conway_texture->set_color_r32f(0);
-    conway_texture->draw_x();
+    if(conway_states > 2) {
+        conway_texture->set_color_r8(GENERATIONS_DEAD);
+    } else {
+        conway_texture->set_color_r32f(0);
+    }
+    if(universe_count > 1) {
+        conway_texture->randomize(); // a different pattern in every universe
+        clear_conway_gutters(conway_texture);
+    } else if(!conway_pattern_filename.empty()) {
+        // decoded straight into the texture's pixels, centered
+        vt::pattern_info_t pattern_info;
+        bool loaded = (conway_states > 2) ? vt::load_pattern_r8(conway_pattern_filename,
+                                                                conway_texture->get_pixels(),
+                                                                conway_dim,
+                                                                GENERATIONS_ALIVE,
+                                                                &pattern_info)
+                                          : vt::load_pattern_r32f(conway_pattern_filename,
+                                                                  reinterpret_cast<float*>(conway_texture->get_pixels()),
+                                                                  conway_dim,
+                                                                  &pattern_info);
+        if(loaded) {
+            std::cout << "Pattern: " << conway_pattern_filename
+                      << " (" << vt::get_pattern_format_name(pattern_info.format)
+                      << ", " << pattern_info.width << "x" << pattern_info.height
+                      << ", " << pattern_info.population << " cells, "
+                      << pattern_info.elapsed_time << " sec)" << std::endl;
+        } else {
+            std::cout << "Pattern: cannot decode " << conway_pattern_filename << std::endl;
+            conway_texture->draw_x();
+        }
+    } else {
+        conway_texture->draw_x();
+    }
 
     // upload to gpu (very slow)
     conway_texture->update();
@@ -55,6 +197,43 @@ void init_conway()
 
     // reset cursor
     vt::Scene::instance()->set_cursor_pos(glm::ivec2(0, 0));
+
+    conway_tiles_dirty = true;
+    conway_generation = 0;
+    reset_conway_cycle_detection();
+    std::fill(conway_stats_buffer_generations.begin(), conway_stats_buffer_generations.end(), -1);
+    conway_stats_generation = -1;
+}
+
+// template as is for B3/S23, otherwise a copy with the rule baked in as constants; empty string on error
+std::string get_conway_shader(const std::string& template_filename)
+{
+    if(conway_rule == LIFE_RULE_CONWAY && conway_states == 2) {
+        return template_filename;
+    }
+    std::string rule_string = (conway_states > 2) ? vt::get_generations_rule_string(conway_rule, conway_states)
+                                                  : vt::get_life_rule_string(conway_rule);
+    std::replace(rule_string.begin(), rule_string.end(), '/', '_');
+    std::string basename = template_filename.substr(template_filename.rfind('/') + 1);
+    std::string filename = "bin/" + basename.substr(0, basename.find('.')) + "_" + rule_string +
+                           basename.substr(basename.find('.'));
+    if(!vt::write_life_rule_shader(template_filename, filename, conway_rule, conway_states)) {
+        std::cerr << "Error: cannot write " << filename << std::endl;
+        return "";
+    }
+    return filename;
+}
+
+// cpu engine state from a conway texture
+void load_conway_cpu_engine(vt::Texture* texture)
+{
+    if(conway_states > 2) {
+        generations_engine->load_r8(texture->get_pixels());
+    } else if(universe_count > 1) {
+        conway_batch->load_r32f(reinterpret_cast<const float*>(texture->get_pixels()));
+    } else {
+        conway_engine->load(reinterpret_cast<const float*>(texture->get_pixels()));
+    }
 }
 
 int init_resources()
@@ -67,27 +246,107 @@ int init_resources()
 
     glm::vec3 origin = glm::vec3();
     camera = new vt::Camera("camera", origin + glm::vec3(0, 0, orbit_radius), origin);
-    camera->set_image_res(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
+    camera->set_image_res(conway_dim);
     scene->set_camera(camera);
+    scene->set_universe_dim(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
 
     //=========
     // textures
     //=========
 
     // input/output
+    // NOTE: 2-state rules stay on one float per cell: GROW/LIVE/DIE (1, 0.5, 0) is the encoding ConwayEngine,
+    //       snapshots, recordings, the stats/hash/diff shaders and the cycle check all read, and 0.5 has no exact
+    //       R8 value
+    vt::Texture::format_t conway_format = (conway_states > 2) ? vt::Texture::R8 : vt::Texture::RED;
     conway_texture = new vt::Texture("conway",
-                                     vt::Texture::RED,
-                                     glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
+                                     conway_format,
+                                     conway_dim,
                                      false); // no lerp (need exact values)
+    conway_texture->set_boundary_mode(conway_boundary_mode);
     conway_fb = new vt::FrameBuffer(conway_texture, camera);
 
     // input/output
     conway_texture2 = new vt::Texture("conway2",
-                                      vt::Texture::RED,
-                                      glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
+                                      conway_format,
+                                      conway_dim,
                                       false); // no lerp (need exact values)
+    conway_texture2->set_boundary_mode(conway_boundary_mode);
     conway_fb2 = new vt::FrameBuffer(conway_texture2, camera);
 
+    // output
+    conway_tile_dim = (conway_dim + glm::ivec2(CONWAY_TILE_DIM - 1)) / CONWAY_TILE_DIM;
+    conway_diff_texture = new vt::Texture("conway_diff",
+                                          vt::Texture::RED,
+                                          conway_tile_dim,
+                                          false); // no lerp (need exact values)
+    conway_diff_fb = new vt::FrameBuffer(conway_diff_texture, camera);
+    conway_active_tiles.resize(conway_tile_dim.x * conway_tile_dim.y, 1);
+    for(int i = 0; i <= CONWAY_DIFF_LAG; i++) {
+        vt::Buffer* diff_buffer = new vt::Buffer(GL_PIXEL_PACK_BUFFER,
+                                                 sizeof(float) * conway_tile_dim.x * conway_tile_dim.y,
+                                                 NULL,
+                                                 GL_STREAM_READ);
+        diff_buffer->unbind(); // glGetTexImage would write into it otherwise
+        conway_diff_buffers.push_back(diff_buffer);
+    }
+
+    // output (successively halved, down to a single block)
+    glm::ivec2 reduce_dim = conway_dim;
+    do {
+        reduce_dim = (reduce_dim + glm::ivec2(1)) / 2;
+        std::stringstream ss;
+        ss << "conway_reduce" << conway_reduce_textures.size();
+        vt::Texture* reduce_texture = new vt::Texture(ss.str(),
+                                                      vt::Texture::RED,
+                                                      glm::ivec2(reduce_dim.x * CONWAY_STATS, reduce_dim.y),
+                                                      false); // no lerp (need exact values)
+        conway_reduce_textures.push_back(reduce_texture);
+        conway_reduce_fbs.push_back(new vt::FrameBuffer(reduce_texture, camera));
+    } while(reduce_dim.x > 1 || reduce_dim.y > 1);
+    for(int i = 0; i <= CONWAY_STATS_LAG; i++) {
+        vt::Buffer* stats_buffer = new vt::Buffer(GL_PIXEL_PACK_BUFFER, sizeof(float) * CONWAY_STATS, NULL, GL_STREAM_READ);
+        stats_buffer->unbind(); // glGetTexImage would write into it otherwise
+        conway_stats_buffers.push_back(stats_buffer);
+    }
+
+    // output
+    conway_hash_texture = new vt::Texture("conway_hash",
+                                          vt::Texture::RGBA32F,
+                                          glm::ivec2(conway_tile_dim.x, conway_dim.y),
+                                          false); // no lerp (need exact values)
+    conway_hash_fb = new vt::FrameBuffer(conway_hash_texture, camera);
+    for(int i = 0; i <= CONWAY_HASH_LAG; i++) {
+        vt::Buffer* hash_buffer = new vt::Buffer(GL_PIXEL_PACK_BUFFER, conway_hash_texture->size(), NULL, GL_STREAM_READ);
+        hash_buffer->unbind(); // glGetTexImage would write into it otherwise
+        conway_hash_buffers.push_back(hash_buffer);
+    }
+
+    // output
+    if(universe_count > 1) {
+        conway_population_texture = new vt::Texture("conway_population",
+                                                     vt::Texture::RED,
+                                                     vt::ConwayBatch::get_grid_dim(universe_count),
+                                                     false); // no lerp (need exact values)
+        conway_population_fb = new vt::FrameBuffer(conway_population_texture, camera);
+    }
+
+    // cpu alternative to conway_material
+    conway_engine = new vt::ConwayEngine(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
+    conway_engine->set_rule(conway_rule);
+    conway_engine->set_boundary_mode(conway_boundary_mode);
+    generations_engine = new vt::GenerationsEngine(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
+    generations_engine->set_rule(conway_rule, conway_states);
+    generations_engine->set_boundary_mode(conway_boundary_mode);
+    if(universe_count > 1) {
+        conway_batch = new vt::ConwayBatch(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM), universe_count);
+        conway_batch->get_board()->set_rule(conway_rule);
+    }
+    hashlife = new vt::HashLife();
+    if(!hashlife->set_rule(conway_rule)) {
+        std::cout << "HashLife: " << vt::get_life_rule_string(conway_rule) << " not supported (B0)" << std::endl;
+    }
+
     //==========
     // materials
     //==========
@@ -102,23 +361,81 @@ int init_resources()
     scene->add_material(write_through_material);
 
     // for conway_color display
+    std::string conway_color_fragment_shader = (conway_states > 2) ? get_conway_shader("src/shaders/overlay_generations_color.f.glsl")
+                                                                   : "src/shaders/overlay_conway_color.f.glsl";
+    if(conway_color_fragment_shader.empty()) {
+        return 0;
+    }
     conway_color_material = new vt::Material("conway_color",
                                              "src/shaders/overlay_conway_color.v.glsl",
-                                             "src/shaders/overlay_conway_color.f.glsl",
+                                             conway_color_fragment_shader,
                                              true); // use_overlay
     conway_color_material->add_texture(conway_texture);
     conway_color_material->add_texture(conway_texture2);
     scene->add_material(conway_color_material);
 
     // for conway rendering
+    // NOTE: other rules get a generated copy of the fragment shader with the rule baked in as constants
+    std::string conway_fragment_shader = get_conway_shader((conway_states > 2)  ? "src/shaders/overlay_generations.f.glsl" :
+                                                           (universe_count > 1) ? "src/shaders/overlay_conway_batch.f.glsl"
+                                                                                : "src/shaders/overlay_conway.f.glsl");
+    if(conway_fragment_shader.empty()) {
+        return 0;
+    }
     conway_material = new vt::Material("conway",
                                        "src/shaders/overlay_conway.v.glsl",
-                                       "src/shaders/overlay_conway.f.glsl",
+                                       conway_fragment_shader,
                                        true); // use_overlay
     conway_material->add_texture(conway_texture);
     conway_material->add_texture(conway_texture2);
     scene->add_material(conway_material);
 
+    // for conway change tracking
+    conway_diff_material = new vt::Material("conway_diff",
+                                            "src/shaders/overlay_conway_diff.v.glsl",
+                                            "src/shaders/overlay_conway_diff.f.glsl",
+                                            true); // use_overlay
+    conway_diff_material->add_texture(conway_texture);
+    conway_diff_material->add_texture(conway_texture2);
+    scene->add_material(conway_diff_material);
+
+    // for cycle detection
+    conway_hash_material = new vt::Material("conway_hash",
+                                            "src/shaders/overlay_conway_diff.v.glsl",
+                                            "src/shaders/overlay_conway_hash.f.glsl",
+                                            true); // use_overlay
+    conway_hash_material->add_texture(conway_texture);
+    conway_hash_material->add_texture(conway_texture2);
+    scene->add_material(conway_hash_material);
+
+    // for stats (population, changes, bounding box)
+    conway_reduce_init_material = new vt::Material("conway_reduce_init",
+                                                   "src/shaders/overlay_conway_diff.v.glsl",
+                                                   "src/shaders/overlay_conway_reduce_init.f.glsl",
+                                                   true); // use_overlay
+    conway_reduce_init_material->add_texture(conway_texture);
+    conway_reduce_init_material->add_texture(conway_texture2);
+    scene->add_material(conway_reduce_init_material);
+    conway_reduce_material = new vt::Material("conway_reduce",
+                                              "src/shaders/overlay_conway_diff.v.glsl",
+                                              "src/shaders/overlay_conway_reduce.f.glsl",
+                                              true); // use_overlay
+    for(std::vector<vt::Texture*>::iterator p = conway_reduce_textures.begin(); p != conway_reduce_textures.end(); p++) {
+        conway_reduce_material->add_texture(*p);
+    }
+    scene->add_material(conway_reduce_material);
+
+    // for per-universe populations
+    if(universe_count > 1) {
+        conway_population_material = new vt::Material("conway_population",
+                                                      "src/shaders/overlay_conway_diff.v.glsl",
+                                                      "src/shaders/overlay_conway_batch_population.f.glsl",
+                                                      true); // use_overlay
+        conway_population_material->add_texture(conway_texture);
+        conway_population_material->add_texture(conway_texture2);
+        scene->add_material(conway_population_material);
+    }
+
     //==============
     // scene setup 2
     //==============
@@ -136,11 +453,32 @@ int init_resources()
     // initial pattern
     init_conway();
 
+    snapshot_writer = new vt::SnapshotWriter();
+    frame_governor = new vt::FrameGovernor(FRAME_GOVERNOR_DEFAULT_FPS, CONWAY_MAX_STEPS_PER_FRAME);
+
     return 1;
 }
 
 int deinit_resources()
 {
+    if(conway_engine) {
+        delete conway_engine;
+    }
+    if(generations_engine) {
+        delete generations_engine;
+    }
+    if(conway_batch) {
+        delete conway_batch;
+    }
+    if(hashlife) {
+        delete hashlife;
+    }
+    if(snapshot_writer) {
+        delete snapshot_writer; // finishes the pending write
+    }
+    if(frame_governor) {
+        delete frame_governor;
+    }
     return 1;
 }
 
@@ -149,6 +487,105 @@ void onIdle()
     glutPostRedisplay();
 }
 
+// same cursor mapping as overlay_conway.f.glsl
+glm::ivec2 get_cursor_pos_tex_space(vt::Scene* scene)
+{
+    glm::ivec2 cursor_pos   = scene->get_cursor_pos();
+    glm::ivec2 viewport_dim = camera->get_dim();
+    glm::ivec2 image_res    = camera->get_image_res();
+    return glm::ivec2(static_cast<int>((static_cast<float>(cursor_pos.x) / viewport_dim.x) * image_res.x),
+                      static_cast<int>((static_cast<float>(cursor_pos.y) / viewport_dim.y) * image_res.y));
+}
+
+// tiles that changed CONWAY_DIFF_LAG + 1 generations ago (plus the cursor tiles since), dilated by
+// CONWAY_DIFF_LAG + 1 tiles: a tile can only change if a tile next to it changed in the generation before, so each
+// generation the mask lags behind costs one more tile of dilation, and mapping it never waits on the last step
+// NOTE: a skipped tile keeps its output texels from two generations ago, which equal its input texels
+//       only because neither it nor its neighbors changed -- so the ping-pong swap stays valid; on a torus the
+//       tiles along opposite edges are neighbors
+void update_conway_active_tiles(glm::ivec2 cursor_tile)
+{
+    glm::ivec2 tile_dim = conway_tile_dim;
+    conway_cursor_tiles.pop_back();
+    conway_cursor_tiles.insert(conway_cursor_tiles.begin(), cursor_tile); // grow color needs one more pass to settle
+    if(conway_tiles_dirty) {
+        std::fill(conway_diff_buffer_valid.begin(), conway_diff_buffer_valid.end(), 0);
+    }
+
+    // map the oldest read, issued CONWAY_DIFF_LAG generations before the last one
+    int map_index = conway_diff_reads % conway_diff_buffers.size();
+    std::vector<char> changed(conway_active_tiles.size());
+    bool mapped = false;
+    if(conway_diff_buffer_valid[map_index]) {
+        const float* diff_pixels = reinterpret_cast<const float*>(conway_diff_buffers[map_index]->map_read());
+        if(diff_pixels) {
+            for(int i = 0; i < static_cast<int>(changed.size()); i++) {
+                changed[i] = (diff_pixels[i] != 0);
+            }
+        }
+        conway_diff_buffers[map_index]->unmap();
+        conway_diff_buffer_valid[map_index] = 0;
+        mapped = (diff_pixels != NULL);
+    }
+    if(!mapped) { // no mask since the last reset
+        std::fill(conway_active_tiles.begin(), conway_active_tiles.end(), 1);
+        conway_active_tile_count = conway_active_tiles.size();
+        return;
+    }
+    for(int i = 0; i < static_cast<int>(conway_cursor_tiles.size()); i++) {
+        glm::ivec2 tile = conway_cursor_tiles[i];
+        if(tile.x >= 0 && tile.x < tile_dim.x && tile.y >= 0 && tile.y < tile_dim.y) {
+            changed[tile.y * tile_dim.x + tile.x] = 1;
+        }
+    }
+    conway_active_tile_count = 0;
+    int radius = CONWAY_DIFF_LAG + 1;
+    bool wrap = (conway_boundary_mode == vt::BOUNDARY_TORUS);
+    for(int tile_y = 0; tile_y < tile_dim.y; tile_y++) {
+        for(int tile_x = 0; tile_x < tile_dim.x; tile_x++) {
+            bool active = false;
+            for(int dy = -radius; !active && dy <= radius; dy++) {
+                int y = wrap ? ((tile_y + dy) % tile_dim.y + tile_dim.y) % tile_dim.y : tile_y + dy;
+                if(y < 0 || y >= tile_dim.y) {
+                    continue;
+                }
+                for(int dx = -radius; dx <= radius; dx++) {
+                    int x = wrap ? ((tile_x + dx) % tile_dim.x + tile_dim.x) % tile_dim.x : tile_x + dx;
+                    if(x >= 0 && x < tile_dim.x && changed[y * tile_dim.x + x]) {
+                        active = true;
+                        break;
+                    }
+                }
+            }
+            conway_active_tiles[tile_y * tile_dim.x + tile_x] = active;
+            conway_active_tile_count += active;
+        }
+    }
+}
+
+// one scissored quad per run of active tiles in a row of tiles
+void render_conway_active_tiles(vt::Scene* scene, glm::ivec2 tile_size)
+{
+    glm::ivec2 tile_dim = conway_tile_dim;
+    glEnable(GL_SCISSOR_TEST);
+    for(int tile_y = 0; tile_y < tile_dim.y; tile_y++) {
+        int tile_x = 0;
+        while(tile_x < tile_dim.x) {
+            if(!conway_active_tiles[tile_y * tile_dim.x + tile_x]) {
+                tile_x++;
+                continue;
+            }
+            int run_begin = tile_x;
+            while(tile_x < tile_dim.x && conway_active_tiles[tile_y * tile_dim.x + tile_x]) {
+                tile_x++;
+            }
+            glScissor(run_begin * tile_size.x, tile_y * tile_size.y, (tile_x - run_begin) * tile_size.x, tile_size.y);
+            scene->render(false, true);
+        }
+    }
+    glDisable(GL_SCISSOR_TEST);
+}
+
 void do_conway_iter(vt::Scene*       scene,
                     vt::Texture*     input_texture, // IN
                     vt::FrameBuffer* output_fb)     // OUT
@@ -156,34 +593,482 @@ void do_conway_iter(vt::Scene*       scene,
     vt::Mesh* mesh = scene->get_overlay();
     vt::Texture* output_texture = output_fb->get_texture();
 
+    if(!skip_stable_tiles) {
+        // enter gpu kernel
+        output_fb->bind();
+        mesh->set_material(conway_material);
+        mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
+        scene->render(false, true);
+        output_fb->unbind();
+    } else {
+        glm::ivec2 cursor_pos_tex_space = get_cursor_pos_tex_space(scene);
+        update_conway_active_tiles(glm::ivec2(cursor_pos_tex_space.x < 0 ? -1 : cursor_pos_tex_space.x / CONWAY_TILE_DIM,
+                                              cursor_pos_tex_space.y < 0 ? -1 : cursor_pos_tex_space.y / CONWAY_TILE_DIM));
+
+        // enter gpu kernel (active tiles only)
+        output_fb->bind();
+        mesh->set_material(conway_material);
+        mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
+        render_conway_active_tiles(scene, glm::ivec2(CONWAY_TILE_DIM, CONWAY_TILE_DIM));
+        output_fb->unbind();
+
+        // which active tiles changed (inactive tiles did not, by construction)
+        conway_diff_fb->bind();
+        glClearColor(0, 0, 0, 1);
+        glClear(GL_COLOR_BUFFER_BIT);
+        mesh->set_material(conway_diff_material);
+        mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
+        mesh->set_texture2_index(mesh->get_material()->get_texture_index(output_texture));
+        render_conway_active_tiles(scene, glm::ivec2(1, 1));
+
+        // issue the read (returns at once)
+        int read_index = conway_diff_reads % conway_diff_buffers.size();
+        conway_diff_buffers[read_index]->bind();
+        glReadPixels(0, 0, conway_tile_dim.x, conway_tile_dim.y, GL_RED, GL_FLOAT, 0);
+        conway_diff_buffers[read_index]->unbind();
+        conway_diff_fb->unbind();
+        conway_diff_buffer_valid[read_index] = 1;
+        conway_diff_reads++;
+        conway_tiles_dirty = false;
+    }
+}
+
+// NOTE: only the pixels are written; the frame uploads the texture it displays (see onTick)
+void do_conway_cpu_iter(vt::Scene*       scene,
+                        vt::Texture*     input_texture, // IN
+                        vt::FrameBuffer* output_fb)     // OUT
+{
+    vt::Texture* output_texture = output_fb->get_texture();
+
+    // enter cpu kernel
+    if(conway_states > 2) {
+        generations_engine->set_cursor_pos(get_cursor_pos_tex_space(scene));
+        generations_engine->step();
+        generations_engine->store_r8(output_texture->get_pixels());
+    } else if(universe_count > 1) {
+        conway_batch->step();
+        conway_batch->store_r32f(reinterpret_cast<float*>(output_texture->get_pixels()));
+    } else {
+        conway_engine->set_cursor_pos(get_cursor_pos_tex_space(scene));
+        conway_engine->step();
+        conway_engine->store(reinterpret_cast<float*>(output_texture->get_pixels()));
+    }
+}
+
+// switch to write-through mode to display final output texture
+// NOTE: once per frame, however many generations were stepped in it
+void set_conway_display_texture(vt::Scene* scene, vt::Texture* texture)
+{
+    vt::Mesh* mesh = scene->get_overlay();
+    mesh->set_material(conway_color_material);
+    mesh->set_texture_index(mesh->get_material()->get_texture_index(texture));
+}
+
+// NOTE: HashLife runs on the unbounded plane (no dead border, no cursor seeding), so cells that would
+//       have hit the border survive in the result; only the part inside the board is loaded back
+void do_conway_hashlife_jump(vt::Texture* texture) // IN/OUT
+{
+    if(hashlife->get_rule() != conway_rule || conway_states > 2 || universe_count > 1) {
+        return; // B0, multi-state rule or batched universes
+    }
+    texture->refresh(); // download from gpu (very slow)
+    hashlife->load_r32f(reinterpret_cast<const float*>(texture->get_pixels()), glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
+    hashlife->set_step_log2(hashlife_step_log2);
+    hashlife->step();
+    hashlife->store_r32f(reinterpret_cast<float*>(texture->get_pixels()), glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
+    texture->update(); // upload to gpu (very slow)
+    conway_tiles_dirty = true;
+    if(use_cpu_engine) {
+        load_conway_cpu_engine(texture);
+    }
+    std::cout << "HashLife: +" << hashlife->get_generation() << " generations in "
+              << hashlife->get_elapsed_time() << " sec ("
+              << hashlife->get_node_count() << " nodes)" << std::endl;
+    conway_generation += hashlife->get_generation();
+    hashlife->reset_stats();
+}
+
+// NOTE: the capture is a plain copy; encoding and writing happen on snapshot_writer's thread,
+//       so the animation only stalls for the download
+void save_conway_snapshot(vt::Texture* texture)
+{
+    if(!use_cpu_engine) {
+        texture->refresh(); // download from gpu (very slow)
+    }
+    if(conway_states > 2) {
+        conway_snapshot.capture_r8(texture->get_pixels(), conway_dim);
+    } else {
+        conway_snapshot.capture_r32f(reinterpret_cast<const float*>(texture->get_pixels()), conway_dim);
+    }
+    conway_snapshot.set_generation(conway_generation);
+    conway_snapshot.set_rule(conway_rule, conway_states);
+    if(snapshot_writer->submit(&conway_snapshot, CONWAY_SNAPSHOT_FILE)) {
+        std::cout << "Snapshot: generation " << conway_generation << " to " << CONWAY_SNAPSHOT_FILE << std::endl;
+    } else {
+        std::cout << "Snapshot: skipped, still writing the last one" << std::endl;
+    }
+}
+
+void load_conway_snapshot(vt::Texture* texture) // IN/OUT
+{
+    snapshot_writer->wait();
+    vt::Snapshot snapshot;
+    if(!snapshot.load(CONWAY_SNAPSHOT_FILE)) {
+        std::cout << "Snapshot: cannot read " << CONWAY_SNAPSHOT_FILE << std::endl;
+        return;
+    }
+    if(snapshot.get_dim() != conway_dim || snapshot.get_rule() != conway_rule || snapshot.get_states() != conway_states) {
+        std::cout << "Snapshot: " << CONWAY_SNAPSHOT_FILE << " is for another board size or rule" << std::endl;
+        return;
+    }
+    if(conway_states > 2) {
+        snapshot.restore_r8(texture->get_pixels(), conway_dim);
+    } else {
+        snapshot.restore_r32f(reinterpret_cast<float*>(texture->get_pixels()), conway_dim);
+    }
+    texture->update(); // upload to gpu (very slow)
+    if(use_cpu_engine) {
+        load_conway_cpu_engine(texture);
+    }
+    conway_generation = snapshot.get_generation();
+    conway_tiles_dirty = true;
+    reset_conway_cycle_detection();
+    std::fill(conway_stats_buffer_generations.begin(), conway_stats_buffer_generations.end(), -1);
+    conway_stats_generation = -1;
+    std::cout << "Snapshot: generation " << conway_generation << " from " << CONWAY_SNAPSHOT_FILE << std::endl;
+}
+
+void toggle_conway_recording();
+
+// NOTE: on the gpu path only the tiles conway_diff_texture flags as changed are read back, into a copy of the last
+//       recorded generation, instead of a whole Texture::refresh() per frame; full is for when that copy is stale
+void record_conway_frame(vt::FrameBuffer* fb, bool full)
+{
+    if(conway_generation <= conway_record_generation) {
+        std::cout << "Recording: stopped, the generation counter went back" << std::endl;
+        toggle_conway_recording();
+        return;
+    }
+    vt::Texture* texture = fb->get_texture();
+    int cell_size = (conway_states > 2) ? sizeof(uint8_t) : sizeof(float);
+    if(use_cpu_engine || full || !skip_stable_tiles) {
+        if(!use_cpu_engine) {
+            texture->refresh(); // download from gpu (very slow)
+        }
+        memcpy(&conway_record_pixels[0], texture->get_pixels(), conway_record_pixels.size());
+    } else {
+        conway_diff_texture->refresh(); // download from gpu (one texel per tile; the tiles below wait on it anyway)
+        const float* diff_pixels = reinterpret_cast<const float*>(conway_diff_texture->get_pixels());
+        fb->bind();
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ROW_LENGTH, conway_dim.x);
+        for(int tile_y = 0; tile_y < conway_tile_dim.y; tile_y++) {
+            for(int tile_x = 0; tile_x < conway_tile_dim.x; tile_x++) {
+                if(diff_pixels[tile_y * conway_tile_dim.x + tile_x] == 0) {
+                    continue;
+                }
+                glm::ivec2 pos(tile_x * CONWAY_TILE_DIM, tile_y * CONWAY_TILE_DIM);
+                glm::ivec2 dim = glm::min(conway_dim - pos, glm::ivec2(CONWAY_TILE_DIM));
+                glReadPixels(pos.x, pos.y, dim.x, dim.y, GL_RED, (conway_states > 2) ? GL_UNSIGNED_BYTE : GL_FLOAT,
+                             &conway_record_pixels[(pos.y * conway_dim.x + pos.x) * cell_size]);
+            }
+        }
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        fb->unbind();
+    }
+    if(conway_states > 2) {
+        conway_record_frame.capture_r8(&conway_record_pixels[0], conway_dim);
+    } else {
+        conway_record_frame.capture_r32f(reinterpret_cast<const float*>(&conway_record_pixels[0]), conway_dim);
+    }
+    conway_record_frame.set_generation(conway_generation);
+    conway_record_frame.set_rule(conway_rule, conway_states);
+    conway_recorder.record(&conway_record_frame);
+    conway_record_generation = conway_generation;
+}
+
+void toggle_conway_recording()
+{
+    if(conway_recorder.is_open()) {
+        conway_recorder.close();
+        std::cout << "Recording: " << conway_recorder.get_frames() << " frames, "
+                  << conway_recorder.get_bytes() / 1024 << " KB to " << CONWAY_RECORDING_FILE
+                  << (conway_recorder.is_failed() ? " (write error)" : "") << std::endl;
+        return;
+    }
+    if(!conway_recorder.open(CONWAY_RECORDING_FILE)) {
+        std::cout << "Recording: cannot write " << CONWAY_RECORDING_FILE << std::endl;
+        return;
+    }
+    conway_record_pixels.resize(conway_dim.x * conway_dim.y * ((conway_states > 2) ? sizeof(uint8_t) : sizeof(float)));
+    conway_record_generation = -1;
+    record_conway_frame(conway_fb, true); // the current generation, as the first keyframe
+    std::cout << "Recording: to " << CONWAY_RECORDING_FILE << std::endl;
+}
+
+// live cells per universe, one texel per universe, so the whole batch costs one download
+void update_universe_populations(vt::Scene* scene, vt::Texture* texture)
+{
+    if(use_cpu_engine) {
+        std::vector<size_t> populations;
+        conway_batch->get_populations(&populations);
+        universe_populations.assign(populations.begin(), populations.end());
+        return;
+    }
+    vt::Mesh* mesh = scene->get_overlay();
+    vt::Material* prev_material = mesh->get_material();
+    int prev_texture_index = mesh->get_texture_index();
+
     // enter gpu kernel
-    output_fb->bind();
-    mesh->set_material(conway_material);
-    mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
+    conway_population_fb->bind();
+    mesh->set_material(conway_population_material);
+    mesh->set_texture_index(mesh->get_material()->get_texture_index(texture));
     scene->render(false, true);
-    output_fb->unbind();
+    conway_population_fb->unbind();
+    conway_population_texture->refresh(); // download from gpu (one texel per universe)
 
-    // switch to write-through mode to display final output texture
-    mesh->set_material(conway_color_material);
-    mesh->set_texture_index(mesh->get_material()->get_texture_index(output_texture));
+    mesh->set_material(prev_material);
+    mesh->set_texture_index(prev_texture_index);
+    const float* pixels = reinterpret_cast<const float*>(conway_population_texture->get_pixels());
+    universe_populations.assign(pixels, pixels + universe_count);
+}
+
+// board stats in log2(dim) passes, each reducing 2x2 blocks of the level below; only the last level's
+// CONWAY_STATS texels are read back, into a pixel pack buffer that is mapped CONWAY_STATS_LAG frames later
+// NOTE: image_res is the input size of each pass (the board for the first one); true if conway_stats changed
+bool update_conway_stats(vt::Scene*   scene,
+                         vt::Texture* texture,      // IN
+                         vt::Texture* prev_texture) // IN
+{
+    vt::Mesh* mesh = scene->get_overlay();
+    vt::Material* prev_material = mesh->get_material();
+    int prev_texture_index = mesh->get_texture_index();
+
+    // enter gpu kernel
+    conway_reduce_fbs[0]->bind();
+    mesh->set_material(conway_reduce_init_material);
+    mesh->set_texture_index(mesh->get_material()->get_texture_index(texture));
+    mesh->set_texture2_index(mesh->get_material()->get_texture_index(prev_texture));
+    scene->render(false, true);
+    conway_reduce_fbs[0]->unbind();
+    mesh->set_material(conway_reduce_material);
+    for(int i = 1; i < static_cast<int>(conway_reduce_fbs.size()); i++) {
+        camera->set_image_res(conway_reduce_textures[i - 1]->get_dim());
+        conway_reduce_fbs[i]->bind();
+        mesh->set_texture_index(mesh->get_material()->get_texture_index(conway_reduce_textures[i - 1]));
+        scene->render(false, true);
+        conway_reduce_fbs[i]->unbind();
+    }
+    camera->set_image_res(conway_dim);
+
+    // issue the read (returns at once)
+    int read_index = conway_stats_reads % conway_stats_buffers.size();
+    conway_reduce_fbs.back()->bind();
+    conway_stats_buffers[read_index]->bind();
+    glReadPixels(0, 0, CONWAY_STATS, 1, GL_RED, GL_FLOAT, 0);
+    conway_stats_buffers[read_index]->unbind();
+    conway_reduce_fbs.back()->unbind();
+    conway_stats_buffer_generations[read_index] = conway_generation;
+    conway_stats_reads++;
+
+    // map the oldest read, long done by now
+    int map_index = conway_stats_reads % conway_stats_buffers.size();
+    bool mapped = false;
+    if(conway_stats_buffer_generations[map_index] >= 0) {
+        const float* stats = reinterpret_cast<const float*>(conway_stats_buffers[map_index]->map_read());
+        if(stats) {
+            std::copy(stats, stats + CONWAY_STATS, conway_stats);
+            conway_stats_generation = conway_stats_buffer_generations[map_index];
+        }
+        conway_stats_buffers[map_index]->unmap();
+        conway_stats_buffer_generations[map_index] = -1;
+        mapped = (stats != NULL);
+    }
+
+    mesh->set_material(prev_material);
+    mesh->set_texture_index(prev_texture_index);
+    return mapped;
+}
+
+// board hash after a step, cursor included (it seeds a cell every generation); false if none is ready yet
+// NOTE: on the gpu only the active tiles' row runs get new signatures; the others still hold the signatures of
+//       the same cells from the last generation, so a tiny download stands in for the whole board. It goes into a
+//       pixel pack buffer that is mapped CONWAY_HASH_LAG generations later, so *generation trails the board
+bool get_conway_hash(vt::Scene*   scene,
+                     vt::Texture* texture,    // IN
+                     long*        generation, // OUT
+                     uint64_t*    hash)       // OUT
+{
+    glm::ivec2 cursor_pos_tex_space = get_cursor_pos_tex_space(scene);
+    uint64_t cursor_hash = vt::hash_mix(static_cast<uint64_t>(cursor_pos_tex_space.y) * conway_dim.x + cursor_pos_tex_space.x);
+    if(use_cpu_engine) {
+        *generation = conway_generation;
+        *hash       = vt::hash_bytes(texture->get_pixels(), texture->size(), cursor_hash);
+        return true;
+    }
+    vt::Mesh* mesh = scene->get_overlay();
+    vt::Material* prev_material = mesh->get_material();
+    int prev_texture_index = mesh->get_texture_index();
+
+    // enter gpu kernel
+    conway_hash_fb->bind();
+    mesh->set_material(conway_hash_material);
+    mesh->set_texture_index(mesh->get_material()->get_texture_index(texture));
+    if(skip_stable_tiles) {
+        render_conway_active_tiles(scene, glm::ivec2(1, CONWAY_TILE_DIM));
+    } else {
+        scene->render(false, true);
+    }
+
+    // issue the read (returns at once)
+    int read_index = conway_hash_reads % conway_hash_buffers.size();
+    conway_hash_buffers[read_index]->bind();
+    glReadPixels(0, 0, conway_tile_dim.x, conway_dim.y, GL_RGBA, GL_FLOAT, 0);
+    conway_hash_buffers[read_index]->unbind();
+    conway_hash_fb->unbind();
+    conway_hash_buffer_generations[read_index] = conway_generation;
+    conway_hash_buffer_seeds[read_index]       = cursor_hash;
+    conway_hash_reads++;
+
+    // map the oldest read, long done by now
+    int map_index = conway_hash_reads % conway_hash_buffers.size();
+    bool mapped = false;
+    if(conway_hash_buffer_generations[map_index] >= 0) {
+        const void* signatures = conway_hash_buffers[map_index]->map_read();
+        if(signatures) {
+            *generation = conway_hash_buffer_generations[map_index];
+            *hash       = vt::hash_bytes(signatures, conway_hash_texture->size(), conway_hash_buffer_seeds[map_index]);
+        }
+        conway_hash_buffers[map_index]->unmap();
+        conway_hash_buffer_generations[map_index] = -1;
+        mapped = (signatures != NULL);
+    }
+
+    mesh->set_material(prev_material);
+    mesh->set_texture_index(prev_texture_index);
+    return mapped;
+}
+
+// current board, downloaded from the gpu unless the cpu engine owns it
+void get_conway_board(vt::Texture*          texture, // IN
+                      std::vector<uint8_t>* pixels)  // OUT
+{
+    if(!use_cpu_engine) {
+        texture->refresh(); // download from gpu (very slow)
+    }
+    pixels->assign(texture->get_pixels(), texture->get_pixels() + texture->size());
+}
+
+// pauses once the board repeats: a period found by hash is only a candidate (hashes can collide), so the board is
+// kept and compared with the one a period later
+// NOTE: the period is the one the hashes suggest, found CONWAY_HASH_LAG generations late on the gpu; once a board
+//       repeats it repeats forever, so the board kept now is in the cycle as well
+void update_conway_cycle(vt::Scene*   scene,
+                         vt::Texture* texture) // IN
+{
+    long hash_generation = 0;
+    uint64_t hash = 0;
+    if(get_conway_hash(scene, texture, &hash_generation, &hash) && cycle_detector.update(hash_generation, hash) &&
+       conway_cycle_confirm_generation < 0)
+    {
+        get_conway_board(texture, &conway_cycle_pixels);
+        conway_cycle_cursor             = get_cursor_pos_tex_space(scene);
+        conway_cycle_period             = cycle_detector.get_period();
+        conway_cycle_confirm_generation = conway_generation + conway_cycle_period;
+    }
+    if(conway_cycle_confirm_generation < 0 || conway_generation < conway_cycle_confirm_generation) {
+        return;
+    }
+    long period = conway_cycle_period;
+    bool confirmed = false;
+    if(conway_generation == conway_cycle_confirm_generation && get_cursor_pos_tex_space(scene) == conway_cycle_cursor) {
+        std::vector<uint8_t> pixels;
+        get_conway_board(texture, &pixels);
+        confirmed = (pixels == conway_cycle_pixels);
+    }
+    conway_cycle_period             = 0;
+    conway_cycle_confirm_generation = -1;
+    if(!confirmed) {
+        std::cout << "Cycle: period " << period << " not confirmed at generation " << conway_generation
+                  << " (hash collision)" << std::endl;
+        cycle_detector.reset();
+        return;
+    }
+    std::cout << "Cycle: period " << period << " at generation " << conway_generation << " (paused)" << std::endl;
+    do_animation = false;
+}
+
+// one generation, plus whatever has to see every generation (recording, cycle detection)
+void step_conway()
+{
+    bool record_full = conway_tiles_dirty; // the board changed outside of the last generation
+    if(use_cpu_engine) {
+        do_conway_cpu_iter(vt::Scene::instance(),
+                           conway_fb->get_texture(), // input_texture
+                           conway_fb2);              // output_fb
+    } else {
+        do_conway_iter(vt::Scene::instance(),
+                       conway_fb->get_texture(), // input_texture
+                       conway_fb2);              // output_fb
+    }
+    std::swap(conway_fb, conway_fb2); // the elusive ping-pong swap
+    conway_generation++;
+    if(conway_recorder.is_open()) {
+        record_conway_frame(conway_fb, record_full);
+    }
+    if(stop_on_cycle) {
+        update_conway_cycle(vt::Scene::instance(), conway_fb->get_texture());
+    }
 }
 
 void onTick()
 {
     static unsigned int prev_tick = 0;
     static unsigned int frames = 0;
+    static long generations = 0;
     unsigned int tick = glutGet(GLUT_ELAPSED_TIME);
     unsigned int delta_time = tick - prev_tick;
     static float fps = 0;
+    static float gps = 0;
     if(delta_time > 1000) {
         fps = 1000.0 * frames / delta_time;
+        gps = 1000.0 * generations / delta_time;
         frames = 0;
+        generations = 0;
         prev_tick = tick;
     }
     if(show_fps && delta_time > 100) {
         std::stringstream ss;
         ss << std::setprecision(2) << std::fixed << fps << " FPS, "
+            << gps << " gen/s (" << conway_frame_steps << "/frame" << (use_frame_budget ? ", budget" : "") << "), "
             << "Mouse: {" << mouse_drag.x << ", " << mouse_drag.y << "}";
+        if(use_frame_governor) {
+            ss << ", Governor: " << vt::FrameGovernor::get_decision_name(frame_governor->get_decision())
+               << " (gpu " << frame_governor->get_gpu_time_per_iteration() * 1000
+               << " ms/gen, cpu " << frame_governor->get_cpu_time_per_iteration() * 1000
+               << " ms/gen, budget " << frame_governor->get_budget() * 1000
+               << " ms, missed " << frame_governor->get_overruns() << ")";
+        }
+        if(use_cpu_engine) {
+            ss << ", CPU: " << ((conway_states > 2)  ? generations_engine->get_generations_per_sec() :
+                                (universe_count > 1) ? conway_batch->get_generations_per_sec()
+                                                     : conway_engine->get_generations_per_sec()) << " gen/s";
+        } else if(skip_stable_tiles) {
+            ss << ", Tiles: " << conway_active_tile_count << "/" << conway_active_tiles.size();
+        }
+        if(cycle_detector.get_period()) {
+            ss << ", Cycle: " << cycle_detector.get_period();
+        }
+        if(conway_stats_generation >= 0) {
+            ss << ", Live: " << conway_stats[0] << ", Changed: " << conway_stats[1];
+        }
+        if(universe_count > 1) {
+            update_universe_populations(vt::Scene::instance(), conway_fb->get_texture());
+            ss << ", Universes: " << universe_count << " (population "
+               << *std::min_element(universe_populations.begin(), universe_populations.end()) << ".."
+               << *std::max_element(universe_populations.begin(), universe_populations.end()) << ")";
+        }
         //ss << "Width=" << camera->get_width() << ", Width=" << camera->get_height();
         glutSetWindowTitle(ss.str().c_str());
     }
@@ -191,10 +1076,47 @@ void onTick()
     if(!do_animation) {
         return;
     }
-    do_conway_iter(vt::Scene::instance(),
-                   conway_fb->get_texture(), // input_texture
-                   conway_fb2);              // output_fb
-    std::swap(conway_fb, conway_fb2); // the elusive ping-pong swap
+
+    // a fixed number of generations, as many as fit in the budget, or as many as the governor allows, then one
+    // display pass
+    // NOTE: the budget is wall time; mapping the per-generation reads (active tiles, cycle hash) a generation or two
+    //       late keeps the cpu just ahead of the gpu, and without them the driver's command queue soon throttles
+    //       submission
+    int frame_steps = use_frame_governor ? frame_governor->begin_frame() : conway_steps_per_frame;
+    int steps = 0;
+    do {
+        step_conway();
+        steps++;
+    } while(do_animation &&
+            (use_frame_budget ? (static_cast<unsigned int>(glutGet(GLUT_ELAPSED_TIME)) - tick < CONWAY_FRAME_BUDGET_MS &&
+                                 steps < CONWAY_MAX_STEPS_PER_FRAME)
+                              : steps < frame_steps));
+    if(use_frame_governor) {
+        frame_governor->end_frame(steps);
+    }
+    conway_frame_steps = steps;
+    generations += steps;
+    if(use_cpu_engine) {
+        conway_fb->get_texture()->update(); // upload to gpu (very slow)
+        if(show_fps || show_stats) {
+            conway_fb2->get_texture()->update(); // the generation before, for the changed cell count
+        }
+    }
+    if(show_fps || show_stats) {
+        bool new_stats = update_conway_stats(vt::Scene::instance(),
+                                             conway_fb->get_texture(),   // texture
+                                             conway_fb2->get_texture()); // prev_texture
+        if(show_stats && new_stats) {
+            std::cout << "Generation " << conway_stats_generation << ": live " << conway_stats[0]
+                      << ", changed " << conway_stats[1];
+            if(conway_stats[4] >= 0) {
+                std::cout << ", bounding box (" << -conway_stats[2] << ", " << -conway_stats[3] << ")-("
+                          << conway_stats[4] << ", " << conway_stats[5] << ")";
+            }
+            std::cout << std::endl;
+        }
+    }
+    set_conway_display_texture(vt::Scene::instance(), conway_fb->get_texture());
 }
 
 void onDisplay()
@@ -217,11 +1139,93 @@ void onKeyboard(unsigned char key, int x, int y)
                 glutSetWindowTitle(DEFAULT_CAPTION);
             }
             break;
+        case 'c': // toggle cpu engine
+            use_cpu_engine = !use_cpu_engine;
+            conway_tiles_dirty = true;
+            reset_conway_cycle_detection(); // the engines hash the board differently
+            if(use_cpu_engine) {
+                vt::Texture* input_texture = conway_fb->get_texture();
+                input_texture->refresh(); // download from gpu (very slow)
+                load_conway_cpu_engine(input_texture);
+                conway_engine->reset_stats();
+                generations_engine->reset_stats();
+                if(conway_batch) {
+                    conway_batch->reset_stats();
+                }
+            }
+            break;
+        case 's': // toggle per-frame stats
+            show_stats = !show_stats;
+            break;
+        case 'o': // toggle stop on cycle
+            stop_on_cycle = !stop_on_cycle;
+            reset_conway_cycle_detection();
+            std::cout << "Stop on cycle: " << (stop_on_cycle ? "on" : "off") << std::endl;
+            break;
+        case 'a': // toggle active-tile tracking
+            skip_stable_tiles = !skip_stable_tiles;
+            conway_tiles_dirty = true;
+            break;
+        case 'p': // print per-universe populations
+            if(universe_count > 1) {
+                update_universe_populations(vt::Scene::instance(), conway_fb->get_texture());
+                for(int i = 0; i < universe_count; i++) {
+                    std::cout << "Universe " << i << ": " << universe_populations[i] << std::endl;
+                }
+            }
+            break;
+        case 'j': // hashlife jump
+            do_conway_hashlife_jump(conway_fb->get_texture());
+            break;
+        case '[': // smaller hashlife jump
+            hashlife_step_log2 = std::max(0, hashlife_step_log2 - 1);
+            std::cout << "HashLife jump: 2^" << hashlife_step_log2 << " generations" << std::endl;
+            break;
+        case ']': // bigger hashlife jump
+            hashlife_step_log2 = std::min(HASHLIFE_MAX_LEVEL - 2, hashlife_step_log2 + 1);
+            std::cout << "HashLife jump: 2^" << hashlife_step_log2 << " generations" << std::endl;
+            break;
+        case 'w': // write snapshot
+            save_conway_snapshot(conway_fb->get_texture());
+            break;
+        case 'l': // load snapshot
+            load_conway_snapshot(conway_fb->get_texture());
+            break;
+        case 'e': // toggle recording
+            toggle_conway_recording();
+            break;
+        case '=': // more generations per frame
+        case '+':
+            conway_steps_per_frame = std::min(CONWAY_MAX_STEPS_PER_FRAME, conway_steps_per_frame * 2);
+            std::cout << "Generations per frame: " << conway_steps_per_frame << std::endl;
+            break;
+        case '-': // fewer generations per frame
+            conway_steps_per_frame = std::max(1, conway_steps_per_frame / 2);
+            std::cout << "Generations per frame: " << conway_steps_per_frame << std::endl;
+            break;
+        case 'b': // toggle frame time budget
+            use_frame_budget = !use_frame_budget;
+            use_frame_governor = false;
+            std::cout << "Generations per frame: "
+                      << (use_frame_budget ? "as many as fit in the frame budget" : "fixed") << std::endl;
+            break;
+        case 'g': // toggle frame governor
+            use_frame_governor = !use_frame_governor;
+            use_frame_budget = false;
+            frame_governor->reset();
+            std::cout << "Generations per frame: "
+                      << (use_frame_governor ? "as many as the frame governor allows" : "fixed")
+                      << (use_frame_governor && !frame_governor->has_gpu_timer() ? " (no gpu timer, cpu time only)" : "")
+                      << std::endl;
+            break;
         case 'r': // reset pattern
             if(conway_fb->get_texture() == conway_texture2) {
                 std::swap(conway_fb, conway_fb2);
             }
             init_conway();
+            if(use_cpu_engine) {
+                load_conway_cpu_engine(conway_texture);
+            }
             break;
         case 32: // space
             do_animation = !do_animation;
@@ -278,6 +1282,40 @@ void onReshape(int width, int height)
 int main(int argc, char* argv[])
 {
     glutInit(&argc, argv);
+    // "-" keeps the pattern's own rule (or life)
+    if(argc > 1 && strcmp(argv[1], "-") && !vt::find_generations_rule(argv[1], &conway_rule, &conway_states)) {
+        fprintf(stderr, "Error: unknown rule \"%s\" (try B3/S23, 23/3, highlife, B2/S/C3 or brians_brain)\n", argv[1]);
+        return 1;
+    }
+    if(argc > 2) {
+        universe_count = atoi(argv[2]);
+        if(universe_count < 1 || (universe_count > 1 && conway_states > 2)) {
+            fprintf(stderr, "Error: invalid universe count \"%s\" (batched universes need a 2-state rule)\n", argv[2]);
+            return 1;
+        }
+        conway_dim = vt::ConwayBatch::get_atlas_dim(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM), universe_count);
+    }
+    if(argc > 3 && strcmp(argv[3], "-")) { // "-" for the "x" pattern
+        conway_pattern_filename = argv[3];
+        vt::pattern_info_t pattern_info;
+        if(universe_count > 1 || !vt::read_pattern_header(conway_pattern_filename, &pattern_info)) {
+            fprintf(stderr, "Error: cannot read pattern \"%s\" (patterns need a single universe)\n", argv[3]);
+            return 1;
+        }
+        if(!strcmp(argv[1], "-") && pattern_info.has_rule) {
+            conway_rule   = pattern_info.rule;
+            conway_states = pattern_info.states;
+        }
+    }
+    if(argc > 4) {
+        // NOTE: universes in one atlas only stay apart with dead cells around them
+        if(!vt::find_boundary_mode(argv[4], &conway_boundary_mode) ||
+           (universe_count > 1 && conway_boundary_mode != vt::BOUNDARY_DEAD))
+        {
+            fprintf(stderr, "Error: invalid boundary mode \"%s\" (try dead, torus or mirror; batched universes need dead)\n", argv[4]);
+            return 1;
+        }
+    }
     glutInitDisplayMode(GLUT_RGBA | GLUT_ALPHA | GLUT_DOUBLE | GLUT_DEPTH);
     glutInitWindowSize(init_screen_width, init_screen_height);
     glutCreateWindow(DEFAULT_CAPTION);
@@ -0,0 +1,1041 @@
+/**
+ * Headless Conway's Game of Life runner (no GLUT, no GL context)
+ * Enhanced by: onlyuser
+ */
+
+#include <BitBoard.h>
+#include <Boundary.h>
+#include <ConwayBatch.h>
+#include <ConwayEngine.h>
+#include <CycleDetector.h>
+#include <FilePattern.h>
+#include <GenerationsEngine.h>
+#include <HashLife.h>
+#include <LifeKernel.h>
+#include <LifeRule.h>
+#include <Recording.h>
+#include <Snapshot.h>
+#include <StripBoard.h>
+#include <ThreadPool.h>
+#include <TiledBoard.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <time.h>
+
+#define DEFAULT_DIM         128
+#define DEFAULT_GENERATIONS 1000
+#define CYCLE_HASH_INTERVAL 8
+#define DEFAULT_TILE_FILE   "conway_tiles.bin"
+#define DEFAULT_PROCESSES   2
+
+void show_help(const char* program_name)
+{
+    printf("Usage: %s [-e ENGINE] [-k KERNEL] [-t THREADS] [-T BLOCK] [-j STEP_LOG2] [-m MAX_NODES] [-R RULE] [-N COUNT] [-p PATTERN] [-S FILE] [-I INTERVAL] [-L FILE] [-O FILE] [-K INTERVAL] [-P FILE] [-f FILE] [-M CACHE_TILES] [-w PROCESSES] [-W BOUNDARY] [-x WIDTH] [-y HEIGHT] [-g GENERATIONS] [-r] [-s SEED] [-n] [-c MODE] [-v] [-b] [-B] [-h]\n", program_name);
+    printf("  -e ENGINE      \"reference\" (float per cell), \"bitboard\" (1 bit per cell), \"hashlife\" (quadtree),\n");
+    printf("                 \"generations\" (byte per cell, multi-state rules), \"batch\" (-N bitboards in one atlas)\n");
+    printf("                 \"tiled\" (bitboard tiles paged from a memory-mapped file, for boards larger than RAM)\n");
+    printf("                 or \"strips\" (-w processes, one bitboard strip each, boundary rows in shared memory)\n");
+    printf("                 (default: reference)\n");
+    printf("  -k KERNEL      bitboard simd variant: scalar, sse2, avx2 or avx512 (default: best supported, \"%s\")\n",
+           vt::get_life_kernel_name(vt::life_kernel_best()));
+    printf("  -t THREADS     bitboard worker threads, 0 for one per core (default: single-threaded)\n");
+    printf("  -T BLOCK       bitboard generations per tile pass (temporal blocking), 1 to %d (default: 1)\n", BITBOARD_MAX_BLOCK_GENERATIONS);
+    printf("  -j STEP_LOG2   hashlife jumps 2^STEP_LOG2 generations per step; -g counts steps (default: 0)\n");
+    printf("  -m MAX_NODES   hashlife node cache size before garbage collection (default: %d)\n", HASHLIFE_DEFAULT_MAX_NODES);
+    printf("  -R RULE        life-like rule in B/S notation (\"B36/S23\"), S/B notation (\"23/36\") or one of:\n");
+    for(int i = 0; i < vt::get_known_life_rule_count(); i++) {
+        vt::life_rule_t rule = vt::get_known_life_rule(i);
+        printf("                   %-18s %s\n", vt::get_life_rule_name(rule), vt::get_life_rule_string(rule).c_str());
+    }
+    printf("                 generations engine only: B/S/C notation (\"B2/S/C3\"), S/B/C notation (\"/2/3\") or one of:\n");
+    for(int i = 0; i < vt::get_known_generations_rule_count(); i++) {
+        int states = 0;
+        vt::life_rule_t rule = vt::get_known_generations_rule(i, &states);
+        printf("                   %-18s %s\n", vt::get_generations_rule_name(rule, states), vt::get_generations_rule_string(rule, states).c_str());
+    }
+    printf("                 (default: life)\n");
+    printf("  -N COUNT       batch engine only: independent universes of WIDTH x HEIGHT, each with its own initial\n");
+    printf("                 pattern, stepped together (default: 1)\n");
+    printf("  -p PATTERN     initial pattern from an RLE (.rle), plaintext (.cells) or Macrocell (.mc) file, centered\n");
+    printf("                 on the board; its rule applies unless -R is given (default: -r or the \"x\" pattern)\n");
+    printf("  -S FILE        reference, bitboard and generations engines: write a checkpoint (see Snapshot.h) on a\n");
+    printf("                 background thread every -I generations; one is skipped if the last is still being written\n");
+    printf("  -I INTERVAL    generations between checkpoints (default: one at the end)\n");
+    printf("  -L FILE        resume from a checkpoint: its board size, rule (unless -R is given) and generation\n");
+    printf("  -O FILE        reference, bitboard and generations engines: record every generation, storing only the\n");
+    printf("                 tiles that changed (see Recording.h), on a background thread\n");
+    printf("  -K INTERVAL    frames between recording keyframes (default: %d)\n", RECORDING_DEFAULT_KEYFRAME_INTERVAL);
+    printf("  -P FILE        replay a recording up to -g generations after its first frame (default: all of it), both\n");
+    printf("                 frame by frame and by seeking; -S saves the last frame as a checkpoint\n");
+    printf("  -f FILE        tiled engine only: scratch file for the tiles, removed on exit (default: %s)\n", DEFAULT_TILE_FILE);
+    printf("  -M CACHE_TILES tiled engine only: tiles kept resident, %dx%d cells and %d KB each (default: %d)\n",
+           TILED_BOARD_TILE_DIM, TILED_BOARD_TILE_DIM,
+           static_cast<int>(2 * TILED_BOARD_TILE_SIZE * sizeof(uint64_t) / 1024),
+           TILED_BOARD_DEFAULT_CACHE_TILES);
+    printf("  -w PROCESSES   strips engine only: worker processes, one horizontal strip each (default: %d)\n", DEFAULT_PROCESSES);
+    printf("  -W BOUNDARY    reference, bitboard and generations engines: off-board cells read as \"dead\", \"torus\"\n");
+    printf("                 (the opposite edge) or \"mirror\" (the edge cell itself) (default: dead)\n");
+    printf("  -x WIDTH       board width (default: %d)\n", DEFAULT_DIM);
+    printf("  -y HEIGHT      board height (default: %d)\n", DEFAULT_DIM);
+    printf("  -g GENERATIONS generations to run (default: %d)\n", DEFAULT_GENERATIONS);
+    printf("  -r             random initial pattern (default: same \"x\" pattern as main_conway)\n");
+    printf("  -s SEED        random seed (default: time)\n");
+    printf("  -n             bitboard steps every tile, even if it and its neighbors did not change\n");
+    printf("  -c MODE        bitboard engine only: hash the board every %d generations and, once it repeats (period up\n", CYCLE_HASH_INTERVAL);
+    printf("                 to %d), \"stop\" the run or \"skip\" ahead to the requested generation count\n", CYCLE_DETECTOR_DEFAULT_MAX_PERIOD);
+    printf("  -v             verify every generation against the reference engine\n");
+    printf("  -b             print bitboard throughput for every supported simd variant\n");
+    printf("  -B             print bitboard throughput and memory traffic for every temporal blocking factor\n");
+    printf("  -h             show this help\n");
+}
+
+void print_stats(const char* engine_name,
+                 glm::ivec2  dim,
+                 long        generation,
+                 double      elapsed_time,
+                 double      generations_per_sec,
+                 size_t      population)
+{
+    printf("engine:          %s\n",        engine_name);
+    printf("dim:             %dx%d\n",     dim.x, dim.y);
+    printf("generations:     %ld\n",       generation);
+    printf("elapsed:         %.6f sec\n",  elapsed_time);
+    printf("generations/sec: %.2f\n",      generations_per_sec);
+    printf("cells/sec:       %.2f\n",      generations_per_sec * dim.x * dim.y);
+    printf("population:      %zu\n",       population);
+}
+
+// per-thread timing counters (load imbalance)
+void print_thread_stats(const vt::ThreadPool& thread_pool)
+{
+    printf("%-8s %12s %12s %12s\n", "thread", "tasks", "steals", "busy (sec)");
+    for(int i = 0; i < thread_pool.get_thread_count(); i++) {
+        const vt::ThreadPool::thread_stats_t& stats = thread_pool.get_thread_stats(i);
+        printf("%-8d %12ld %12ld %12.6f\n", i, stats.tasks, stats.steals, stats.busy_time);
+    }
+    printf("imbalance:       %.3f (max/mean busy time)\n", thread_pool.get_imbalance());
+}
+
+void print_pattern_info(const std::string& filename, const char* target, const vt::pattern_info_t& info)
+{
+    std::string rule_string = "no rule";
+    if(info.has_rule) {
+        rule_string = (info.states > 2) ? vt::get_generations_rule_string(info.rule, info.states) : vt::get_life_rule_string(info.rule);
+    }
+    printf("pattern:         %s (%s, %lldx%lld, %s)\n",
+           filename.c_str(),
+           vt::get_pattern_format_name(info.format),
+           static_cast<long long>(info.width),
+           static_cast<long long>(info.height),
+           rule_string.c_str());
+    printf("pattern load:    %.2f MB in %.6f sec (%.2f MB/s), %llu cells, into %s\n",
+           info.bytes / (1024.0 * 1024.0),
+           info.elapsed_time,
+           (info.elapsed_time > 0) ? info.bytes / (1024.0 * 1024.0 * info.elapsed_time) : 0,
+           static_cast<unsigned long long>(info.population),
+           target);
+}
+
+void capture_snapshot(const vt::ConwayEngine& engine, vt::Snapshot* snapshot) // out
+{
+    snapshot->capture_r32f(engine.get_pixels(), engine.get_dim(), vt::SNAPSHOT_CELLS_FLOAT); // exact texels
+    snapshot->set_rule(engine.get_rule());
+}
+
+void capture_snapshot(const vt::BitBoard& engine, vt::Snapshot* snapshot) // out
+{
+    snapshot->capture(engine);
+}
+
+void capture_snapshot(const vt::GenerationsEngine& engine, vt::Snapshot* snapshot) // out
+{
+    snapshot->capture_r8(engine.get_cells(), engine.get_dim());
+    snapshot->set_rule(engine.get_rule(), engine.get_states());
+}
+
+// step in chunks of interval generations, handing a checkpoint to the background writer after each one
+// NOTE: only the capture (a copy of the cells) runs on this thread
+template<class T>
+void step_with_checkpoints(T& engine, int generations, int interval, const std::string& filename, uint64_t base_generation)
+{
+    vt::SnapshotWriter writer;
+    vt::Snapshot snapshot;
+    double capture_time = 0;
+    size_t cells_size   = 0;
+    for(int i = 0; i < generations; i += interval) {
+        engine.step(std::min(interval, generations - i));
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        capture_snapshot(engine, &snapshot);
+        snapshot.set_generation(base_generation + engine.get_generation());
+        cells_size = snapshot.get_size();
+        writer.submit(&snapshot, filename);
+        std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+        capture_time += delta_time.count();
+    }
+    writer.wait();
+    struct stat file_stat;
+    double file_size = stat(filename.c_str(), &file_stat) ? 0 : file_stat.st_size;
+    printf("checkpoints:     %ld written, %ld skipped (writer busy), %ld failed, to %s\n",
+           writer.get_written(), writer.get_skipped(), writer.get_failed(), filename.c_str());
+    printf("checkpoint size: %.2f KB (%.2f%% of %.2f KB of cells in memory)\n",
+           file_size / 1024, 100.0 * file_size / cells_size, cells_size / 1024.0);
+    printf("checkpoint time: %.6f sec capturing on this thread, %.6f sec encoding and writing in the background\n",
+           capture_time, writer.get_write_time());
+}
+
+// one frame per generation, including the first; the encoding and the disk write run on the recorder's thread
+template<class T>
+bool step_with_recording(T& engine, int generations, vt::Recorder* recorder, uint64_t base_generation)
+{
+    vt::Snapshot frame;
+    double capture_time = 0;
+    size_t cells_size   = 0;
+    for(int i = 0; i <= generations; i++) {
+        if(i) {
+            engine.step(1);
+        }
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        capture_snapshot(engine, &frame);
+        frame.set_generation(base_generation + engine.get_generation());
+        cells_size = frame.get_size();
+        recorder->record(&frame);
+        std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+        capture_time += delta_time.count();
+    }
+    recorder->close();
+    if(recorder->is_failed()) {
+        fprintf(stderr, "Error: cannot write recording\n");
+        return false;
+    }
+    long frames = recorder->get_frames();
+    printf("recording:       %ld frames (%ld keyframes), %.2f tiles per frame\n",
+           frames, recorder->get_keyframes(), static_cast<double>(recorder->get_tiles()) / frames);
+    printf("recording size:  %.2f KB, %.2f bytes/frame (%.2f KB of cells in memory per frame)\n",
+           recorder->get_bytes() / 1024.0, static_cast<double>(recorder->get_bytes()) / frames, cells_size / 1024.0);
+    printf("recording time:  %.6f sec capturing on this thread (%.6f sec of it waiting), %.6f sec encoding and writing\n"
+           "                 in the background\n",
+           capture_time, recorder->get_stall_time(), recorder->get_write_time());
+    return true;
+}
+
+// replays frame by frame, then seeks straight to the same frame from a fresh replayer; both must agree
+bool replay(const std::string& filename, int generations, const std::string& checkpoint_filename)
+{
+    vt::Replayer replayer;
+    if(!replayer.open(filename) || !replayer.get_frame_count()) {
+        fprintf(stderr, "Error: cannot read recording \"%s\"\n", filename.c_str());
+        return false;
+    }
+    uint64_t first_generation = replayer.get_first_generation();
+    uint64_t last_generation  = (generations >= 0) ? std::min(first_generation + generations, replayer.get_last_generation())
+                                                   : replayer.get_last_generation();
+    struct stat file_stat;
+    double file_size = stat(filename.c_str(), &file_stat) ? 0 : file_stat.st_size;
+    glm::ivec2 dim = replayer.get_dim();
+    printf("recording:       %s, %dx%d, %ld frames (%ld keyframes, every %d), generations %llu to %llu\n",
+           filename.c_str(), dim.x, dim.y, replayer.get_frame_count(), replayer.get_keyframe_count(),
+           replayer.get_keyframe_interval(), static_cast<unsigned long long>(first_generation),
+           static_cast<unsigned long long>(replayer.get_last_generation()));
+    printf("recording size:  %.2f KB, %.2f bytes/frame\n", file_size / 1024, file_size / replayer.get_frame_count());
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    long frames = 0;
+    bool result = replayer.seek(first_generation);
+    for(frames = 1; result && replayer.get_snapshot().get_generation() < last_generation; frames++) {
+        result = replayer.next();
+    }
+    std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+    if(!result) {
+        fprintf(stderr, "Error: cannot decode recording \"%s\" after generation %llu\n",
+                filename.c_str(), static_cast<unsigned long long>(replayer.get_snapshot().get_generation()));
+        return false;
+    }
+    printf("replay:          %ld frames in %.6f sec (%.2f frames/sec), population %lu at generation %llu\n",
+           frames, delta_time.count(), frames / delta_time.count(),
+           static_cast<unsigned long>(replayer.get_snapshot().get_population()),
+           static_cast<unsigned long long>(last_generation));
+
+    vt::Replayer seeker;
+    seeker.open(filename);
+    start_time = std::chrono::steady_clock::now();
+    result = seeker.seek(last_generation);
+    delta_time = std::chrono::steady_clock::now() - start_time;
+    if(!result || seeker.get_snapshot().get_population() != replayer.get_snapshot().get_population()) {
+        fprintf(stderr, "Error: seeking to generation %llu disagrees with replaying up to it\n",
+                static_cast<unsigned long long>(last_generation));
+        return false;
+    }
+    printf("seek:            %ld frames decoded in %.6f sec\n", seeker.get_frames_decoded(), delta_time.count());
+    if(!checkpoint_filename.empty()) {
+        if(!replayer.get_snapshot().save(checkpoint_filename)) {
+            fprintf(stderr, "Error: cannot write checkpoint \"%s\"\n", checkpoint_filename.c_str());
+            return false;
+        }
+        printf("checkpoint:      generation %llu to %s\n",
+               static_cast<unsigned long long>(last_generation), checkpoint_filename.c_str());
+    }
+    return true;
+}
+
+// compare every few generations against the reference engine, in Texture::RED encoding
+template<class T>
+bool verify(T& engine, vt::ConwayEngine& reference, int generations, int generations_per_check = 1)
+{
+    glm::ivec2 dim = reference.get_dim();
+    std::vector<float> pixels(dim.x * dim.y);
+    for(int i = 0; i < generations; i += generations_per_check) {
+        int n = std::min(generations_per_check, generations - i);
+        engine.step(n);
+        reference.step(n);
+        engine.store_r32f(&pixels[0]);
+        if(memcmp(&pixels[0], reference.get_pixels(), sizeof(float) * pixels.size())) {
+            fprintf(stderr, "Error: mismatch against reference engine at generation %ld\n", reference.get_generation());
+            return false;
+        }
+    }
+    return true;
+}
+
+// NOTE: only liveness is compared; the reference engine's GROW/LIVE colors both map to the alive state
+bool verify_generations(vt::GenerationsEngine& engine, vt::ConwayEngine& reference, int generations)
+{
+    glm::ivec2 dim = reference.get_dim();
+    size_t n = dim.x * dim.y;
+    for(int i = 0; i < generations; i++) {
+        engine.step();
+        reference.step();
+        const uint8_t* cells    = engine.get_cells();
+        const float*   expected = reference.get_pixels();
+        for(size_t j = 0; j < n; j++) {
+            if((cells[j] == GENERATIONS_ALIVE) != (expected[j] > 0)) {
+                fprintf(stderr, "Error: mismatch against reference engine at generation %ld\n", reference.get_generation());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// NOTE: only liveness is compared; the tiled board keeps no grow bits
+bool verify_tiled(vt::TiledBoard& engine, vt::ConwayEngine& reference, int generations)
+{
+    glm::ivec2 dim = reference.get_dim();
+    std::vector<float> pixels(dim.x * dim.y);
+    for(int i = 0; i < generations; i++) {
+        engine.step();
+        reference.step();
+        engine.store_r32f(&pixels[0]);
+        const float* expected = reference.get_pixels();
+        for(size_t j = 0; j < pixels.size(); j++) {
+            if((pixels[j] > 0) != (expected[j] > 0)) {
+                fprintf(stderr, "Error: mismatch against reference engine at generation %ld\n", reference.get_generation());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// step until the board repeats, then stop or fast-forward to the requested generation count
+// NOTE: hashing every generation costs about a third of a chaotic board's step time, so hashes are taken every
+//       CYCLE_HASH_INTERVAL generations; any period up to the ring size still shows up, as a repeat a multiple of
+//       the period apart, which one more pass of single generations narrows down to the period itself
+void step_until_cycle(vt::BitBoard& engine, int generations, bool skip_cycle)
+{
+    vt::CycleDetector detector;
+    detector.update(engine.get_generation(), engine.get_hash());
+    int interval = std::max(CYCLE_HASH_INTERVAL, engine.get_block_generations());
+    double hash_time = 0;
+    while(engine.get_generation() < generations) {
+        engine.step(std::min(static_cast<long>(interval), generations - engine.get_generation()));
+        std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        uint64_t hash = engine.get_hash();
+        std::chrono::duration<double> delta_time = std::chrono::steady_clock::now() - start_time;
+        hash_time += delta_time.count();
+        if(detector.update(engine.get_generation(), hash)) {
+            break;
+        }
+    }
+    if(!detector.get_period()) {
+        printf("cycle:           none (up to period %d)\n", detector.get_max_period());
+    } else {
+        uint64_t hash = engine.get_hash();
+        int period = 0;
+        do {
+            engine.step(1);
+            period++;
+        } while(engine.get_hash() != hash && period < detector.get_period());
+        printf("cycle:           period %d at generation %ld\n", period, detector.get_cycle_generation());
+        if(skip_cycle) {
+            engine.skip_generations(generations - engine.get_generation(), period);
+        }
+    }
+    printf("hash time:       %.6f sec (%.2f%% of step time, every %d generations)\n",
+           hash_time, 100.0 * hash_time / engine.get_elapsed_time(), interval);
+}
+
+// compare every universe against its own reference engine (no cursor), in Texture::RED encoding
+bool verify_batch(vt::ConwayBatch& engine, const std::vector<vt::ConwayEngine*>& universes, int generations)
+{
+    glm::ivec2 dim       = engine.get_universe_dim();
+    glm::ivec2 atlas_dim = engine.get_atlas_dim();
+    std::vector<float> pixels(atlas_dim.x * atlas_dim.y);
+    for(int i = 0; i < generations; i++) {
+        engine.step();
+        engine.store_r32f(&pixels[0]);
+        for(int j = 0; j < static_cast<int>(universes.size()); j++) {
+            universes[j]->step();
+            glm::ivec2 origin = engine.get_universe_origin(j);
+            for(int y = 0; y < dim.y; y++) {
+                if(memcmp(&pixels[(origin.y + y) * atlas_dim.x + origin.x], universes[j]->get_pixels() + y * dim.x, sizeof(float) * dim.x)) {
+                    fprintf(stderr, "Error: mismatch against reference engine in universe %d at generation %ld\n", j, universes[j]->get_generation());
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// temporal blocking table; traffic counts board buffer reads and writes, not scratch (cache) traffic
+void bench_block_generations(const vt::ConwayEngine& reference, int generations, vt::ThreadPool* thread_pool)
+{
+    glm::ivec2 dim = reference.get_dim();
+    printf("%-8s %12s %12s %16s\n", "k", "gen/sec", "cells/ns", "bytes/gen");
+    for(int k = 1; k <= BITBOARD_MAX_BLOCK_GENERATIONS; k *= 2) {
+        vt::BitBoard engine(dim);
+        engine.set_rule(reference.get_rule());
+        engine.set_skip_stable_tiles(false); // whole board every generation
+        engine.set_block_generations(k);
+        engine.set_thread_pool(thread_pool);
+        engine.load_r32f(reference.get_pixels());
+        engine.set_cursor_pos(reference.get_cursor_pos());
+        engine.step(generations);
+        double cells = static_cast<double>(dim.x) * dim.y * engine.get_generation();
+        printf("%-8d %12.2f %12.3f %16.0f\n",
+               k,
+               engine.get_generations_per_sec(),
+               cells / (engine.get_elapsed_time() * 1e9),
+               engine.get_bytes_per_generation());
+    }
+}
+
+// NOTE: hashlife has no dead border and no cursor, so the reference engine runs on a board padded by the
+//       light-speed distance with seeding disabled, and only liveness is compared
+bool verify_hashlife(vt::HashLife& engine, const vt::ConwayEngine& reference, int steps)
+{
+    glm::ivec2 dim = reference.get_dim();
+    long generations = static_cast<long>(steps) << engine.get_step_log2();
+    int pad = static_cast<int>(generations) + 1;
+    glm::ivec2 padded_dim = dim + glm::ivec2(pad * 2);
+    std::vector<float> pixels(padded_dim.x * padded_dim.y, CONWAY_DIE_COLOR);
+    for(int y = 0; y < dim.y; y++) {
+        memcpy(&pixels[(y + pad) * padded_dim.x + pad], &reference.get_pixels()[y * dim.x], sizeof(float) * dim.x);
+    }
+    vt::ConwayEngine padded_reference(padded_dim);
+    padded_reference.set_rule(reference.get_rule());
+    padded_reference.load(&pixels[0]);
+    padded_reference.set_cursor_pos(glm::ivec2(-1));
+    engine.load_r32f(&pixels[0], padded_dim);
+    for(int i = 0; i < steps; i++) {
+        engine.step();
+        padded_reference.step(1 << engine.get_step_log2());
+        engine.store_r32f(&pixels[0], padded_dim);
+        const float* expected = padded_reference.get_pixels();
+        for(size_t j = 0; j < pixels.size(); j++) {
+            if((pixels[j] > 0) != (expected[j] > 0)) {
+                fprintf(stderr, "Error: mismatch against reference engine at generation %ld\n", padded_reference.get_generation());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// per-variant throughput table
+// NOTE: the cost per cell does not depend on the rule, so the numbers should match across -R
+void bench_kernels(const vt::ConwayEngine& reference, int generations)
+{
+    glm::ivec2 dim = reference.get_dim();
+    printf("rule:            %s (%s kernel)\n",
+           vt::get_life_rule_string(reference.get_rule()).c_str(),
+           vt::is_life_kernel_specialized(reference.get_rule()) ? "specialized" : "generic");
+    printf("%-8s %12s\n", "kernel", "cells/ns");
+    for(int i = 0; i < vt::LIFE_KERNEL_COUNT; i++) {
+        vt::life_kernel_type_t kernel_type = static_cast<vt::life_kernel_type_t>(i);
+        if(!vt::life_kernel_supported(kernel_type)) {
+            printf("%-8s %12s\n", vt::get_life_kernel_name(kernel_type), "unsupported");
+            continue;
+        }
+        vt::BitBoard engine(dim);
+        engine.set_rule(reference.get_rule());
+        engine.set_kernel_type(kernel_type);
+        engine.set_boundary_mode(reference.get_boundary_mode());
+        engine.set_skip_stable_tiles(false); // kernel throughput over the whole board
+        engine.load_r32f(reference.get_pixels());
+        engine.set_cursor_pos(reference.get_cursor_pos());
+        engine.step(generations);
+        double cells = static_cast<double>(dim.x) * dim.y * engine.get_generation();
+        printf("%-8s %12.3f\n", vt::get_life_kernel_name(kernel_type), cells / (engine.get_elapsed_time() * 1e9));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string engine_name = "reference";
+    vt::life_kernel_type_t kernel_type = vt::life_kernel_best();
+    glm::ivec2 dim(DEFAULT_DIM, DEFAULT_DIM);
+    int  generations  = DEFAULT_GENERATIONS;
+    bool random       = false;
+    bool do_verify    = false;
+    bool do_bench     = false;
+    bool skip_stable  = true;
+    int  thread_count = -1;
+    int  step_log2    = 0;
+    int  block_generations = 1;
+    bool do_bench_blocks   = false;
+    size_t max_nodes  = HASHLIFE_DEFAULT_MAX_NODES;
+    vt::life_rule_t rule = LIFE_RULE_CONWAY;
+    int states = 2;
+    int universe_count = 1;
+    std::string cycle_mode;
+    std::string pattern_filename;
+    bool rule_given = false;
+    std::string checkpoint_filename;
+    std::string resume_filename;
+    int checkpoint_interval = 0;
+    std::string recording_filename;
+    std::string replay_filename;
+    int keyframe_interval = RECORDING_DEFAULT_KEYFRAME_INTERVAL;
+    bool generations_given = false;
+    std::string tile_filename = DEFAULT_TILE_FILE;
+    size_t cache_tiles = TILED_BOARD_DEFAULT_CACHE_TILES;
+    int process_count = DEFAULT_PROCESSES;
+    vt::boundary_mode_t boundary_mode = vt::BOUNDARY_DEAD;
+    unsigned int seed = time(NULL);
+    int opt;
+    while((opt = getopt(argc, argv, "e:k:t:T:j:m:R:N:p:S:I:L:O:K:P:f:M:w:W:x:y:g:rs:nc:vbBh")) != -1) {
+        switch(opt) {
+            case 'e': engine_name  = optarg;       break;
+            case 'k':
+                if(!vt::find_life_kernel(optarg, &kernel_type) || !vt::life_kernel_supported(kernel_type)) {
+                    fprintf(stderr, "Error: unknown or unsupported kernel \"%s\"\n", optarg);
+                    return 1;
+                }
+                break;
+            case 't': thread_count = atoi(optarg); break;
+            case 'T': block_generations = atoi(optarg); break;
+            case 'j': step_log2    = atoi(optarg); break;
+            case 'm': max_nodes    = atol(optarg); break;
+            case 'R':
+                if(!vt::find_generations_rule(optarg, &rule, &states)) {
+                    fprintf(stderr, "Error: unknown rule \"%s\"\n", optarg);
+                    return 1;
+                }
+                rule_given = true;
+                break;
+            case 'N': universe_count = atoi(optarg); break;
+            case 'p': pattern_filename = optarg;     break;
+            case 'S': checkpoint_filename = optarg;  break;
+            case 'I': checkpoint_interval = atoi(optarg); break;
+            case 'L': resume_filename = optarg;      break;
+            case 'O': recording_filename = optarg;   break;
+            case 'K': keyframe_interval = atoi(optarg); break;
+            case 'P': replay_filename = optarg;      break;
+            case 'f': tile_filename  = optarg;       break;
+            case 'M': cache_tiles    = atol(optarg); break;
+            case 'w': process_count  = atoi(optarg); break;
+            case 'W':
+                if(!vt::find_boundary_mode(optarg, &boundary_mode)) {
+                    fprintf(stderr, "Error: unknown boundary mode \"%s\"\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'x': dim.x        = atoi(optarg); break;
+            case 'y': dim.y        = atoi(optarg); break;
+            case 'g':
+                generations       = atoi(optarg);
+                generations_given = true;
+                break;
+            case 'r': random       = true;         break;
+            case 's': seed         = atoi(optarg); break;
+            case 'n': skip_stable  = false;        break;
+            case 'c': cycle_mode   = optarg;       break;
+            case 'v': do_verify    = true;         break;
+            case 'b': do_bench     = true;         break;
+            case 'B': do_bench_blocks = true;      break;
+            case 'h':
+                show_help(argv[0]);
+                return 0;
+            default:
+                show_help(argv[0]);
+                return 1;
+        }
+    }
+    if(dim.x <= 0 || dim.y <= 0 || generations < 0 || universe_count < 1) {
+        fprintf(stderr, "Error: invalid board size, generation count or universe count\n");
+        return 1;
+    }
+    if(!cycle_mode.empty() && ((cycle_mode != "stop" && cycle_mode != "skip") || engine_name != "bitboard")) {
+        fprintf(stderr, "Error: cycle detection is \"stop\" or \"skip\", on the bitboard engine\n");
+        return 1;
+    }
+    if(!pattern_filename.empty() && engine_name == "batch") {
+        fprintf(stderr, "Error: the batch engine draws its own pattern in every universe\n");
+        return 1;
+    }
+    if(boundary_mode != vt::BOUNDARY_DEAD) {
+        if(engine_name != "reference" && engine_name != "bitboard" && engine_name != "generations") {
+            fprintf(stderr, "Error: boundary modes other than \"dead\" need the reference, bitboard or generations engine\n");
+            return 1;
+        }
+        if(block_generations > 1 || do_bench_blocks) {
+            fprintf(stderr, "Error: temporal blocking (-T, -B) needs the \"dead\" boundary mode\n");
+            return 1;
+        }
+    }
+    if(!recording_filename.empty() && !checkpoint_filename.empty()) {
+        fprintf(stderr, "Error: record (-O) or write checkpoints (-S), not both\n");
+        return 1;
+    }
+
+    // NOTE: no engine; the recording has everything
+    if(!replay_filename.empty()) {
+        return replay(replay_filename, generations_given ? generations : -1, checkpoint_filename) ? 0 : 1;
+    }
+
+    // the pattern's own rule, unless one was given
+    if(!pattern_filename.empty()) {
+        vt::pattern_info_t pattern_info;
+        if(!vt::read_pattern_header(pattern_filename, &pattern_info)) {
+            fprintf(stderr, "Error: cannot read pattern \"%s\"\n", pattern_filename.c_str());
+            return 1;
+        }
+        if(!rule_given && pattern_info.has_rule && (pattern_info.states == 2 || engine_name == "generations")) {
+            rule   = pattern_info.rule;
+            states = pattern_info.states;
+        }
+    }
+    // resume from a checkpoint: its board size, rule (unless one was given) and generation counter
+    vt::Snapshot resume_snapshot;
+    if(!checkpoint_filename.empty() || !resume_filename.empty() || !recording_filename.empty()) {
+        if(engine_name != "reference" && engine_name != "bitboard" && engine_name != "generations") {
+            fprintf(stderr, "Error: checkpoints and recordings need the reference, bitboard or generations engine\n");
+            return 1;
+        }
+        if(checkpoint_interval <= 0) {
+            checkpoint_interval = std::max(generations, 1);
+        }
+    }
+    if(!resume_filename.empty()) {
+        if(!resume_snapshot.load(resume_filename)) {
+            fprintf(stderr, "Error: cannot read checkpoint \"%s\"\n", resume_filename.c_str());
+            return 1;
+        }
+        dim = resume_snapshot.get_dim();
+        if(!rule_given) {
+            rule   = resume_snapshot.get_rule();
+            states = resume_snapshot.get_states();
+        }
+        printf("resumed:         generation %llu from %s\n",
+               static_cast<unsigned long long>(resume_snapshot.get_generation()), resume_filename.c_str());
+    }
+    if(states > 2 && engine_name != "generations") {
+        fprintf(stderr, "Error: multi-state rules need the generations engine\n");
+        return 1;
+    }
+    vt::Recorder recorder;
+    if(!recording_filename.empty() && !recorder.open(recording_filename, keyframe_interval)) {
+        fprintf(stderr, "Error: cannot write recording \"%s\"\n", recording_filename.c_str());
+        return 1;
+    }
+    srand(seed);
+
+    // NOTE: handled before the reference engine exists, which would need the whole board in memory
+    if(engine_name == "tiled") {
+        vt::TiledBoard engine(dim, tile_filename, cache_tiles);
+        if(!engine.is_open()) {
+            fprintf(stderr, "Error: cannot map tile file \"%s\"\n", tile_filename.c_str());
+            return 1;
+        }
+        if(!engine.set_rule(rule)) {
+            fprintf(stderr, "Error: the tiled engine does not support B0 rules\n");
+            return 1;
+        }
+        engine.set_kernel_type(kernel_type);
+        if(do_verify) {
+            // no cursor: the tiled board has no seeding
+            vt::ConwayEngine reference(dim);
+            reference.set_rule(rule);
+            reference.set_color(CONWAY_DIE_COLOR);
+            if(!pattern_filename.empty()) {
+                if(!vt::load_pattern_r32f(pattern_filename, reference.get_pixels(), dim)) {
+                    fprintf(stderr, "Error: cannot decode pattern \"%s\"\n", pattern_filename.c_str());
+                    return 1;
+                }
+            } else if(random) {
+                reference.randomize();
+            } else {
+                reference.draw_x();
+            }
+            reference.set_cursor_pos(glm::ivec2(-1));
+            engine.load_r32f(reference.get_pixels());
+            if(!verify_tiled(engine, reference, generations)) {
+                return 1;
+            }
+            printf("verify:          ok (%s)\n", vt::get_life_kernel_name(engine.get_kernel_type()));
+        } else {
+            if(!pattern_filename.empty()) {
+                vt::pattern_info_t pattern_info;
+                if(!vt::load_pattern(pattern_filename, &engine, &pattern_info)) {
+                    fprintf(stderr, "Error: cannot decode pattern \"%s\"\n", pattern_filename.c_str());
+                    return 1;
+                }
+                print_pattern_info(pattern_filename, "tiled board", pattern_info);
+            } else if(random) {
+                engine.randomize();
+            } else {
+                engine.draw_x();
+            }
+            engine.step(generations);
+        }
+        print_stats(engine_name.c_str(),
+                    dim,
+                    engine.get_generation(),
+                    engine.get_elapsed_time(),
+                    engine.get_generations_per_sec(),
+                    engine.get_population());
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        printf("tiles:           %zu occupied of %d (%dx%d cells each)\n",
+               engine.get_occupied_tile_count(), engine.get_tile_count(), TILED_BOARD_TILE_DIM, TILED_BOARD_TILE_DIM);
+        printf("tiles stepped:   %ld\n", engine.get_tiles_stepped());
+        printf("resident:        %zu of %zu cached tiles\n", engine.get_resident_tiles(), engine.get_cache_tiles());
+        printf("paging:          %ld page-ins, %ld evictions, %ld major faults\n",
+               engine.get_page_ins(), engine.get_evictions(), usage.ru_majflt);
+        return 0;
+    }
+
+    vt::ConwayEngine reference(dim);
+    reference.set_rule(rule);
+    reference.set_boundary_mode(boundary_mode);
+
+    // initial pattern (same as init_conway)
+    // NOTE: bitboard and hashlife runs decode the pattern straight into their own board instead, unless verifying
+    reference.set_color(CONWAY_DIE_COLOR);
+    bool direct_pattern = !pattern_filename.empty() && !do_verify && !do_bench && !do_bench_blocks &&
+                          (engine_name == "bitboard" || engine_name == "hashlife");
+    if(!resume_filename.empty()) {
+        resume_snapshot.restore_r32f(reference.get_pixels(), dim);
+    } else if(!pattern_filename.empty() && !direct_pattern) {
+        vt::pattern_info_t pattern_info;
+        if(!vt::load_pattern_r32f(pattern_filename, reference.get_pixels(), dim, &pattern_info)) {
+            fprintf(stderr, "Error: cannot decode pattern \"%s\"\n", pattern_filename.c_str());
+            return 1;
+        }
+        print_pattern_info(pattern_filename, "reference pixels", pattern_info);
+    } else if(random) {
+        reference.randomize();
+    } else {
+        reference.draw_x();
+    }
+
+    // same as main_conway's reset cursor
+    reference.set_cursor_pos(glm::ivec2(0, 0));
+
+    if(do_bench) {
+        bench_kernels(reference, generations);
+        return 0;
+    }
+    if(do_bench_blocks) {
+        vt::ThreadPool* thread_pool = (thread_count >= 0) ? new vt::ThreadPool(thread_count) : NULL;
+        bench_block_generations(reference, generations, thread_pool);
+        if(thread_pool) {
+            delete thread_pool;
+        }
+        return 0;
+    }
+    if(engine_name == "reference") {
+        if(!recording_filename.empty()) {
+            if(!step_with_recording(reference, generations, &recorder, resume_snapshot.get_generation())) {
+                return 1;
+            }
+        } else if(!checkpoint_filename.empty()) {
+            step_with_checkpoints(reference, generations, checkpoint_interval, checkpoint_filename, resume_snapshot.get_generation());
+        } else {
+            reference.step(generations);
+        }
+        print_stats(engine_name.c_str(),
+                    dim,
+                    reference.get_generation(),
+                    reference.get_elapsed_time(),
+                    reference.get_generations_per_sec(),
+                    reference.get_population());
+        printf("boundary:        %s\n", vt::get_boundary_mode_name(reference.get_boundary_mode()));
+        return 0;
+    }
+    if(engine_name == "bitboard") {
+        vt::BitBoard engine(dim);
+        engine.set_rule(rule);
+        engine.set_kernel_type(kernel_type);
+        engine.set_boundary_mode(boundary_mode);
+        engine.set_skip_stable_tiles(skip_stable);
+        engine.set_block_generations(block_generations);
+        if(!resume_filename.empty()) {
+            resume_snapshot.restore(&engine); // straight from the packed bits
+        } else if(direct_pattern) {
+            vt::pattern_info_t pattern_info;
+            if(!vt::load_pattern(pattern_filename, &engine, &pattern_info)) {
+                fprintf(stderr, "Error: cannot decode pattern \"%s\"\n", pattern_filename.c_str());
+                return 1;
+            }
+            print_pattern_info(pattern_filename, "bitboard", pattern_info);
+        } else {
+            engine.load_r32f(reference.get_pixels());
+        }
+        engine.set_cursor_pos(reference.get_cursor_pos());
+        vt::ThreadPool* thread_pool = NULL;
+        if(thread_count >= 0) {
+            thread_pool = new vt::ThreadPool(thread_count);
+            engine.set_thread_pool(thread_pool);
+        }
+        if(!cycle_mode.empty()) {
+            step_until_cycle(engine, generations, cycle_mode == "skip");
+            if(do_verify) {
+                std::vector<float> pixels(dim.x * dim.y);
+                reference.step(engine.get_generation());
+                engine.store_r32f(&pixels[0]);
+                if(memcmp(&pixels[0], reference.get_pixels(), sizeof(float) * pixels.size())) {
+                    fprintf(stderr, "Error: mismatch against reference engine at generation %ld\n", reference.get_generation());
+                    return 1;
+                }
+                printf("verify:          ok (final board only)\n");
+            }
+        } else if(do_verify) {
+            if(!verify(engine, reference, generations, engine.get_block_generations())) {
+                return 1;
+            }
+            printf("verify:          ok (%s, %d generations per tile pass)\n",
+                   vt::get_life_kernel_name(engine.get_kernel_type()),
+                   engine.get_block_generations());
+        } else if(!recording_filename.empty()) {
+            if(!step_with_recording(engine, generations, &recorder, resume_snapshot.get_generation())) {
+                return 1;
+            }
+        } else if(!checkpoint_filename.empty()) {
+            step_with_checkpoints(engine, generations, checkpoint_interval, checkpoint_filename, resume_snapshot.get_generation());
+        } else {
+            engine.step(generations);
+        }
+        print_stats(engine_name.c_str(),
+                    dim,
+                    engine.get_generation(),
+                    engine.get_elapsed_time(),
+                    engine.get_generations_per_sec(),
+                    engine.get_population());
+        printf("boundary:        %s\n", vt::get_boundary_mode_name(engine.get_boundary_mode()));
+        printf("bytes/gen:       %.0f (board buffer traffic)\n", engine.get_bytes_per_generation());
+        if(engine.get_skip_stable_tiles() && engine.get_generation()) {
+            printf("active tiles:    %.2f%% (of %d per generation)\n",
+                   100.0 * engine.get_tiles_stepped() / (static_cast<double>(engine.get_tile_count()) * engine.get_generation()),
+                   engine.get_tile_count());
+        }
+        if(thread_pool) {
+            print_thread_stats(*thread_pool);
+            delete thread_pool;
+        }
+        return 0;
+    }
+    if(engine_name == "batch") {
+        vt::ConwayBatch engine(dim, universe_count);
+        engine.get_board()->set_rule(rule);
+        engine.get_board()->set_kernel_type(kernel_type);
+        engine.get_board()->set_skip_stable_tiles(skip_stable);
+
+        // NOTE: universes draw their random patterns one after another from the same seed
+        std::vector<vt::ConwayEngine*> universes(universe_count);
+        for(int i = 0; i < universe_count; i++) {
+            universes[i] = new vt::ConwayEngine(dim);
+            universes[i]->set_rule(rule);
+            universes[i]->set_color(CONWAY_DIE_COLOR);
+            if(random) {
+                universes[i]->randomize();
+            } else {
+                universes[i]->draw_x();
+            }
+            engine.load_r32f(i, universes[i]->get_pixels());
+        }
+        vt::ThreadPool* thread_pool = NULL;
+        if(thread_count >= 0) {
+            thread_pool = new vt::ThreadPool(thread_count);
+            engine.get_board()->set_thread_pool(thread_pool);
+        }
+        if(do_verify) {
+            if(!verify_batch(engine, universes, generations)) {
+                return 1;
+            }
+            printf("verify:          ok (%d universes)\n", universe_count);
+        } else {
+            engine.step(generations);
+        }
+        std::vector<size_t> populations;
+        engine.get_populations(&populations);
+        print_stats(engine_name.c_str(),
+                    engine.get_atlas_dim(),
+                    engine.get_generation(),
+                    engine.get_elapsed_time(),
+                    engine.get_generations_per_sec(),
+                    std::accumulate(populations.begin(), populations.end(), static_cast<size_t>(0)));
+        printf("universes:       %d of %dx%d (%dx%d grid)\n",
+               universe_count, dim.x, dim.y, engine.get_grid_dim().x, engine.get_grid_dim().y);
+        printf("populations:     %zu min, %zu max, %.1f mean\n",
+               *std::min_element(populations.begin(), populations.end()),
+               *std::max_element(populations.begin(), populations.end()),
+               static_cast<double>(std::accumulate(populations.begin(), populations.end(), static_cast<size_t>(0))) / universe_count);
+
+        // same work, one bitboard per universe
+        if(!do_verify) {
+            double elapsed_time = 0;
+            for(int i = 0; i < universe_count; i++) {
+                vt::BitBoard board(dim);
+                board.set_rule(rule);
+                board.set_kernel_type(kernel_type);
+                board.set_skip_stable_tiles(skip_stable);
+                board.set_thread_pool(thread_pool);
+                board.load_r32f(universes[i]->get_pixels());
+                board.step(generations);
+                elapsed_time += board.get_elapsed_time();
+            }
+            double universe_generations = static_cast<double>(universe_count) * generations;
+            printf("universe gen/s:  %.2f batched, %.2f one bitboard per universe\n",
+                   universe_generations / engine.get_elapsed_time(), universe_generations / elapsed_time);
+        }
+        for(int i = 0; i < universe_count; i++) {
+            delete universes[i];
+        }
+        if(thread_pool) {
+            delete thread_pool;
+        }
+        return 0;
+    }
+    if(engine_name == "generations") {
+        vt::GenerationsEngine engine(dim);
+        engine.set_rule(rule, states);
+        engine.set_boundary_mode(boundary_mode);
+        if(!resume_filename.empty()) {
+            resume_snapshot.restore_r8(engine.get_cells(), dim); // dying states too
+        } else {
+            engine.load_r32f(reference.get_pixels());
+        }
+        engine.set_cursor_pos(reference.get_cursor_pos());
+        if(do_verify) {
+            if(states > 2) {
+                fprintf(stderr, "Error: the reference engine only runs 2-state rules\n");
+                return 1;
+            }
+            if(!verify_generations(engine, reference, generations)) {
+                return 1;
+            }
+            printf("verify:          ok\n");
+        } else if(!recording_filename.empty()) {
+            if(!step_with_recording(engine, generations, &recorder, resume_snapshot.get_generation())) {
+                return 1;
+            }
+        } else if(!checkpoint_filename.empty()) {
+            step_with_checkpoints(engine, generations, checkpoint_interval, checkpoint_filename, resume_snapshot.get_generation());
+        } else {
+            engine.step(generations);
+        }
+        print_stats(engine_name.c_str(),
+                    dim,
+                    engine.get_generation(),
+                    engine.get_elapsed_time(),
+                    engine.get_generations_per_sec(),
+                    engine.get_population());
+        printf("rule:            %s\n", vt::get_generations_rule_string(engine.get_rule(), engine.get_states()).c_str());
+        printf("boundary:        %s\n", vt::get_boundary_mode_name(engine.get_boundary_mode()));
+        printf("bytes/cell:      %d (reference: %d)\n", static_cast<int>(sizeof(uint8_t)), static_cast<int>(sizeof(float)));
+        return 0;
+    }
+    if(engine_name == "strips") {
+        vt::StripBoard engine(dim, process_count);
+        engine.set_rule(rule);
+        engine.set_kernel_type(kernel_type);
+        engine.set_skip_stable_tiles(skip_stable);
+        engine.set_cursor_pos(reference.get_cursor_pos());
+        if(!engine.is_open() || !engine.start() || !engine.load_r32f(reference.get_pixels())) {
+            fprintf(stderr, "Error: cannot set up %d strip processes in shared memory\n", process_count);
+            return 1;
+        }
+        if(do_verify) {
+            if(!verify(engine, reference, generations)) {
+                return 1;
+            }
+            printf("verify:          ok\n");
+        } else if(!engine.step(generations)) {
+            return 1;
+        }
+        print_stats(engine_name.c_str(),
+                    dim,
+                    engine.get_generation(),
+                    engine.get_elapsed_time(),
+                    engine.get_generations_per_sec(),
+                    engine.get_population());
+        printf("%-8s %12s %14s %14s\n", "process", "rows", "compute (sec)", "halo (sec)");
+        for(int i = 0; i < engine.get_process_count(); i++) {
+            printf("%-8d %12d %14.6f %14.6f\n", i,
+                   engine.get_row_begin(i + 1) - engine.get_row_begin(i),
+                   engine.get_compute_time(i), engine.get_halo_time(i));
+        }
+        printf("halo exchange:   %.2f KB through %d rings, %d generations deep\n",
+               engine.get_halo_bytes() / 1024.0, 2 * (engine.get_process_count() - 1), STRIP_BOARD_RING_DEPTH);
+        return 0;
+    }
+    if(engine_name == "hashlife") {
+        vt::HashLife engine(max_nodes);
+        if(!engine.set_rule(rule)) {
+            fprintf(stderr, "Error: hashlife does not support B0 rules\n");
+            return 1;
+        }
+        engine.set_step_log2(step_log2);
+        if(do_verify) {
+            if(!verify_hashlife(engine, reference, generations)) {
+                return 1;
+            }
+            printf("verify:          ok (2^%d generations per step)\n", engine.get_step_log2());
+        } else {
+            if(direct_pattern) {
+                vt::pattern_info_t pattern_info;
+                if(!vt::load_pattern(pattern_filename, &engine, &pattern_info)) {
+                    fprintf(stderr, "Error: cannot decode pattern \"%s\"\n", pattern_filename.c_str());
+                    return 1;
+                }
+                print_pattern_info(pattern_filename, "hashlife quadtree", pattern_info);
+            } else {
+                engine.load_r32f(reference.get_pixels(), dim);
+            }
+            engine.step(generations);
+        }
+        printf("engine:          %s\n",        engine_name.c_str());
+        printf("dim:             %dx%d (unbounded)\n", dim.x, dim.y);
+        printf("generations:     %llu\n",      static_cast<unsigned long long>(engine.get_generation()));
+        printf("elapsed:         %.6f sec\n",  engine.get_elapsed_time());
+        printf("generations/sec: %.2f\n",      engine.get_generations_per_sec());
+        printf("population:      %llu\n",      static_cast<unsigned long long>(engine.get_population()));
+        printf("nodes:           %zu (max %zu, %ld gc)\n", engine.get_node_count(), engine.get_max_nodes(), engine.get_gc_count());
+        printf("result cache:    %ld hits, %ld misses\n", engine.get_result_hits(), engine.get_result_misses());
+        return 0;
+    }
+    fprintf(stderr, "Error: unknown engine \"%s\"\n", engine_name.c_str());
+    return 1;
+}
@@ -9,22 +9,30 @@
 #include <GL/glew.h>
 /* Using the GLUT library for the base windowing setup */
 #include <GL/glut.h>
+#include <Buffer.h>
 #include <Camera.h>
+#include <ChangeCounter.h>
 #include <FrameBuffer.h>
+#include <FrameGovernor.h>
 #include <Material.h>
+#include <MazeSolver.h>
 #include <Mesh.h>
 #include <PrimitiveFactory.h>
+#include <Recording.h>
 #include <Scene.h>
 #include <Texture.h>
 #include <Util.h>
 #include <sstream> // std::stringstream
 #include <iomanip> // std::setprecision
+#include <iostream> // std::cout
+#include <vector> // std::vector
+#include <algorithm> // std::min
 #include <math.h>
 
 #include <cfenv>
 
 #define HI_RES_TEX_DIM (64 - 1)
-#define HALF_DIM       static_cast<int>(HI_RES_TEX_DIM * 0.5)
+#define HALF_DIM       static_cast<int>(HI_RES_TEX_DIM * 0.5) // NOTE: HALF_DIM * 2 must match SPAWN_DIM in "src/shaders/overlay_maze_sprites.f.glsl"
 #define SPRITE_COUNT   10
 #define EMPTY_COLOR    0.0
 #define SPRITE_COLOR   0.25
@@ -35,7 +43,20 @@
 #define GROW_PERIOD    10
 
 #define SPRITE_VELOCITY       1
-#define SPRITE_ANGLE_VELOCITY (PI * 0.1)
+#define SPRITE_ANGLE_VELOCITY (PI * 0.1) // NOTE: must match "src/shaders/overlay_maze_sprites.f.glsl"
+
+#define MAZE_RECORDING_FILE "maze.rec"
+#define MAZE_MAX_ITERS_PER_FRAME 256
+#define MAZE_FLOOD_RADIUS 4 // NOTE: must match "src/shaders/overlay_maze_distfield_flood.f.glsl"
+#define MAZE_TREE_LEVELS 13 // ancestor levels, 2^(MAZE_TREE_LEVELS - 1) hops or more up to the root
+                            // NOTE: must match "src/shaders/overlay_maze_tree.f.glsl" and
+                            //       "src/shaders/overlay_maze_distfield_tree.f.glsl"
+#define MAZE_DECAY_TEX_DIM 4096 // field value by distance, longer than any path on the board
+                                // NOTE: must match "src/shaders/overlay_maze_decay.f.glsl" and
+                                //       "src/shaders/overlay_maze_distfield_tree.f.glsl"
+#define MAZE_SPRITE_TEX_DIM 256 // sprite state texture is square, one texel per sprite
+#define MAZE_MAX_SPRITES (MAZE_SPRITE_TEX_DIM * MAZE_SPRITE_TEX_DIM)
+#define MAZE_RANDOM_SEED_PERIOD 65536 // keeps the shaders' hash inputs exact in a float
 
 const char* DEFAULT_CAPTION = "";
 
@@ -45,14 +66,49 @@ vt::Camera* camera = NULL;
 vt::Mesh *mesh = NULL;
 vt::Texture *maze_pattern_texture = NULL, // input/output
             *maze_texture         = NULL, // input/output
-            *maze_texture2        = NULL; // input/output
+            *maze_texture2        = NULL, // input/output
+            *maze_changed_texture = NULL, // output, never read
+            *maze_sprite_texture  = NULL, // input/output
+            *maze_sprite_texture2 = NULL, // input/output
+            *maze_occupancy_texture = NULL, // output, input to the distfield pass
+            *maze_occupancy_texture2 = NULL, // output, the previous sprite pass's occupancy
+            *maze_tree_texture    = NULL, // input/output, MAZE_TREE_LEVELS boards tall
+            *maze_tree_texture2   = NULL, // input/output
+            *maze_decay_texture   = NULL; // output, input to the tree distfield pass
 vt::Material *write_through_material  = NULL,
              *maze_heatmap_material   = NULL,
              *maze_prune_material     = NULL,
              *maze_grow_material      = NULL,
-             *maze_distfield_material = NULL;
+             *maze_distfield_material = NULL,
+             *maze_distfield_flood_material = NULL, // MAZE_FLOOD_RADIUS distfield steps per pass
+             *maze_distfield_tree_material  = NULL, // whole distance field in one pass, from the maze tree
+             *maze_tree_material      = NULL, // one pointer-jumping pass over the maze tree
+             *maze_decay_material     = NULL, // field value by distance
+             *maze_changed_material   = NULL,
+             *maze_sprites_material   = NULL,
+             *maze_occupancy_material = NULL; // drawn as points, one per sprite
 vt::FrameBuffer *maze_fb  = NULL, // input/output
-                *maze_fb2 = NULL; // input/output
+                *maze_fb2 = NULL, // input/output
+                *maze_changed_fb = NULL, // output, for counting changed texels
+                *maze_sprite_fb  = NULL, // input/output
+                *maze_sprite_fb2 = NULL, // input/output
+                *maze_occupancy_fb = NULL, // output
+                *maze_occupancy_fb2 = NULL, // output
+                *maze_tree_fb  = NULL, // input/output
+                *maze_tree_fb2 = NULL, // input/output
+                *maze_decay_fb = NULL; // output
+vt::Recorder maze_recorder; // every ping-pong frame while open
+vt::Snapshot maze_record_frame; // reused capture buffer
+long maze_frame = 0; // ping-pong swaps so far, the recording's generation counter
+vt::FrameGovernor* frame_governor = NULL; // iterations per frame from measured gpu/cpu time, if use_frame_governor
+int maze_frame_iters = 0; // conduct_maze_iter() calls in the last frame
+glm::ivec2 maze_seed_pos(-1); // cursor in texels as of the last distfield pass
+vt::ChangeCounter* maze_change_counter = NULL; // fixed point of the current phase's pass, reset on phase change
+vt::ChangeCounter* maze_sprite_change_counter = NULL; // occupied texels changed by the sprite passes
+int maze_sprite_passes = 0; // seeds the sprite pass's random numbers
+int maze_sprite_count = SPRITE_COUNT; // up to MAZE_MAX_SPRITES
+glm::vec2* maze_sprite_point_coords_arr = NULL; // texel center of each sprite in the sprite state texture
+vt::Buffer* maze_sprite_point_coords = NULL; // the same, on the gpu
 
 bool left_mouse_down  = false,
      right_mouse_down = false;
@@ -60,7 +116,10 @@ glm::vec2 prev_mouse_coord,
           mouse_drag;
 float orbit_radius = 8;
 bool show_fps      = false,
-     do_animation  = true;
+     do_animation  = true,
+     use_frame_governor = false, // one iteration per frame unless set
+     use_flood = true, // flood the distance field until it settles
+     use_tree  = true; // redraw the distance field from the maze tree when the seed moves
 
 enum maze_phases_t {
     MAZE_PHASE_GEN,
@@ -78,36 +137,7 @@ bool skip_prune = true,
 // generate maze using Prim's algorithm
 void gen_maze_pattern(vt::Texture *texture)
 {
-    texture->set_color_r32f(WALL_COLOR); // clear
-    for(int y = 1; y < HI_RES_TEX_DIM; y += 2) {
-        for(int x = 1; x < HI_RES_TEX_DIM; x += 2) {
-            texture->set_pixel_r32f(glm::ivec2(x, y), EMPTY_COLOR);
-        }
-    }
-    bool visited[HALF_DIM][HALF_DIM];
-    std::vector<glm::ivec2> frontier;
-    frontier.push_back(glm::ivec2(rand() / (static_cast<float>(RAND_MAX) + 1) * HALF_DIM,
-                                  rand() / (static_cast<float>(RAND_MAX) + 1) * HALF_DIM));
-    glm::ivec2 offset_4[] = {
-        glm::ivec2( 0,  1), // n
-        glm::ivec2( 0, -1), // s
-        glm::ivec2( 1,  0), // e
-        glm::ivec2(-1,  0)  // w
-        };
-    glm::ivec2 halfdim_min(0), halfdim_max(HALF_DIM - 1);
-    while(frontier.size()) {
-        int seed_index = rand() / (static_cast<float>(RAND_MAX) + 1) * frontier.size();
-        glm::ivec2 seed = frontier[seed_index];
-        for(int i = 0; i < 4; i++) {
-            glm::ivec2 sample = glm::clamp(seed + offset_4[i], halfdim_min, halfdim_max);
-            if(sample != seed && !visited[sample.x][sample.y]) {
-                texture->set_pixel_r32f(glm::ivec2(1) + sample * 2 - offset_4[i], EMPTY_COLOR);
-                frontier.push_back(sample);
-                visited[sample.x][sample.y] = true;
-            }
-        }
-        frontier.erase(frontier.begin() + seed_index);
-    }
+    vt::gen_maze_r32f(reinterpret_cast<float*>(texture->get_pixels()), glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
     //texture->draw_frame();
 }
 
@@ -134,6 +164,8 @@ void init_prune_maze()
     // download from gpu (very slow)
     maze_texture->refresh();
     maze_texture2->refresh();
+
+    maze_change_counter->reset();
 }
 
 void init_grow_maze()
@@ -141,26 +173,86 @@ void init_grow_maze()
     // download from gpu (very slow)
     maze_texture->refresh();
     maze_texture2->refresh();
+
+    maze_change_counter->reset();
 }
 
 void init_sprites()
 {
     vt::Scene* scene = vt::Scene::instance();
 
-    for(int i = 0; i < SPRITE_COUNT; i++) {
-        glm::ivec2 respawn_point;
-        do {
-            respawn_point = glm::ivec2(rand() / (static_cast<float>(RAND_MAX) + 1) * HALF_DIM * 2,
-                                       rand() / (static_cast<float>(RAND_MAX) + 1) * HALF_DIM * 2);
-        } while(maze_texture->get_pixel_r32f(respawn_point) == WALL_COLOR);
-        scene->set_sprite_pos(i, glm::vec2(respawn_point));
+    // spawned on the gpu by the next sprite pass (see "src/shaders/overlay_maze_sprites.f.glsl")
+    maze_sprite_texture->set_color_rgba32f(glm::vec4(-1, -1, 0, SPRITE_VELOCITY));
+    maze_sprite_texture2->set_color_rgba32f(glm::vec4(-1, -1, 0, SPRITE_VELOCITY));
+
+    // upload to gpu
+    maze_sprite_texture->update();
+    maze_sprite_texture2->update();
+
+    // no sprite is spawned yet, so no texel is occupied
+    maze_occupancy_texture->set_color_r32f(0);
+    maze_occupancy_texture->update();
+    maze_occupancy_texture2->set_color_r32f(0);
+    maze_occupancy_texture2->update();
+
+    scene->set_sprite_texture(maze_sprite_fb->get_texture());
+    scene->set_sprite_count(maze_sprite_count);
+    maze_sprite_change_counter->reset();
+    maze_change_counter->reset(); // sprites are stamped into the distance field
+}
+
+// parent links on the cpu, then MAZE_TREE_LEVELS - 1 pointer-jumping passes for the ancestor levels (see
+// "src/shaders/overlay_maze_tree.f.glsl"); O(log(longest path)) passes where the distfield pass takes O(longest path)
+void build_maze_tree(vt::Scene* scene)
+{
+    vt::Mesh* mesh = scene->get_overlay();
+    vt::Material* prev_material = mesh->get_material();
+    int prev_texture_index = mesh->get_texture_index();
+
+    // every level starts as the parent links
+    glm::ivec2 board_dim(HI_RES_TEX_DIM, HI_RES_TEX_DIM);
+    float* tree_pixels = reinterpret_cast<float*>(maze_tree_fb->get_texture()->get_pixels());
+    size_t level_floats = board_dim.x * board_dim.y * 4;
+    vt::gen_maze_tree_rgba32f(reinterpret_cast<const float*>(maze_pattern_texture->get_pixels()), board_dim, tree_pixels);
+    for(int i = 1; i < MAZE_TREE_LEVELS; i++) {
+        std::copy(tree_pixels, tree_pixels + level_floats, tree_pixels + i * level_floats);
     }
-    scene->set_sprite_count(SPRITE_COUNT);
-    int sprite_count = scene->get_sprite_count();
-    for(int i = 0; i < sprite_count; i++) {
-        scene->set_sprite_velocity(i, SPRITE_VELOCITY);
-        scene->set_sprite_angle_velocity(i, SPRITE_ANGLE_VELOCITY);
+    maze_tree_fb->get_texture()->update(); // upload to gpu (very slow)
+
+    // enter gpu kernel
+    camera->set_image_res(maze_tree_fb->get_texture()->get_dim());
+    mesh->set_material(maze_tree_material);
+    for(int i = 1; i < MAZE_TREE_LEVELS; i++) {
+        maze_tree_fb2->bind();
+        mesh->set_texture_index(mesh->get_material()->get_texture_index(maze_tree_fb->get_texture()));
+        scene->render(false, true);
+        maze_tree_fb2->unbind();
+        std::swap(maze_tree_fb, maze_tree_fb2); // the elusive ping-pong swap
     }
+    camera->set_image_res(board_dim);
+    mesh->set_material(prev_material);
+    mesh->set_texture_index(prev_texture_index);
+}
+
+// the distfield pass's value at each distance from the seed, for the tree pass to look up (see
+// "src/shaders/overlay_maze_decay.f.glsl")
+void build_maze_decay(vt::Scene* scene)
+{
+    vt::Mesh* mesh = scene->get_overlay();
+    vt::Material* prev_material = mesh->get_material();
+    int prev_texture_index = mesh->get_texture_index();
+
+    // enter gpu kernel
+    // NOTE: the shader reads no textures, the texture index only has to be valid
+    camera->set_image_res(maze_decay_fb->get_texture()->get_dim());
+    mesh->set_material(maze_decay_material);
+    mesh->set_texture_index(0);
+    maze_decay_fb->bind();
+    scene->render(false, true);
+    maze_decay_fb->unbind();
+    camera->set_image_res(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
+    mesh->set_material(prev_material);
+    mesh->set_texture_index(prev_texture_index);
 }
 
 void init_distfield_maze()
@@ -175,6 +267,12 @@ void init_distfield_maze()
     maze_texture->update();
     maze_texture2->update();
 
+    // for flooding
+    maze_seed_pos = glm::ivec2(-1); // flood from scratch
+    maze_change_counter->reset();
+    build_maze_decay(vt::Scene::instance()); // NOTE: independent of the maze, but cheap next to the tree
+    build_maze_tree(vt::Scene::instance());
+
     // for sprites
     init_sprites();
 }
@@ -201,12 +299,14 @@ int init_resources()
                                            vt::Texture::RED,
                                            glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
                                            false); // no lerp (need exact values)
+    maze_pattern_texture->set_boundary_mode(vt::BOUNDARY_DEAD); // off-board texels read as empty
 
     // input/output
     maze_texture = new vt::Texture("maze",
                                    vt::Texture::RED,
                                    glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
                                    false); // no lerp (need exact values)
+    maze_texture->set_boundary_mode(vt::BOUNDARY_DEAD);
     maze_fb = new vt::FrameBuffer(maze_texture, camera);
 
     // input/output
@@ -214,8 +314,86 @@ int init_resources()
                                     vt::Texture::RED,
                                     glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
                                     false); // no lerp (need exact values)
+    maze_texture2->set_boundary_mode(vt::BOUNDARY_DEAD);
     maze_fb2 = new vt::FrameBuffer(maze_texture2, camera);
 
+    // output
+    maze_changed_texture = new vt::Texture("maze_changed",
+                                           vt::Texture::RED,
+                                           glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
+                                           false); // no lerp (need exact values)
+    maze_changed_fb = new vt::FrameBuffer(maze_changed_texture, camera);
+
+    // zeroed, so the sprite state is defined before init_sprites() marks every sprite unspawned
+    std::vector<float> zero_sprite_state(MAZE_MAX_SPRITES * 4, 0);
+
+    // input/output
+    maze_sprite_texture = new vt::Texture("maze_sprites",
+                                          vt::Texture::RGBA32F,
+                                          glm::ivec2(MAZE_SPRITE_TEX_DIM, MAZE_SPRITE_TEX_DIM),
+                                          false, // no lerp (need exact values)
+                                          vt::Texture::RGBA32F,
+                                          reinterpret_cast<const unsigned char*>(&zero_sprite_state[0]));
+    maze_sprite_fb = new vt::FrameBuffer(maze_sprite_texture, camera);
+
+    // input/output
+    maze_sprite_texture2 = new vt::Texture("maze_sprites2",
+                                           vt::Texture::RGBA32F,
+                                           glm::ivec2(MAZE_SPRITE_TEX_DIM, MAZE_SPRITE_TEX_DIM),
+                                           false, // no lerp (need exact values)
+                                           vt::Texture::RGBA32F,
+                                           reinterpret_cast<const unsigned char*>(&zero_sprite_state[0]));
+    maze_sprite_fb2 = new vt::FrameBuffer(maze_sprite_texture2, camera);
+
+    // output
+    maze_occupancy_texture = new vt::Texture("maze_occupancy",
+                                             vt::Texture::RED,
+                                             glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
+                                             false); // no lerp (need exact values)
+    maze_occupancy_texture->set_boundary_mode(vt::BOUNDARY_DEAD);
+    maze_occupancy_fb = new vt::FrameBuffer(maze_occupancy_texture, camera);
+    scene->set_occupancy_texture(maze_occupancy_texture);
+
+    // output
+    maze_occupancy_texture2 = new vt::Texture("maze_occupancy2",
+                                              vt::Texture::RED,
+                                              glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
+                                              false); // no lerp (need exact values)
+    maze_occupancy_texture2->set_boundary_mode(vt::BOUNDARY_DEAD);
+    maze_occupancy_fb2 = new vt::FrameBuffer(maze_occupancy_texture2, camera);
+
+    // input/output
+    maze_tree_texture = new vt::Texture("maze_tree",
+                                        vt::Texture::RGBA32F,
+                                        glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM * MAZE_TREE_LEVELS),
+                                        false); // no lerp (need exact values)
+    maze_tree_fb = new vt::FrameBuffer(maze_tree_texture, camera);
+
+    // input/output
+    maze_tree_texture2 = new vt::Texture("maze_tree2",
+                                         vt::Texture::RGBA32F,
+                                         glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM * MAZE_TREE_LEVELS),
+                                         false); // no lerp (need exact values)
+    maze_tree_fb2 = new vt::FrameBuffer(maze_tree_texture2, camera);
+
+    // output
+    maze_decay_texture = new vt::Texture("maze_decay",
+                                         vt::Texture::RED,
+                                         glm::ivec2(MAZE_DECAY_TEX_DIM, 1),
+                                         false); // no lerp (need exact values)
+    maze_decay_fb = new vt::FrameBuffer(maze_decay_texture, camera);
+    scene->set_decay_texture(maze_decay_texture);
+
+    // one point per sprite, in sprite index order
+    maze_sprite_point_coords_arr = new glm::vec2[MAZE_MAX_SPRITES];
+    for(int i = 0; i < MAZE_MAX_SPRITES; i++) {
+        maze_sprite_point_coords_arr[i] = (glm::vec2(i % MAZE_SPRITE_TEX_DIM, i / MAZE_SPRITE_TEX_DIM) + glm::vec2(0.5)) /
+                                          static_cast<float>(MAZE_SPRITE_TEX_DIM);
+    }
+    maze_sprite_point_coords = new vt::Buffer(GL_ARRAY_BUFFER,
+                                              sizeof(glm::vec2) * MAZE_MAX_SPRITES,
+                                              maze_sprite_point_coords_arr);
+
     //==========
     // materials
     //==========
@@ -268,8 +446,83 @@ int init_resources()
     maze_distfield_material->add_texture(maze_pattern_texture);
     maze_distfield_material->add_texture(maze_texture);
     maze_distfield_material->add_texture(maze_texture2);
+    maze_distfield_material->add_texture(maze_occupancy_texture);
+    maze_distfield_material->add_texture(maze_occupancy_texture2);
     scene->add_material(maze_distfield_material);
 
+    // for distfield flooding
+    maze_distfield_flood_material = new vt::Material("maze_distfield_flood",
+                                                     "src/shaders/overlay_maze_distfield.v.glsl",
+                                                     "src/shaders/overlay_maze_distfield_flood.f.glsl",
+                                                     true); // use_overlay
+    maze_distfield_flood_material->add_texture(maze_pattern_texture);
+    maze_distfield_flood_material->add_texture(maze_texture);
+    maze_distfield_flood_material->add_texture(maze_texture2);
+    maze_distfield_flood_material->add_texture(maze_occupancy_texture);
+    maze_distfield_flood_material->add_texture(maze_occupancy_texture2);
+    scene->add_material(maze_distfield_flood_material);
+
+    // for distfield from the maze tree
+    maze_distfield_tree_material = new vt::Material("maze_distfield_tree",
+                                                    "src/shaders/overlay_maze_distfield.v.glsl",
+                                                    "src/shaders/overlay_maze_distfield_tree.f.glsl",
+                                                    true); // use_overlay
+    maze_distfield_tree_material->add_texture(maze_pattern_texture);
+    maze_distfield_tree_material->add_texture(maze_tree_texture);
+    maze_distfield_tree_material->add_texture(maze_tree_texture2);
+    maze_distfield_tree_material->add_texture(maze_occupancy_texture);
+    maze_distfield_tree_material->add_texture(maze_occupancy_texture2);
+    maze_distfield_tree_material->add_texture(maze_decay_texture);
+    scene->add_material(maze_distfield_tree_material);
+
+    // for building the maze tree
+    maze_tree_material = new vt::Material("maze_tree",
+                                          "src/shaders/overlay_maze_distfield.v.glsl",
+                                          "src/shaders/overlay_maze_tree.f.glsl",
+                                          true); // use_overlay
+    maze_tree_material->add_texture(maze_tree_texture);
+    maze_tree_material->add_texture(maze_tree_texture2);
+    scene->add_material(maze_tree_material);
+
+    // for the tree distfield pass's values by distance
+    maze_decay_material = new vt::Material("maze_decay",
+                                           "src/shaders/overlay_maze_distfield.v.glsl",
+                                           "src/shaders/overlay_maze_decay.f.glsl",
+                                           true); // use_overlay
+    maze_decay_material->add_texture(maze_decay_texture);
+    scene->add_material(maze_decay_material);
+
+    // for fixed point detection
+    maze_changed_material = new vt::Material("maze_changed",
+                                             "src/shaders/overlay_maze_distfield.v.glsl",
+                                             "src/shaders/overlay_maze_changed.f.glsl",
+                                             true); // use_overlay
+    maze_changed_material->add_texture(maze_texture);
+    maze_changed_material->add_texture(maze_texture2);
+    maze_changed_material->add_texture(maze_occupancy_texture);
+    maze_changed_material->add_texture(maze_occupancy_texture2);
+    scene->add_material(maze_changed_material);
+
+    // for moving sprites
+    maze_sprites_material = new vt::Material("maze_sprites",
+                                             "src/shaders/overlay_maze_distfield.v.glsl",
+                                             "src/shaders/overlay_maze_sprites.f.glsl",
+                                             true); // use_overlay
+    maze_sprites_material->add_texture(maze_sprite_texture);
+    maze_sprites_material->add_texture(maze_sprite_texture2);
+    maze_sprites_material->add_texture(maze_texture);
+    maze_sprites_material->add_texture(maze_texture2);
+    scene->add_material(maze_sprites_material);
+
+    // for splatting sprites
+    maze_occupancy_material = new vt::Material("maze_occupancy",
+                                               "src/shaders/overlay_maze_occupancy.v.glsl",
+                                               "src/shaders/overlay_maze_occupancy.f.glsl",
+                                               true); // use_overlay
+    maze_occupancy_material->add_texture(maze_sprite_texture);
+    maze_occupancy_material->add_texture(maze_sprite_texture2);
+    scene->add_material(maze_occupancy_material);
+
     //==============
     // scene setup 2
     //==============
@@ -280,11 +533,30 @@ int init_resources()
     mesh->set_texture_index(mesh->get_material()->get_texture_index_by_name("maze"));
     scene->set_overlay(mesh);
 
+    frame_governor = new vt::FrameGovernor(FRAME_GOVERNOR_DEFAULT_FPS, MAZE_MAX_ITERS_PER_FRAME);
+    maze_change_counter = new vt::ChangeCounter();
+    maze_sprite_change_counter = new vt::ChangeCounter();
+
     return 1;
 }
 
 int deinit_resources()
 {
+    if(frame_governor) {
+        delete frame_governor;
+    }
+    if(maze_change_counter) {
+        delete maze_change_counter;
+    }
+    if(maze_sprite_change_counter) {
+        delete maze_sprite_change_counter;
+    }
+    if(maze_sprite_point_coords) {
+        delete maze_sprite_point_coords;
+    }
+    if(maze_sprite_point_coords_arr) {
+        delete[] maze_sprite_point_coords_arr;
+    }
     return 1;
 }
 
@@ -293,6 +565,25 @@ void onIdle()
     glutPostRedisplay();
 }
 
+// counts the texels a pass changed from input_texture to output_texture (see ChangeCounter)
+// NOTE: drawn into a texture of its own, since neither ping-pong texture can be sampled while it is bound for output
+void count_maze_changes(vt::Scene*         scene,
+                        vt::Texture*       input_texture,  // IN
+                        vt::Texture*       output_texture, // IN
+                        vt::ChangeCounter* change_counter)
+{
+    vt::Mesh* mesh = scene->get_overlay();
+
+    maze_changed_fb->bind();
+    mesh->set_material(maze_changed_material);
+    mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
+    mesh->set_texture2_index(mesh->get_material()->get_texture_index(output_texture));
+    change_counter->begin();
+    scene->render(false, true);
+    change_counter->end();
+    maze_changed_fb->unbind();
+}
+
 void do_maze_prune_iter(vt::Scene*       scene,
                         vt::Texture*     input_texture, // IN
                         vt::FrameBuffer* output_fb)     // OUT
@@ -310,6 +601,7 @@ void do_maze_prune_iter(vt::Scene*       scene,
         mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
         scene->render(false, true);
         output_fb->unbind();
+        count_maze_changes(scene, input_texture, output_texture, maze_change_counter);
 
         // switch to write-through mode to display final output texture
 #if 1
@@ -340,6 +632,7 @@ void do_maze_grow_iter(vt::Scene*       scene,
         mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
         scene->render(false, true);
         output_fb->unbind();
+        count_maze_changes(scene, input_texture, output_texture, maze_change_counter);
 
         // switch to write-through mode to display final output texture
 #if 1
@@ -353,115 +646,144 @@ void do_maze_grow_iter(vt::Scene*       scene,
     count++;
 }
 
-void do_maze_distfield_iter(vt::Scene*       scene,
-                            vt::Texture*     input_texture, // IN
-                            vt::FrameBuffer* output_fb)     // OUT
+// one point per sprite, drawn at the texel the sprite occupies (see "src/shaders/overlay_maze_occupancy.v.glsl"), so
+// the distfield pass looks up one texel instead of looping over every sprite
+// NOTE: the occupancy is compared with the previous sprite pass's under maze_sprite_change_counter, so the distance
+//       field is only redone when a sprite moves to another texel
+void splat_maze_occupancy(vt::Scene* scene)
 {
     vt::Mesh* mesh = scene->get_overlay();
-    vt::Texture* output_texture = output_fb->get_texture();
 
     // enter gpu kernel
-    output_fb->bind();
-    mesh->set_material(maze_distfield_material);
+    maze_occupancy_fb2->bind();
+    mesh->set_material(maze_occupancy_material);
+    scene->set_overlay_points(maze_sprite_point_coords, scene->get_sprite_count());
+    scene->render(true, true); // clear to unoccupied
+    scene->set_overlay_points(NULL, 0);
+    maze_occupancy_fb2->unbind();
+    count_maze_changes(scene, maze_occupancy_fb->get_texture(), maze_occupancy_fb2->get_texture(), maze_sprite_change_counter);
+    std::swap(maze_occupancy_fb, maze_occupancy_fb2); // the elusive ping-pong swap
+    scene->set_occupancy_texture(maze_occupancy_fb->get_texture());
+}
+
+// one fragment per sprite, in a MAZE_SPRITE_TEX_DIM x MAZE_SPRITE_TEX_DIM ping-pong pair of sprite states (see
+// "src/shaders/overlay_maze_sprites.f.glsl"); nothing is read back
+void do_maze_sprites_iter(vt::Scene*   scene,
+                          vt::Texture* field_texture) // IN
+{
+    vt::Mesh* mesh = scene->get_overlay();
+    vt::Texture* input_texture = maze_sprite_fb->get_texture();
+
+    // enter gpu kernel
+    maze_sprite_passes = (maze_sprite_passes + 1) % MAZE_RANDOM_SEED_PERIOD;
+    scene->set_random_seed(maze_sprite_passes);
+    camera->set_image_res(input_texture->get_dim());
+    maze_sprite_fb2->bind();
+    mesh->set_material(maze_sprites_material);
     mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
-    mesh->set_texture2_index(mesh->get_material()->get_texture_index(maze_pattern_texture));
+    mesh->set_texture2_index(mesh->get_material()->get_texture_index(field_texture));
     scene->render(false, true);
-    output_fb->unbind();
+    maze_sprite_fb2->unbind();
+    camera->set_image_res(glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM));
+    std::swap(maze_sprite_fb, maze_sprite_fb2); // the elusive ping-pong swap
+    scene->set_sprite_texture(maze_sprite_fb->get_texture());
+    splat_maze_occupancy(scene);
+}
 
-    // switch to write-through mode to display final output texture
-#if 1
-    mesh->set_material(maze_heatmap_material);
-#else
-    mesh->set_material(write_through_material);
-#endif
-    mesh->set_texture_index(mesh->get_material()->get_texture_index(output_texture));
+// returns false if the field had settled and only the sprites moved
+bool do_maze_distfield_iter(vt::Scene*       scene,
+                            vt::Texture*     input_texture, // IN
+                            vt::FrameBuffer* output_fb)     // OUT
+{
+    vt::Mesh* mesh = scene->get_overlay();
+    vt::Texture* output_texture = output_fb->get_texture();
+
+    // the pass sees the cursor and the sprites, but not whether they moved
+    // NOTE: same texel mapping as the shaders
+    glm::ivec2 viewport_dim = camera->get_dim();
+    glm::ivec2 cursor_pos = scene->get_cursor_pos();
+    glm::ivec2 seed_pos(static_cast<int>(static_cast<float>(cursor_pos.x) / viewport_dim.x * HI_RES_TEX_DIM),
+                        static_cast<int>(static_cast<float>(cursor_pos.y) / viewport_dim.y * HI_RES_TEX_DIM));
+    bool use_tree_pass = false;
+    if(seed_pos != maze_seed_pos) {
+        maze_seed_pos = seed_pos;
+        maze_change_counter->reset();
+        use_tree_pass = use_tree &&
+                        seed_pos.x >= 0 && seed_pos.x < HI_RES_TEX_DIM && seed_pos.y >= 0 && seed_pos.y < HI_RES_TEX_DIM &&
+                        maze_pattern_texture->get_pixel_r32f(seed_pos) != WALL_COLOR;
+    }
+
+    // the field moves one cell per step, so a new seed takes as many steps as its longest path to reach every
+    // cell (and to outweigh the old seed's peak); until the field settles, take MAZE_FLOOD_RADIUS steps per pass
+    // NOTE: a new seed on a free cell instead gets the whole field in one tree pass, exact for a maze without loops;
+    //       the distfield passes that follow route around the sprites, and where grow left loops the tree's paths
+    //       can be too long, so those passes raise the field there in O(path) passes as without the tree
+    bool run_pass = !maze_change_counter->is_settled();
+    vt::Texture* field_texture = input_texture; // latest distance field
+    if(run_pass) {
+        // enter gpu kernel
+        output_fb->bind();
+        if(use_tree_pass) {
+            mesh->set_material(maze_distfield_tree_material);
+            mesh->set_texture_index(mesh->get_material()->get_texture_index(maze_tree_fb->get_texture()));
+        } else {
+            mesh->set_material(use_flood ? maze_distfield_flood_material : maze_distfield_material);
+            mesh->set_texture_index(mesh->get_material()->get_texture_index(input_texture));
+        }
+        mesh->set_texture2_index(mesh->get_material()->get_texture_index(maze_pattern_texture));
+        scene->render(false, true);
+        output_fb->unbind();
+        count_maze_changes(scene, input_texture, output_texture, maze_change_counter);
+        field_texture = output_texture;
+    }
 
     // move sprites along distance field gradient
     static int count = 0;
     if(count == SPRITE_PERIOD) {
-        glm::ivec2 offset_8[] = {
-            glm::ivec2( 0,  1), // n
-            glm::ivec2( 1,  1), // ne
-            glm::ivec2( 1,  0), // e
-            glm::ivec2( 1, -1), // se
-            glm::ivec2( 0, -1), // s
-            glm::ivec2(-1, -1), // sw
-            glm::ivec2(-1,  0), // w
-            glm::ivec2(-1,  1)  // nw
-            };
-        maze_texture->refresh(); // download from gpu (very slow; unfortunately, we do it on the cpu)
-        int sprite_count = scene->get_sprite_count();
-        for(int i = 0; i < sprite_count; i++) {
-            glm::vec2 pos = scene->get_sprite_pos(i);
-            float max_value = std::min(WALL_COLOR, SEED_COLOR);
-            float min_value = std::max(WALL_COLOR, SEED_COLOR);
-            glm::vec2 max_offset;
-            glm::vec2 min_offset;
-            for(int j = 0; j < 8; j++) {
-                glm::vec2 move_to_point = glm::normalize(glm::vec2(offset_8[j]));
-                float value_neighbor = maze_texture->get_pixel_r32f(glm::ivec2(pos + move_to_point));
-                if(value_neighbor == WALL_COLOR || value_neighbor == SPRITE_COLOR) {
-                    continue;
-                }
-                if(value_neighbor > max_value) {
-                    max_value  = value_neighbor;
-                    max_offset = move_to_point;
-                }
-                if(value_neighbor < min_value) {
-                    min_value  = value_neighbor;
-                    min_offset = move_to_point;
-                }
-            }
-            if(fabs(max_value - SEED_COLOR) < EPSILON) { // respawn if near target
-                glm::ivec2 respawn_point;
-                do {
-                    respawn_point = glm::ivec2(rand() / (static_cast<float>(RAND_MAX) + 1) * HALF_DIM * 2,
-                                               rand() / (static_cast<float>(RAND_MAX) + 1) * HALF_DIM * 2);
-                } while(maze_texture->get_pixel_r32f(respawn_point) == WALL_COLOR);
-                scene->set_sprite_pos(i, glm::vec2(respawn_point));
-                continue;
-            }
-            if(max_value == min_value) { // equally attractive choices
-                glm::vec2 move_to_point;
-                do {
-                    int seed_index = rand() / (static_cast<float>(RAND_MAX) + 1) * 8; // pick one at random
-                    move_to_point = glm::normalize(glm::vec2(offset_8[seed_index]));
-                } while(maze_texture->get_pixel_r32f(glm::ivec2(pos + move_to_point)) == WALL_COLOR);
-                scene->set_sprite_pos(i, pos + move_to_point);
-                continue;
-            }
+        do_maze_sprites_iter(scene, field_texture);
+        count = 0;
+    } else {
+        count++;
+    }
+
+    // sprites are stamped into the distance field, so it is redone while the latest counted sprite pass moved one
+    // to another texel (or none has been counted since the sprites were reset)
+    if(!maze_sprite_change_counter->is_settled()) {
+        maze_change_counter->reset();
+    }
+
+    // switch to write-through mode to display final output texture
 #if 1
-            // simple path finding
-            scene->set_sprite_pos(i, pos + max_offset);
+    mesh->set_material(maze_heatmap_material);
 #else
-            // fancy path finding (limit turning speed)
-            float target_angle   = -atan2(max_offset.x, max_offset.y) + PI * 0.5;
-            float angle          = scene->get_sprite_angle(i);
-                  angle          = glm::radians(vt::angle_modulo(glm::degrees(angle)));
-            float angle_velocity = scene->get_sprite_angle_velocity(i);
-            int   turn_polarity  = (fabs(target_angle - angle) < PI ? 1 : -1);
-            if(target_angle > angle) {
-                angle += angle_velocity * turn_polarity;
-            } else if(target_angle < angle) {
-                angle -= angle_velocity * turn_polarity;
-            }
-            scene->set_sprite_angle(i, angle);
-            glm::vec2 new_pos(pos + glm::vec2(cos(angle), sin(angle)) * scene->get_sprite_velocity(i));
-            if(maze_texture->get_pixel_r32f(glm::ivec2(new_pos)) == WALL_COLOR) {
-                scene->set_sprite_pos(i, pos + max_offset); // to prevent going through walls
-                continue;
-            }
-            scene->set_sprite_pos(i, new_pos);
+    mesh->set_material(write_through_material);
 #endif
-        }
-        count = 0;
+    mesh->set_texture_index(mesh->get_material()->get_texture_index(field_texture));
+    return run_pass;
+}
+
+// exact texels, so the distance field survives the round trip
+void record_maze_frame()
+{
+    maze_frame++;
+    if(!maze_recorder.is_open()) {
         return;
     }
-    count++;
+    vt::Texture* texture = maze_fb->get_texture();
+    texture->refresh(); // download from gpu (very slow)
+    maze_record_frame.capture_r32f(reinterpret_cast<const float*>(texture->get_pixels()),
+                                   glm::ivec2(HI_RES_TEX_DIM, HI_RES_TEX_DIM),
+                                   vt::SNAPSHOT_CELLS_FLOAT);
+    maze_record_frame.set_generation(maze_frame);
+    maze_recorder.record(&maze_record_frame);
 }
 
+// NOTE: prune and grow end at their fixed point or after maze_phase_durations ticks, whichever comes first; the
+//       distance field never ends, but its pass is skipped while it is settled
 void conduct_maze_iter()
 {
+    maze_change_counter->poll();
+    maze_sprite_change_counter->poll();
     switch(current_maze_phase) {
         case MAZE_PHASE_GEN:
             if(tick_count == 0) {
@@ -486,11 +808,14 @@ void conduct_maze_iter()
                 }
                 init_prune_maze();
                 tick_count++;
-            } else if(maze_phase_durations[current_maze_phase] > 0 && tick_count < maze_phase_durations[current_maze_phase]) {
+            } else if(maze_phase_durations[current_maze_phase] > 0 && tick_count < maze_phase_durations[current_maze_phase] &&
+                      !maze_change_counter->is_settled())
+            {
                 do_maze_prune_iter(vt::Scene::instance(),
                                    maze_fb->get_texture(), // input_texture
                                    maze_fb2);              // output_fb
                 std::swap(maze_fb, maze_fb2); // the elusive ping-pong swap
+                record_maze_frame();
                 tick_count++;
             } else {
                 current_maze_phase = MAZE_PHASE_GROW;
@@ -509,11 +834,14 @@ void conduct_maze_iter()
                 }
                 init_grow_maze();
                 tick_count++;
-            } else if(maze_phase_durations[current_maze_phase] > 0 && tick_count < maze_phase_durations[current_maze_phase]) {
+            } else if(maze_phase_durations[current_maze_phase] > 0 && tick_count < maze_phase_durations[current_maze_phase] &&
+                      !maze_change_counter->is_settled())
+            {
                 do_maze_grow_iter(vt::Scene::instance(),
                                   maze_fb->get_texture(), // input_texture
                                   maze_fb2);              // output_fb
                 std::swap(maze_fb, maze_fb2); // the elusive ping-pong swap
+                record_maze_frame();
                 tick_count++;
             } else {
                 current_maze_phase = MAZE_PHASE_DISTFIELD;
@@ -527,11 +855,12 @@ void conduct_maze_iter()
                 tick_count++;
             } else if(maze_phase_durations[current_maze_phase] > 0 && tick_count < maze_phase_durations[current_maze_phase]) {
                 tick_count++;
-            } else {
-                do_maze_distfield_iter(vt::Scene::instance(),
-                                       maze_fb->get_texture(), // input_texture
-                                       maze_fb2);              // output_fb
+            } else if(do_maze_distfield_iter(vt::Scene::instance(),
+                                             maze_fb->get_texture(), // input_texture
+                                             maze_fb2))              // output_fb
+            {
                 std::swap(maze_fb, maze_fb2); // the elusive ping-pong swap
+                record_maze_frame();
             }
             break;
     }
@@ -543,16 +872,33 @@ void onTick()
     static unsigned int frames = 0;
     unsigned int tick = glutGet(GLUT_ELAPSED_TIME);
     unsigned int delta_time = tick - prev_tick;
+    static long iters = 0;
     static float fps = 0;
+    static float ips = 0;
     if(delta_time > 1000) {
         fps = 1000.0 * frames / delta_time;
+        ips = 1000.0 * iters / delta_time;
         frames = 0;
+        iters = 0;
         prev_tick = tick;
     }
     if(show_fps && delta_time > 100) {
         std::stringstream ss;
         ss << std::setprecision(2) << std::fixed << fps << " FPS, "
+            << ips << " iter/s (" << maze_frame_iters << "/frame), "
             << "Mouse: {" << mouse_drag.x << ", " << mouse_drag.y << "}";
+        if(maze_change_counter->is_settled()) {
+            ss << ", Settled";
+        } else if(maze_change_counter->get_changed() >= 0) {
+            ss << ", Changed: " << maze_change_counter->get_changed() << " texels";
+        }
+        if(use_frame_governor) {
+            ss << ", Governor: " << vt::FrameGovernor::get_decision_name(frame_governor->get_decision())
+               << " (gpu " << frame_governor->get_gpu_time_per_iteration() * 1000
+               << " ms/iter, cpu " << frame_governor->get_cpu_time_per_iteration() * 1000
+               << " ms/iter, budget " << frame_governor->get_budget() * 1000
+               << " ms, missed " << frame_governor->get_overruns() << ")";
+        }
         //ss << "Width=" << camera->get_width() << ", Width=" << camera->get_height();
         glutSetWindowTitle(ss.str().c_str());
     }
@@ -560,7 +906,21 @@ void onTick()
     if(!do_animation) {
         return;
     }
-    conduct_maze_iter();
+
+    // one phase machine step per frame, or as many as the governor allows, then one display pass
+    // NOTE: phase changes (init, downloads) land in whichever frame reaches them and show up as a costlier frame
+    if(use_frame_governor) {
+        int frame_iters = frame_governor->begin_frame();
+        for(int i = 0; i < frame_iters; i++) {
+            conduct_maze_iter();
+        }
+        frame_governor->end_frame(frame_iters);
+        maze_frame_iters = frame_iters;
+    } else {
+        conduct_maze_iter();
+        maze_frame_iters = 1;
+    }
+    iters += maze_frame_iters;
 }
 
 void onDisplay()
@@ -586,6 +946,44 @@ void onKeyboard(unsigned char key, int x, int y)
         case 'r': // reset sprites
             init_sprites();
             break;
+        case '=': // more sprites
+        case '+':
+            maze_sprite_count = std::min(MAZE_MAX_SPRITES, maze_sprite_count * 2);
+            init_sprites();
+            std::cout << "Sprites: " << maze_sprite_count << std::endl;
+            break;
+        case '-': // fewer sprites
+            maze_sprite_count = std::max(1, maze_sprite_count / 2);
+            init_sprites();
+            std::cout << "Sprites: " << maze_sprite_count << std::endl;
+            break;
+        case 'd': // toggle distance field flooding
+            use_flood = !use_flood;
+            std::cout << "Flood until settled: " << (use_flood ? "on" : "off") << std::endl;
+            break;
+        case 't': // toggle distance field from the maze tree
+            use_tree = !use_tree;
+            std::cout << "Distance field from the maze tree: " << (use_tree ? "on" : "off") << std::endl;
+            break;
+        case 'g': // toggle frame governor
+            use_frame_governor = !use_frame_governor;
+            frame_governor->reset();
+            std::cout << "Iterations per frame: "
+                      << (use_frame_governor ? "as many as the frame governor allows" : "one")
+                      << (use_frame_governor && !frame_governor->has_gpu_timer() ? " (no gpu timer, cpu time only)" : "")
+                      << std::endl;
+            break;
+        case 'e': // toggle recording
+            if(maze_recorder.is_open()) {
+                maze_recorder.close();
+                std::cout << "Recording: " << maze_recorder.get_frames() << " frames, "
+                          << maze_recorder.get_bytes() / 1024 << " KB to " << MAZE_RECORDING_FILE << std::endl;
+            } else if(maze_recorder.open(MAZE_RECORDING_FILE)) {
+                std::cout << "Recording: to " << MAZE_RECORDING_FILE << std::endl;
+            } else {
+                std::cout << "Recording: cannot write " << MAZE_RECORDING_FILE << std::endl;
+            }
+            break;
         case 32: // space
             do_animation = !do_animation;
             break;
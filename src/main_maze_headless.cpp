@@ -0,0 +1,216 @@
+/**
+ * Headless maze solver runner (no GLUT, no GL context)
+ * Enhanced by: onlyuser
+ */
+
+#include <MazeSolver.h>
+#include <Snapshot.h>
+#include <ThreadPool.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#define DEFAULT_DIM     (64 - 1) // same as main_maze
+#define DEFAULT_REPEATS 1
+
+void show_help(const char* program_name)
+{
+    printf("Usage: %s [-x WIDTH] [-y HEIGHT] [-c X,Y] [-t THREADS] [-n REPEATS] [-L FILE] [-S FILE] [-s SEED] [-v] [-h]\n", program_name);
+    printf("  -x WIDTH       maze width, odd for walls on both sides (default: %d)\n", DEFAULT_DIM);
+    printf("  -y HEIGHT      maze height, odd for walls on both sides (default: %d)\n", DEFAULT_DIM);
+    printf("  -c X,Y         goal cell, the cursor in main_maze (default: the seed cell of -L, or the cell nearest the\n");
+    printf("                 center)\n");
+    printf("  -t THREADS     worker threads for wavefronts of %d cells or more, 0 for one per core (default:\n", MAZE_SOLVER_PARALLEL_FRONTIER);
+    printf("                 single-threaded)\n");
+    printf("  -n REPEATS     solves to time (default: %d)\n", DEFAULT_REPEATS);
+    printf("  -L FILE        solve a maze from a snapshot of Texture::RED texels (walls, sprites and the seed as\n");
+    printf("                 main_maze draws them) instead of generating one\n");
+    printf("  -S FILE        write the distance field as a snapshot, texel for texel what main_maze's distfield\n");
+    printf("                 pass converges to\n");
+    printf("  -s SEED        random seed (default: time)\n");
+    printf("  -v             verify against a single-threaded solve, and that the field is a fixed point of the\n");
+    printf("                 distfield pass\n");
+    printf("  -h             show this help\n");
+}
+
+// one pass of "src/shaders/overlay_maze_distfield.f.glsl" over a cell (no sprites, seed at goal)
+float step_distfield(const float* pixels, glm::ivec2 dim, glm::ivec2 pos, glm::ivec2 goal)
+{
+    static const int offset_8[][2] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+    float value = pixels[pos.y * dim.x + pos.x];
+    if(value == MAZE_WALL_COLOR) {
+        return MAZE_WALL_COLOR;
+    }
+    if(value == MAZE_EMPTY_COLOR) {
+        return MAZE_WALL_COLOR * MAZE_DECAY_FACTOR + MAZE_SEED_COLOR * (1 - MAZE_DECAY_FACTOR);
+    }
+    if(pos == goal) {
+        return MAZE_SEED_COLOR;
+    }
+    float max_value = 0;
+    for(int i = 0; i < 8; i++) {
+        glm::ivec2 neighbor(pos.x + offset_8[i][0], pos.y + offset_8[i][1]);
+        if(neighbor.x < 0 || neighbor.x >= dim.x || neighbor.y < 0 || neighbor.y >= dim.y) {
+            continue; // zero border
+        }
+        float neighbor_value = pixels[neighbor.y * dim.x + neighbor.x];
+        if(neighbor_value == MAZE_WALL_COLOR || neighbor_value == MAZE_SPRITE_COLOR) {
+            continue;
+        }
+        max_value = std::max(max_value, neighbor_value);
+    }
+    float decay = 1 - MAZE_DECAY_FACTOR;
+    return max_value * (1 - decay) + MAZE_WALL_COLOR * decay;
+}
+
+bool verify(const vt::MazeSolver& solver, const std::vector<float>& pixels, const std::vector<float>& field)
+{
+    glm::ivec2 dim = solver.get_dim();
+    vt::MazeSolver reference(dim);
+    reference.load_r32f(&pixels[0]);
+    reference.set_goal(solver.get_goal());
+    reference.solve();
+    for(int y = 0; y < dim.y; y++) {
+        for(int x = 0; x < dim.x; x++) {
+            glm::ivec2 pos(x, y);
+            if(solver.get_distance(pos) != reference.get_distance(pos)) {
+                fprintf(stderr, "Error: distance at (%d, %d) is %d, single-threaded %d\n",
+                        x, y, solver.get_distance(pos), reference.get_distance(pos));
+                return false;
+            }
+            // NOTE: cells held one ulp above MAZE_WALL_COLOR (see MazeSolver::get_distance_color) and cells the
+            //       goal cannot reach are no fixed point
+            int distance = solver.get_distance(pos);
+            if(distance < 0 || (distance > 0 && field[y * dim.x + x] == solver.get_distance_color(solver.get_max_distance()))) {
+                continue;
+            }
+            float value = step_distfield(&field[0], dim, pos, solver.get_goal());
+            if(value != field[y * dim.x + x]) {
+                fprintf(stderr, "Error: field at (%d, %d) is %.9g, the distfield pass makes it %.9g\n",
+                        x, y, field[y * dim.x + x], value);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    glm::ivec2 dim(DEFAULT_DIM);
+    glm::ivec2 goal(-1);
+    int thread_count = -1;
+    int repeats = DEFAULT_REPEATS;
+    std::string load_filename;
+    std::string save_filename;
+    unsigned int seed = time(NULL);
+    bool do_verify = false;
+    int opt;
+    while((opt = getopt(argc, argv, "x:y:c:t:n:L:S:s:vh")) != -1) {
+        switch(opt) {
+            case 'x': dim.x        = atoi(optarg); break;
+            case 'y': dim.y        = atoi(optarg); break;
+            case 'c':
+                if(sscanf(optarg, "%d,%d", &goal.x, &goal.y) != 2) {
+                    fprintf(stderr, "Error: goal is X,Y\n");
+                    return 1;
+                }
+                break;
+            case 't': thread_count = atoi(optarg); break;
+            case 'n': repeats      = atoi(optarg); break;
+            case 'L': load_filename = optarg;      break;
+            case 'S': save_filename = optarg;      break;
+            case 's': seed         = atoi(optarg); break;
+            case 'v': do_verify    = true;         break;
+            case 'h':
+                show_help(argv[0]);
+                return 0;
+            default:
+                show_help(argv[0]);
+                return 1;
+        }
+    }
+    if(dim.x <= 0 || dim.y <= 0 || repeats < 1) {
+        fprintf(stderr, "Error: invalid maze size or repeat count\n");
+        return 1;
+    }
+    srand(seed);
+
+    // maze, as main_maze draws it into maze_pattern_texture
+    std::vector<float> pixels;
+    std::chrono::steady_clock::time_point begin_time = std::chrono::steady_clock::now();
+    if(!load_filename.empty()) {
+        vt::Snapshot snapshot;
+        if(!snapshot.load(load_filename) || snapshot.get_cells() != vt::SNAPSHOT_CELLS_FLOAT) {
+            fprintf(stderr, "Error: cannot read Texture::RED snapshot \"%s\"\n", load_filename.c_str());
+            return 1;
+        }
+        dim = snapshot.get_dim();
+        pixels.resize(dim.x * dim.y);
+        snapshot.restore_r32f(&pixels[0], dim);
+    } else {
+        pixels.resize(dim.x * dim.y);
+        vt::gen_maze_r32f(&pixels[0], dim);
+    }
+    double maze_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin_time).count();
+
+    vt::MazeSolver solver(dim);
+    solver.load_r32f(&pixels[0]);
+    if(goal != glm::ivec2(-1)) {
+        solver.set_goal(goal);
+    } else if(solver.get_goal() == glm::ivec2(-1)) {
+        solver.set_goal(glm::ivec2((dim.x / 2) | 1, (dim.y / 2) | 1)); // cells are on odd coordinates
+    }
+    vt::ThreadPool* thread_pool = (thread_count >= 0) ? new vt::ThreadPool(thread_count) : NULL;
+    solver.set_thread_pool(thread_pool);
+    double min_time = 0;
+    double total_time = 0;
+    for(int i = 0; i < repeats; i++) {
+        solver.solve();
+        min_time = i ? std::min(min_time, solver.get_elapsed_time()) : solver.get_elapsed_time();
+        total_time += solver.get_elapsed_time();
+    }
+    if(solver.get_max_distance() < 0) {
+        fprintf(stderr, "Error: goal (%d, %d) is blocked or off the maze\n", solver.get_goal().x, solver.get_goal().y);
+        delete thread_pool;
+        return 1;
+    }
+    std::vector<float> field(dim.x * dim.y);
+    solver.store_r32f(&field[0]);
+
+    printf("dim:             %dx%d\n",     dim.x, dim.y);
+    printf("maze:            %s (%.6f sec)\n", load_filename.empty() ? "generated" : load_filename.c_str(), maze_time);
+    printf("goal:            %d,%d\n",     solver.get_goal().x, solver.get_goal().y);
+    printf("threads:         %d\n",        thread_pool ? thread_pool->get_thread_count() : 1);
+    printf("reached:         %zu cells\n", solver.get_reached());
+    printf("max distance:    %d\n",        solver.get_max_distance());
+    printf("wavefronts:      %d (%d in parallel)\n", solver.get_max_distance() + 1, solver.get_parallel_wavefronts());
+    printf("elapsed:         %.6f sec (best of %d, mean %.6f sec)\n", min_time, repeats, total_time / repeats);
+    printf("cells/sec:       %.2f\n",      solver.get_reached() / min_time);
+    if(do_verify) {
+        if(!verify(solver, pixels, field)) {
+            delete thread_pool;
+            return 1;
+        }
+        printf("verify:          ok\n");
+    }
+    if(!save_filename.empty()) {
+        vt::Snapshot snapshot;
+        snapshot.capture_r32f(&field[0], dim, vt::SNAPSHOT_CELLS_FLOAT);
+        if(!snapshot.save(save_filename)) {
+            fprintf(stderr, "Error: cannot write snapshot \"%s\"\n", save_filename.c_str());
+            delete thread_pool;
+            return 1;
+        }
+        printf("saved:           %s\n", save_filename.c_str());
+    }
+    delete thread_pool;
+    return 0;
+}
@@ -4,6 +4,11 @@ const float GROW_COLOR = 1;
 const float LIVE_COLOR = 0.5;
 const float DIE_COLOR  = 0;
 
+// B3/S23; indexed by neighbor count
+// NOTE: other life-like rules are baked into a generated copy of this file (see write_life_rule_shader in LifeRule.h)
+const bool BIRTH[9] = bool[9](false, false, false, true, false, false, false, false, false);
+const bool SURVIVAL[9] = bool[9](false, false, true, true, false, false, false, false, false);
+
 uniform sampler2D color_texture;
 uniform ivec2     viewport_dim;
 uniform ivec2     image_res;
@@ -18,12 +23,10 @@ ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
                           ivec2(-1,  0),  // w
                           ivec2(-1,  1)); // nw
 
+// NOTE: sample at texel centers so that results match ConwayEngine exactly; texels off the board come from the
+//       sampler wrap state (see Texture::set_boundary_mode), so there is no border test
 float get_pixel(sampler2D texture, ivec2 offset) {
-    vec2 pos = vec2(ivec2(gl_FragCoord.xy) + offset) / vec2(image_res - ivec2(1));
-    if((pos.x < 0 || pos.x > 1) || (pos.y < 0 || pos.y > 1)) {
-        return 0.0;
-    }
-    return texture2D(texture, pos).r;
+    return texture2D(texture, (vec2(ivec2(gl_FragCoord.xy) + offset) + vec2(0.5)) / vec2(image_res)).r;
 }
 
 void main() {
@@ -39,15 +42,15 @@ void main() {
     for(int i = 0; i < 8; i++) {
         sum += (get_pixel(color_texture, offset[i]) > 0 ? 1 : 0);
     }
-    if(sum == 3) {
+    vec4 old_color = vec4(get_pixel(color_texture, ivec2(0)));
+    if(!(old_color.r > 0 ? SURVIVAL[sum] : BIRTH[sum])) {
+        gl_FragColor = vec4(DIE_COLOR);
+    } else if(BIRTH[sum]) {
         gl_FragColor = vec4(GROW_COLOR);
-    } else if(sum == 2) {
-        vec4 old_color = vec4(get_pixel(color_texture, ivec2(0)));
+    } else {
         if(old_color.r == GROW_COLOR) {
             old_color = vec4(LIVE_COLOR); // add extra transitional color for aesthetic purpose
         }
         gl_FragColor = old_color;
-    } else {
-        gl_FragColor = vec4(DIE_COLOR);
     }
 }
\ No newline at end of file
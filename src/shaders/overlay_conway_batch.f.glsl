@@ -0,0 +1,57 @@
+// Based on Chris Wellons' tutorial: http://nullprogram.com/blog/2014/06/10/
+
+// many independent universes in one atlas (same layout as ConwayBatch in "include/ConwayBatch.h")
+// NOTE: one dead gutter texel between neighboring universes; gutter texels never come alive, so a universe
+//       never sees its neighbors and behaves as if it had its own dead border
+
+const float GROW_COLOR = 1;
+const float LIVE_COLOR = 0.5;
+const float DIE_COLOR  = 0;
+
+// B3/S23; indexed by neighbor count
+// NOTE: other life-like rules are baked into a generated copy of this file (see write_life_rule_shader in LifeRule.h)
+const bool BIRTH[9] = bool[9](false, false, false, true, false, false, false, false, false);
+const bool SURVIVAL[9] = bool[9](false, false, true, true, false, false, false, false, false);
+
+uniform sampler2D color_texture;
+uniform ivec2     image_res;
+uniform ivec2     universe_dim;
+
+ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
+                          ivec2( 1,  1),  // ne
+                          ivec2( 1,  0),  // e
+                          ivec2( 1, -1),  // se
+                          ivec2( 0, -1),  // s
+                          ivec2(-1, -1),  // sw
+                          ivec2(-1,  0),  // w
+                          ivec2(-1,  1)); // nw
+
+// NOTE: sample at texel centers so that results match ConwayBatch exactly; the atlas has a dead border
+//       (see Texture::set_boundary_mode), so there is no border test
+float get_pixel(sampler2D texture, ivec2 offset) {
+    return texture2D(texture, (vec2(ivec2(gl_FragCoord.xy) + offset) + vec2(0.5)) / vec2(image_res)).r;
+}
+
+void main() {
+    ivec2 stride = universe_dim + ivec2(1);
+    ivec2 local_pos = ivec2(gl_FragCoord.xy) - (ivec2(gl_FragCoord.xy) / stride) * stride;
+    if(local_pos.x == universe_dim.x || local_pos.y == universe_dim.y) {
+        gl_FragColor = vec4(DIE_COLOR); // gutter
+        return;
+    }
+    int sum = 0;
+    for(int i = 0; i < 8; i++) {
+        sum += (get_pixel(color_texture, offset[i]) > 0 ? 1 : 0);
+    }
+    vec4 old_color = vec4(get_pixel(color_texture, ivec2(0)));
+    if(!(old_color.r > 0 ? SURVIVAL[sum] : BIRTH[sum])) {
+        gl_FragColor = vec4(DIE_COLOR);
+    } else if(BIRTH[sum]) {
+        gl_FragColor = vec4(GROW_COLOR);
+    } else {
+        if(old_color.r == GROW_COLOR) {
+            old_color = vec4(LIVE_COLOR); // add extra transitional color for aesthetic purpose
+        }
+        gl_FragColor = old_color;
+    }
+}
\ No newline at end of file
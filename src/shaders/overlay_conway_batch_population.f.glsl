@@ -0,0 +1,21 @@
+// one fragment per universe; live cells of that universe (same layout as ConwayBatch in "include/ConwayBatch.h")
+
+uniform sampler2D color_texture;
+uniform ivec2     image_res;    // atlas
+uniform ivec2     universe_dim;
+
+void main() {
+    ivec2 universe_origin = ivec2(gl_FragCoord.xy) * (universe_dim + ivec2(1));
+    float population = 0.0;
+    for(int y = 0; y < universe_dim.y; y++) {
+        for(int x = 0; x < universe_dim.x; x++) {
+            ivec2 texel = universe_origin + ivec2(x, y);
+            if(texel.x < image_res.x && texel.y < image_res.y &&
+               texture2D(color_texture, (vec2(texel) + vec2(0.5)) / vec2(image_res)).r > 0)
+            {
+                population += 1.0;
+            }
+        }
+    }
+    gl_FragColor = vec4(population);
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+// one fragment per tile; non-zero if any texel of the tile changed in the last generation
+
+// NOTE: must match CONWAY_TILE_DIM in "src/main_conway.cpp"
+const int TILE_DIM = 16;
+
+uniform sampler2D color_texture;  // input
+uniform sampler2D color_texture2; // output
+uniform ivec2     image_res;
+
+float get_pixel(sampler2D texture, ivec2 texel) {
+    return texture2D(texture, (vec2(texel) + vec2(0.5)) / vec2(image_res)).r;
+}
+
+void main() {
+    ivec2 tile_origin = ivec2(gl_FragCoord.xy) * TILE_DIM;
+    float changed = 0.0;
+    for(int y = 0; y < TILE_DIM; y++) {
+        for(int x = 0; x < TILE_DIM; x++) {
+            ivec2 texel = tile_origin + ivec2(x, y);
+            if(get_pixel(color_texture, texel) != get_pixel(color_texture2, texel)) {
+                changed = 1.0;
+            }
+        }
+    }
+    gl_FragColor = vec4(changed);
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+void main(void) {
+    gl_Position = gl_Vertex;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+// one fragment per tile-wide run of a row; four independent signatures of the run's cell states, for cycle detection
+// NOTE: each lane folds in one cell at a time (multiply-add, then cube, both modulo a prime), so runs that differ
+//       in a cell almost never agree in all four lanes; the signatures are a hash, not an exact encoding (16 cells
+//       of up to 256 states do not fit in 96 bits), so "src/main_conway.cpp" compares boards before it trusts one
+
+// NOTE: must match CONWAY_TILE_DIM in "src/main_conway.cpp"
+const int TILE_DIM = 16;
+
+// prime, with P - 1 not a multiple of 3 (so cubing permutes the residues), and P * P < 2^24 (so every product is
+// exact in a float)
+const float P = 4091.0;
+
+// arbitrary, in [1, P)
+const vec4 MULT = vec4(3706.0, 1513.0, 3659.0, 344.0);
+const vec4 SEED = vec4(3815.0, 3898.0, 2486.0, 3246.0);
+
+vec4 mod_p(vec4 x) {
+    vec4 r = x - P * floor(x / P);
+    r += P * vec4(lessThan(r, vec4(0.0)));          // floor(x / P) may round up by one
+    r -= P * vec4(greaterThanEqual(r, vec4(P)));    // or down by one
+    return r;
+}
+
+uniform sampler2D color_texture;
+uniform ivec2     image_res;
+
+void main() {
+    ivec2 run_origin = ivec2(int(gl_FragCoord.x) * TILE_DIM, int(gl_FragCoord.y));
+    vec4 signature = SEED;
+    for(int i = 0; i < TILE_DIM; i++) {
+        ivec2 texel = run_origin + ivec2(i, 0);
+        if(texel.x < image_res.x) {
+            // NOTE: Texture::RED and Texture::R8 alike (0, 0.5 and 1, or state / 255)
+            float state = floor(texture2D(color_texture, (vec2(texel) + vec2(0.5)) / vec2(image_res)).r * 255.0 + 0.5);
+            signature = mod_p(signature * MULT + vec4(state + 1.0));
+            signature = mod_p(mod_p(signature * signature) * signature);
+        }
+    }
+    gl_FragColor = signature;
+}
@@ -0,0 +1,27 @@
+// next reduction level: 2x2 blocks of the level below, same six texels per block (see overlay_conway_reduce_init.f.glsl)
+// NOTE: counts stay exact in a float up to 2^24 cells
+
+// NOTE: must match CONWAY_STATS in "src/main_conway.cpp"
+const int   STATS = 6;
+const float EMPTY = -1000000000.0;
+
+uniform sampler2D color_texture; // level below
+uniform ivec2     image_res;     // level below
+
+void main() {
+    ivec2 texel   = ivec2(gl_FragCoord.xy);
+    int   block_x = texel.x / STATS;
+    int   stat    = texel.x - block_x * STATS;
+    float result  = (stat < 2) ? 0.0 : EMPTY;
+    for(int y = 0; y < 2; y++) {
+        for(int x = 0; x < 2; x++) {
+            ivec2 src_texel = ivec2((block_x * 2 + x) * STATS + stat, texel.y * 2 + y);
+            if(src_texel.x >= image_res.x || src_texel.y >= image_res.y) {
+                continue;
+            }
+            float value = texture2D(color_texture, (vec2(src_texel) + vec2(0.5)) / vec2(image_res)).r;
+            result = (stat < 2) ? result + value : max(result, value);
+        }
+    }
+    gl_FragColor = vec4(result);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+// first reduction level: one 2x2 block of the board per block of six texels, one per statistic
+//   0: live cells, 1: changed cells, 2: -min x, 3: -min y, 4: max x, 5: max y
+// NOTE: bounding box extents are all reduced with max (min x as max -x), so an empty block holds EMPTY there
+
+// NOTE: must match CONWAY_STATS in "src/main_conway.cpp"
+const int   STATS = 6;
+const float EMPTY = -1000000000.0;
+
+uniform sampler2D color_texture;  // current generation
+uniform sampler2D color_texture2; // previous generation
+uniform ivec2     image_res;
+
+float get_pixel(sampler2D texture, ivec2 texel) {
+    return texture2D(texture, (vec2(texel) + vec2(0.5)) / vec2(image_res)).r;
+}
+
+void main() {
+    ivec2 texel   = ivec2(gl_FragCoord.xy);
+    int   block_x = texel.x / STATS;
+    int   stat    = texel.x - block_x * STATS;
+    float result  = (stat < 2) ? 0.0 : EMPTY;
+    for(int y = 0; y < 2; y++) {
+        for(int x = 0; x < 2; x++) {
+            ivec2 board_texel = ivec2(block_x, texel.y) * 2 + ivec2(x, y);
+            if(board_texel.x >= image_res.x || board_texel.y >= image_res.y) {
+                continue;
+            }
+            bool alive      = get_pixel(color_texture,  board_texel) > 0;
+            bool prev_alive = get_pixel(color_texture2, board_texel) > 0;
+            if(stat == 0) {
+                result += alive ? 1.0 : 0.0;
+            } else if(stat == 1) {
+                result += (alive != prev_alive) ? 1.0 : 0.0;
+            } else if(alive) {
+                float extent = (stat == 2) ? -float(board_texel.x) :
+                               (stat == 3) ? -float(board_texel.y) :
+                               (stat == 4) ?  float(board_texel.x) : float(board_texel.y);
+                result = max(result, extent);
+            }
+        }
+    }
+    gl_FragColor = vec4(result);
+}
\ No newline at end of file
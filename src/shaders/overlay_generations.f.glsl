@@ -0,0 +1,57 @@
+// Based on Chris Wellons' tutorial: http://nullprogram.com/blog/2014/06/10/
+
+// "Generations" rules on an r8 texture; each texel holds a cell state
+// NOTE: must match GenerationsEngine
+const int DEAD  = 0;
+const int ALIVE = 1; // 2 .. STATES - 1 are dying (refractory)
+
+// B2/S/C3 (Brian's Brain); indexed by live neighbor count
+// NOTE: other rules are baked into a generated copy of this file (see write_life_rule_shader in LifeRule.h)
+const bool BIRTH[9] = bool[9](false, false, true, false, false, false, false, false, false);
+const bool SURVIVAL[9] = bool[9](false, false, false, false, false, false, false, false, false);
+const int STATES = 3;
+
+uniform sampler2D color_texture;
+uniform ivec2     viewport_dim;
+uniform ivec2     image_res;
+uniform ivec2     cursor_pos;
+
+ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
+                          ivec2( 1,  1),  // ne
+                          ivec2( 1,  0),  // e
+                          ivec2( 1, -1),  // se
+                          ivec2( 0, -1),  // s
+                          ivec2(-1, -1),  // sw
+                          ivec2(-1,  0),  // w
+                          ivec2(-1,  1)); // nw
+
+// NOTE: sample at texel centers so that results match GenerationsEngine exactly; r8 texels read back as state / 255;
+//       texels off the board come from the sampler wrap state (see Texture::set_boundary_mode), so there is no border test
+int get_state(sampler2D texture, ivec2 offset) {
+    return int(texture2D(texture, (vec2(ivec2(gl_FragCoord.xy) + offset) + vec2(0.5)) / vec2(image_res)).r * 255.0 + 0.5);
+}
+
+void main() {
+    ivec2 cursor_pos_tex_space = ivec2(int((float(cursor_pos.x) / viewport_dim.x) * image_res.x),
+                                       int((float(cursor_pos.y) / viewport_dim.y) * image_res.y));
+    if(int(gl_FragCoord.x) == cursor_pos_tex_space.x &&
+       int(gl_FragCoord.y) == cursor_pos_tex_space.y)
+    {
+        gl_FragColor = vec4(float(ALIVE) / 255.0); // seed
+        return;
+    }
+    int count = 0;
+    for(int i = 0; i < 8; i++) {
+        count += (get_state(color_texture, offset[i]) == ALIVE ? 1 : 0);
+    }
+    int state = get_state(color_texture, ivec2(0));
+    int next_state = DEAD;
+    if(state == DEAD) {
+        next_state = BIRTH[count] ? ALIVE : DEAD;
+    } else if(state == ALIVE) {
+        next_state = SURVIVAL[count] ? ALIVE : (STATES > 2 ? 2 : DEAD);
+    } else if(state + 1 < STATES) {
+        next_state = state + 1;
+    }
+    gl_FragColor = vec4(float(next_state) / 255.0);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+const int ALIVE = 1;
+
+// NOTE: baked in by write_life_rule_shader in LifeRule.h, same as "src/shaders/overlay_generations.f.glsl"
+const int STATES = 3;
+
+uniform sampler2D color_texture;
+varying vec2      lerp_texcoord;
+
+void main(void) {
+    int state = int(texture2D(color_texture, lerp_texcoord).r * 255.0 + 0.5);
+    if(state == ALIVE) {
+        gl_FragColor = vec4(0, 1, 1, 0); // cyan
+        return;
+    }
+    if(state > ALIVE) {
+        gl_FragColor = vec4(0, 0, 1.0 - float(state - 2) / float(STATES - 1), 0); // blue, fading while dying
+        return;
+    }
+    gl_FragColor = vec4(0, 0, 0, 0); // black
+}
\ No newline at end of file
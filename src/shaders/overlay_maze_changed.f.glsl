@@ -0,0 +1,17 @@
+// marks the texels the last ping-pong pass changed and discards the rest, so an occlusion query over this pass
+// counts changed texels (see ChangeCounter); the output itself is never read
+
+uniform sampler2D color_texture;  // input of the last pass
+uniform sampler2D color_texture2; // output of the last pass
+uniform ivec2     image_res;
+
+float get_pixel(sampler2D texture) {
+    return texture2D(texture, (vec2(ivec2(gl_FragCoord.xy)) + vec2(0.5)) / vec2(image_res)).r;
+}
+
+void main() {
+    if(get_pixel(color_texture) == get_pixel(color_texture2)) {
+        discard; // unchanged
+    }
+    gl_FragColor = vec4(1);
+}
\ No newline at end of file
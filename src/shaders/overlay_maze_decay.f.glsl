@@ -0,0 +1,23 @@
+// the distance field's value at each path length, one texel per step from the seed, for the tree pass to look up
+// (see overlay_maze_distfield_tree.f.glsl)
+// NOTE: the distfield pass's decay applied once per step, in the same float expression, so a distfield pass after
+//       the tree pass reproduces its values exactly; O(length) per texel, but drawn once per maze
+
+const float WALL_COLOR     = 0.5;
+const float SEED_COLOR     = 1;
+const float DECAY_FACTOR   = 0.99;
+
+// NOTE: must match MAZE_DECAY_TEX_DIM in "src/main_maze.cpp"
+const int   MAX_DISTANCE   = 4096;
+
+void main() {
+    float distance = floor(gl_FragCoord.x);
+    float value = SEED_COLOR;
+    for(int i = 0; i < MAX_DISTANCE; i++) {
+        if(float(i) >= distance) {
+            break;
+        }
+        value = mix(value, WALL_COLOR, 1 - DECAY_FACTOR);
+    }
+    gl_FragColor = vec4(value);
+}
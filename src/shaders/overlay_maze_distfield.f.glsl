@@ -1,6 +1,5 @@
 // Inspired by Sidney Durant's tutorial: https://gamedevelopment.tutsplus.com/tutorials/understanding-goal-based-vector-field-pathfinding--gamedev-9007
 
-const int   MAX_SPRITES    = 100;
 const float EMPTY_COLOR    = 0;
 const float SPRITE_COLOR   = 0.25;
 const float WALL_COLOR     = 0.5;
@@ -12,8 +11,7 @@ uniform sampler2D color_texture2;
 uniform ivec2     viewport_dim;
 uniform ivec2     image_res;
 uniform ivec2     cursor_pos;
-uniform vec2      sprite_pos[MAX_SPRITES];
-uniform int       sprite_count;
+uniform sampler2D occupancy_texture; // nonzero where a sprite is (see overlay_maze_occupancy.v.glsl)
 
 ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
                           ivec2( 1,  1),  // ne
@@ -24,12 +22,10 @@ ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
                           ivec2(-1,  0),  // w
                           ivec2(-1,  1)); // nw
 
+// NOTE: sample at texel centers; texels off the board read as 0 (empty) through the sampler's zero border
+//       (see Texture::set_boundary_mode), so there is no border test
 float get_pixel(sampler2D texture, ivec2 offset) {
-    vec2 pos = vec2(ivec2(gl_FragCoord.xy) + offset) / vec2(image_res - ivec2(1));
-    if((pos.x < 0 || pos.x > 1) || (pos.y < 0 || pos.y > 1)) {
-        return 0.0;
-    }
-    return texture2D(texture, pos).r;
+    return texture2D(texture, (vec2(ivec2(gl_FragCoord.xy) + offset) + vec2(0.5)) / vec2(image_res)).r;
 }
 
 void main() {
@@ -42,13 +38,9 @@ void main() {
         gl_FragColor = vec4(mix(WALL_COLOR, SEED_COLOR, 1 - DECAY_FACTOR)); // empty cell (init within WALL_COLOR..SEED_COLOR range)
         return;
     }
-    for(int i = 0; i < sprite_count; i++) {
-        if(int(gl_FragCoord.x) == int(sprite_pos[i].x) &&
-           int(gl_FragCoord.y) == int(sprite_pos[i].y))
-        {
-            gl_FragColor = vec4(SPRITE_COLOR); // sprite
-            return;
-        }
+    if(get_pixel(occupancy_texture, ivec2(0)) != 0) {
+        gl_FragColor = vec4(SPRITE_COLOR); // sprite
+        return;
     }
     ivec2 cursor_pos_tex_space = ivec2(int((float(cursor_pos.x) / viewport_dim.x) * image_res.x),
                                        int((float(cursor_pos.y) / viewport_dim.y) * image_res.y));
@@ -0,0 +1,95 @@
+// Inspired by Sidney Durant's tutorial: https://gamedevelopment.tutsplus.com/tutorials/understanding-goal-based-vector-field-pathfinding--gamedev-9007
+
+const int   FLOOD_RADIUS   = 4; // NOTE: must match MAZE_FLOOD_RADIUS in "src/main_maze.cpp"
+const int   FLOOD_WIDTH    = FLOOD_RADIUS * 2 + 1;
+const float EMPTY_COLOR    = 0;
+const float SPRITE_COLOR   = 0.25;
+const float WALL_COLOR     = 0.5;
+const float SEED_COLOR     = 1;
+const float DECAY_FACTOR   = 0.99;
+
+uniform sampler2D color_texture;
+uniform sampler2D color_texture2;
+uniform ivec2     viewport_dim;
+uniform ivec2     image_res;
+uniform ivec2     cursor_pos;
+uniform sampler2D occupancy_texture; // nonzero where a sprite is (see overlay_maze_occupancy.v.glsl)
+
+ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
+                          ivec2( 1,  1),  // ne
+                          ivec2( 1,  0),  // e
+                          ivec2( 1, -1),  // se
+                          ivec2( 0, -1),  // s
+                          ivec2(-1, -1),  // sw
+                          ivec2(-1,  0),  // w
+                          ivec2(-1,  1)); // nw
+
+// NOTE: sample at texel centers; texels off the board read as 0 (empty) through the sampler's zero border
+//       (see Texture::set_boundary_mode), so there is no border test
+float get_pixel(sampler2D texture, ivec2 offset) {
+    return texture2D(texture, (vec2(ivec2(gl_FragCoord.xy) + offset) + vec2(0.5)) / vec2(image_res)).r;
+}
+
+// FLOOD_RADIUS steps of "overlay_maze_distfield.f.glsl" in one pass: a step only reads the 8 neighbors, so after
+// k steps over the (2 * FLOOD_RADIUS + 1)^2 window the inner (2 * (FLOOD_RADIUS - k) + 1)^2 texels are exact, and
+// after FLOOD_RADIUS steps the center is
+// NOTE: walls are folded into the window up front (a wall neighbor reads as 0 or WALL_COLOR, neither of which can
+//       win the max), and so are texels off the board, which would otherwise be stepped like empty cells and carry
+//       the field around the edge; sprites are looked up in occupancy_texture for every texel in the window, which
+//       is exact as long as sprites do not move within FLOOD_RADIUS steps
+float window[FLOOD_WIDTH * FLOOD_WIDTH];
+float next_window[FLOOD_WIDTH * FLOOD_WIDTH];
+bool  is_sprite[FLOOD_WIDTH * FLOOD_WIDTH];
+
+void main() {
+    ivec2 cursor_pos_tex_space = ivec2(int((float(cursor_pos.x) / viewport_dim.x) * image_res.x),
+                                       int((float(cursor_pos.y) / viewport_dim.y) * image_res.y));
+    ivec2 seed_offset = cursor_pos_tex_space - ivec2(gl_FragCoord.xy);
+    for(int y = 0; y < FLOOD_WIDTH; y++) {
+        for(int x = 0; x < FLOOD_WIDTH; x++) {
+            ivec2 window_offset = ivec2(x, y) - ivec2(FLOOD_RADIUS);
+            ivec2 pos           = ivec2(gl_FragCoord.xy) + window_offset;
+            if(any(lessThan(pos, ivec2(0))) || any(greaterThanEqual(pos, image_res))) {
+                window[y * FLOOD_WIDTH + x]    = WALL_COLOR; // off the board
+                is_sprite[y * FLOOD_WIDTH + x] = false;
+                continue;
+            }
+            window[y * FLOOD_WIDTH + x]    = max(get_pixel(color_texture, window_offset), get_pixel(color_texture2, window_offset));
+            is_sprite[y * FLOOD_WIDTH + x] = (get_pixel(occupancy_texture, window_offset) != 0);
+        }
+    }
+    for(int k = 1; k <= FLOOD_RADIUS; k++) {
+        for(int y = k; y < FLOOD_WIDTH - k; y++) {
+            for(int x = k; x < FLOOD_WIDTH - k; x++) {
+                int   index         = y * FLOOD_WIDTH + x;
+                ivec2 window_offset = ivec2(x, y) - ivec2(FLOOD_RADIUS);
+                float merged_color  = window[index];
+                if(merged_color == WALL_COLOR) {
+                    next_window[index] = WALL_COLOR; // wall
+                } else if(merged_color == EMPTY_COLOR) {
+                    next_window[index] = mix(WALL_COLOR, SEED_COLOR, 1 - DECAY_FACTOR); // empty cell (init within WALL_COLOR..SEED_COLOR range)
+                } else if(is_sprite[index]) {
+                    next_window[index] = SPRITE_COLOR; // sprite
+                } else if(window_offset == seed_offset) {
+                    next_window[index] = SEED_COLOR; // seed
+                } else {
+                    float max_value = 0;
+                    for(int i = 0; i < 8; i++) {
+                        float current_value = window[index + offset[i].y * FLOOD_WIDTH + offset[i].x];
+                        if(current_value == WALL_COLOR || current_value == SPRITE_COLOR) { // ignore wall cell
+                            continue;
+                        }
+                        max_value = max(max_value, current_value);
+                    }
+                    next_window[index] = mix(max_value, WALL_COLOR, 1 - DECAY_FACTOR); // distance field
+                }
+            }
+        }
+        for(int y = k; y < FLOOD_WIDTH - k; y++) {
+            for(int x = k; x < FLOOD_WIDTH - k; x++) {
+                window[y * FLOOD_WIDTH + x] = next_window[y * FLOOD_WIDTH + x];
+            }
+        }
+    }
+    gl_FragColor = vec4(window[FLOOD_RADIUS * FLOOD_WIDTH + FLOOD_RADIUS]);
+}
\ No newline at end of file
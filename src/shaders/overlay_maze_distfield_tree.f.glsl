@@ -0,0 +1,120 @@
+// Inspired by Sidney Durant's tutorial: https://gamedevelopment.tutsplus.com/tutorials/understanding-goal-based-vector-field-pathfinding--gamedev-9007
+
+// the whole distance field in one pass, from the maze tree's ancestor levels (see overlay_maze_tree.f.glsl)
+// a maze without loops has one path between two cells, through their lowest common ancestor, which binary lifting
+// finds in O(LEVELS) lookups; its length is the hop costs from either cell up to the ancestor, except that the two
+// hops into the ancestor are costed by whether the path turns there (the costs in the tree assume it goes on up)
+// NOTE: the value is looked up by distance in the decay texture, which holds the distfield pass's decay applied once
+//       per step (see overlay_maze_decay.f.glsl), so a distfield pass after this one reproduces it exactly and the
+//       field is settled at once; sprites are not in the tree, so the passes that follow route around them
+// NOTE: exact only without loops; where grow has left loops, the tree drops an edge of each, cells whose shortest path
+//       crosses a dropped edge get too long a path here, and the passes that follow correct them by flooding, taking
+//       O(path) passes as without the tree
+
+// NOTE: must match MAZE_TREE_LEVELS in "src/main_maze.cpp"
+const int   LEVELS         = 13;
+const float MAX_JUMP       = 4096.0; // 2^(LEVELS - 1)
+const float MAX_DISTANCE   = 4096.0; // longer than any path on the board, must match MAZE_DECAY_TEX_DIM
+const float SPRITE_COLOR   = 0.25;
+const float WALL_COLOR     = 0.5;
+const float SEED_COLOR     = 1;
+const float DECAY_FACTOR   = 0.99;
+
+uniform sampler2D color_texture;  // maze tree, LEVELS boards tall
+uniform sampler2D color_texture2; // maze pattern
+uniform ivec2     viewport_dim;
+uniform ivec2     image_res;
+uniform ivec2     cursor_pos;
+uniform sampler2D occupancy_texture; // nonzero where a sprite is (see overlay_maze_occupancy.v.glsl)
+uniform sampler2D decay_texture;     // field value by distance, MAX_DISTANCE texels wide
+
+float get_pixel(sampler2D texture) {
+    return texture2D(texture, (floor(gl_FragCoord.xy) + vec2(0.5)) / vec2(image_res)).r;
+}
+
+// (ancestor.x, ancestor.y, hop cost, hop count) of the cell's 2^level-th ancestor
+// NOTE: rounded, as in overlay_maze_tree.f.glsl
+vec4 get_tree(vec2 pos, int level) {
+    return floor(0.5 + texture2D(color_texture, (pos + vec2(0.5, 0.5 + float(level * image_res.y))) / vec2(image_res.x, image_res.y * LEVELS)));
+}
+
+vec2 get_ancestor(vec2 pos, float hops) {
+    float jump = MAX_JUMP;
+    for(int k = LEVELS - 1; k >= 0; k--) {
+        if(hops >= jump) {
+            pos = get_tree(pos, k).xy;
+            hops -= jump;
+        }
+        jump *= 0.5;
+    }
+    return pos;
+}
+
+void main() {
+    if(get_pixel(color_texture2) == WALL_COLOR) {
+        gl_FragColor = vec4(WALL_COLOR); // wall
+        return;
+    }
+    if(get_pixel(occupancy_texture) != 0) {
+        gl_FragColor = vec4(SPRITE_COLOR); // sprite
+        return;
+    }
+    ivec2 cursor_pos_tex_space = ivec2(int((float(cursor_pos.x) / viewport_dim.x) * image_res.x),
+                                       int((float(cursor_pos.y) / viewport_dim.y) * image_res.y));
+    if(int(gl_FragCoord.x) == cursor_pos_tex_space.x &&
+       int(gl_FragCoord.y) == cursor_pos_tex_space.y)
+    {
+        gl_FragColor = vec4(SEED_COLOR); // seed
+        return;
+    }
+    vec2 cell = floor(gl_FragCoord.xy);
+    vec2 seed = vec2(cursor_pos_tex_space);
+    vec4 to_root      = get_tree(cell, LEVELS - 1); // (root, cost, depth)
+    vec4 seed_to_root = get_tree(seed, LEVELS - 1);
+    if(to_root.xy != seed_to_root.xy) {
+        gl_FragColor = vec4(mix(WALL_COLOR, SEED_COLOR, 1 - DECAY_FACTOR)); // unreachable (init as an empty cell)
+        return;
+    }
+
+    // lift the deeper of the two to one hop below the other's depth; if the other is its parent, that is the
+    // common ancestor and the last hop goes straight into the end of the path
+    float distance = -1.0;
+    vec2 a = cell;
+    vec2 b = seed;
+    if(to_root.w > seed_to_root.w) {
+        a = get_ancestor(cell, to_root.w - seed_to_root.w - 1.0);
+        vec4 hop = get_tree(a, 0);
+        if(hop.xy == seed) {
+            distance = to_root.z - seed_to_root.z - hop.z + 1.0;
+        }
+        a = hop.xy;
+    } else if(seed_to_root.w > to_root.w) {
+        b = get_ancestor(seed, seed_to_root.w - to_root.w - 1.0);
+        vec4 hop = get_tree(b, 0);
+        if(hop.xy == cell) {
+            distance = seed_to_root.z - to_root.z - hop.z + 1.0;
+        }
+        b = hop.xy;
+    }
+
+    // otherwise climb both to the common ancestor's children, and join them through it
+    if(distance < 0.0) {
+        for(int k = LEVELS - 1; k >= 0; k--) {
+            vec2 next_a = get_tree(a, k).xy;
+            vec2 next_b = get_tree(b, k).xy;
+            if(next_a != next_b) {
+                a = next_a;
+                b = next_b;
+            }
+        }
+        vec4 hop_a = get_tree(a, 0);
+        vec4 hop_b = get_tree(b, 0);
+        vec2 ancestor = hop_a.xy;
+        bool cut = (mod(ancestor, 2.0) == vec2(1.0) && dot(a - ancestor, b - ancestor) == 0.0); // turns on a maze cell
+        distance = to_root.z + seed_to_root.z - 2.0 * get_tree(ancestor, LEVELS - 1).z - hop_a.z - hop_b.z +
+                   (cut ? 1.0 : 2.0);
+    }
+
+    // NOTE: texel centers are exact in a float at a power of two width, so the lookup does not blend neighbors
+    gl_FragColor = vec4(texture2D(decay_texture, vec2((min(distance, MAX_DISTANCE - 1.0) + 0.5) / MAX_DISTANCE, 0.5)).r); // distance field
+}
@@ -14,12 +14,10 @@ ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
                           ivec2(-1,  0),  // w
                           ivec2(-1,  1)); // nw
 
+// NOTE: sample at texel centers; texels off the board read as 0 (empty) through the sampler's zero border
+//       (see Texture::set_boundary_mode), so there is no border test
 float get_pixel(sampler2D texture, ivec2 offset) {
-    vec2 pos = vec2(ivec2(gl_FragCoord.xy) + offset) / vec2(image_res - ivec2(1));
-    if((pos.x < 0 || pos.x > 1) || (pos.y < 0 || pos.y > 1)) {
-        return 0.0;
-    }
-    return texture2D(texture, pos).r;
+    return texture2D(texture, (vec2(ivec2(gl_FragCoord.xy) + offset) + vec2(0.5)) / vec2(image_res)).r;
 }
 
 void main() {
@@ -0,0 +1,5 @@
+// marks a texel occupied by at least one sprite; the rest of the texture is cleared to 0 before the points are drawn
+
+void main() {
+    gl_FragColor = vec4(1);
+}
\ No newline at end of file
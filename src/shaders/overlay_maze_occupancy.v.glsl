@@ -0,0 +1,16 @@
+// one point per sprite: moves the point to the texel its sprite occupies, so the points splat sprite occupancy into a
+// texture at field resolution (see "src/shaders/overlay_maze_occupancy.f.glsl")
+// NOTE: gl_Vertex.xy is the sprite's texel center in sprite_texture; point size stays at its default of 1 texel
+
+uniform sampler2D sprite_texture; // sprite state, one texel per sprite (see overlay_maze_sprites.f.glsl)
+uniform ivec2     image_res;      // distance field
+
+void main(void) {
+    vec4 state = texture2DLod(sprite_texture, gl_Vertex.xy, 0.0);
+    if(state.x < 0) {
+        gl_Position = vec4(2, 2, 0, 1); // yet to be spawned (clipped)
+        return;
+    }
+    // NOTE: truncates like the texel lookups in the maze shaders
+    gl_Position = vec4((vec2(ivec2(state.xy)) + vec2(0.5)) / vec2(image_res) * 2.0 - vec2(1.0), 0, 1);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+// Inspired by Sidney Durant's tutorial: https://gamedevelopment.tutsplus.com/tutorials/understanding-goal-based-vector-field-pathfinding--gamedev-9007
+
+// one fragment per sprite: steps it along the distance field gradient, or respawns it on a random empty cell once it
+// reaches the seed
+// NOTE: sprite state is (x, y, angle, velocity), positions in texels; a sprite with x < 0 has yet to be spawned
+
+const float FIELD_DIM      = 63.0; // NOTE: must match HI_RES_TEX_DIM in "src/main_maze.cpp"
+const float SPAWN_DIM      = 62.0; // NOTE: must match HALF_DIM * 2 in "src/main_maze.cpp"
+const float SPRITE_COLOR   = 0.25;
+const float WALL_COLOR     = 0.5;
+const float SEED_COLOR     = 1;
+const float EPSILON        = 0.0001; // NOTE: must match EPSILON in "include/Util.h"
+const float PI             = 3.14159265;
+const float ANGLE_VELOCITY = PI * 0.1; // NOTE: must match SPRITE_ANGLE_VELOCITY in "src/main_maze.cpp"
+const int   MAX_TRIES      = 16; // random picks per respawn or random step; the sprite waits for the next pass if all fail
+
+uniform sampler2D color_texture;  // sprite state
+uniform sampler2D color_texture2; // distance field
+uniform ivec2     image_res;      // sprite state
+uniform int       sprite_count;
+uniform int       random_seed;
+
+ivec2 offset[8] = ivec2[](ivec2( 0,  1),  // n
+                          ivec2( 1,  1),  // ne
+                          ivec2( 1,  0),  // e
+                          ivec2( 1, -1),  // se
+                          ivec2( 0, -1),  // s
+                          ivec2(-1, -1),  // sw
+                          ivec2(-1,  0),  // w
+                          ivec2(-1,  1)); // nw
+
+// NOTE: truncates like the texel lookups in "src/main_maze.cpp"; texels off the board read as 0 (empty) through the
+//       sampler's zero border
+float get_field(vec2 pos) {
+    return texture2D(color_texture2, (vec2(ivec2(pos)) + vec2(0.5)) / vec2(FIELD_DIM)).r;
+}
+
+// hash without sine (Dave Hoskins), in [0, 1); a different stream per sprite and per pass
+float get_random(int sprite_index, int salt) {
+    vec3 p = fract(vec3(float(sprite_index), float(random_seed), float(salt)) * 0.1031);
+    p += dot(p, p.zyx + 31.32);
+    return fract((p.x + p.y) * p.z);
+}
+
+vec4 respawn(int sprite_index, vec4 state) {
+    for(int i = 0; i < MAX_TRIES; i++) {
+        vec2 respawn_point = floor(vec2(get_random(sprite_index, i * 2), get_random(sprite_index, i * 2 + 1)) * SPAWN_DIM);
+        if(get_field(respawn_point) != WALL_COLOR) {
+            return vec4(respawn_point, state.zw);
+        }
+    }
+    return state;
+}
+
+void main() {
+    ivec2 texel        = ivec2(gl_FragCoord.xy);
+    int   sprite_index = texel.y * image_res.x + texel.x;
+    vec4  state        = texture2D(color_texture, (vec2(texel) + vec2(0.5)) / vec2(image_res));
+    if(sprite_index >= sprite_count) {
+        gl_FragColor = state; // unused
+        return;
+    }
+    if(state.x < 0) {
+        gl_FragColor = respawn(sprite_index, state);
+        return;
+    }
+    vec2  pos        = state.xy;
+    float max_value  = min(WALL_COLOR, SEED_COLOR);
+    float min_value  = max(WALL_COLOR, SEED_COLOR);
+    vec2  max_offset = vec2(0); // NOTE: stays put if no neighbor is open
+    vec2  min_offset = vec2(0);
+    for(int i = 0; i < 8; i++) {
+        vec2  move_to_point  = normalize(vec2(offset[i]));
+        float value_neighbor = get_field(pos + move_to_point);
+        if(value_neighbor == WALL_COLOR || value_neighbor == SPRITE_COLOR) {
+            continue;
+        }
+        if(value_neighbor > max_value) {
+            max_value  = value_neighbor;
+            max_offset = move_to_point;
+        }
+        if(value_neighbor < min_value) {
+            min_value  = value_neighbor;
+            min_offset = move_to_point;
+        }
+    }
+    if(abs(max_value - SEED_COLOR) < EPSILON) { // respawn if near target
+        gl_FragColor = respawn(sprite_index, state);
+        return;
+    }
+    if(max_value == min_value) { // equally attractive choices
+        for(int i = 0; i < MAX_TRIES; i++) {
+            int  seed_index    = int(get_random(sprite_index, MAX_TRIES * 2 + i) * 8.0); // pick one at random
+            vec2 move_to_point = normalize(vec2(offset[seed_index]));
+            if(get_field(pos + move_to_point) != WALL_COLOR) {
+                gl_FragColor = vec4(pos + move_to_point, state.zw);
+                return;
+            }
+        }
+        gl_FragColor = state;
+        return;
+    }
+#if 1
+    // simple path finding
+    gl_FragColor = vec4(pos + max_offset, state.zw);
+#else
+    // fancy path finding (limit turning speed)
+    float target_angle  = -atan(max_offset.x, max_offset.y) + PI * 0.5;
+    float angle         = mod(state.z, PI * 2.0);
+    float velocity      = state.w;
+    float turn_polarity = (abs(target_angle - angle) < PI ? 1.0 : -1.0);
+    if(target_angle > angle) {
+        angle += ANGLE_VELOCITY * turn_polarity;
+    } else if(target_angle < angle) {
+        angle -= ANGLE_VELOCITY * turn_polarity;
+    }
+    vec2 new_pos = pos + vec2(cos(angle), sin(angle)) * velocity;
+    if(get_field(new_pos) == WALL_COLOR) {
+        gl_FragColor = vec4(pos + max_offset, angle, velocity); // to prevent going through walls
+        return;
+    }
+    gl_FragColor = vec4(new_pos, angle, velocity);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+// one pointer-jumping pass over the maze tree (see vt::gen_maze_tree_rgba32f): LEVELS boards stacked bottom to top,
+// level k holding each cell's 2^k-th ancestor (its root if the tree is not that deep) and the hop cost and count to
+// it, in one RGBA32F texel
+// every pass rebuilds level k from two hops of level k - 1, so starting from LEVELS copies of level 0, level k is
+// exact after k passes and the whole stack after LEVELS - 1
+
+// NOTE: must match MAZE_TREE_LEVELS in "src/main_maze.cpp"
+const int LEVELS = 13;
+
+uniform sampler2D color_texture;
+uniform ivec2     image_res; // LEVELS boards tall
+
+// NOTE: every channel is a whole number; round, since the sampler's min filter is linear (see Texture::alloc) and a
+//       read at a looked-up position can count as minified
+vec4 get_tree(vec2 pos, int level, int board_height) {
+    return floor(0.5 + texture2D(color_texture, (pos + vec2(0.5, 0.5 + float(level * board_height))) / vec2(image_res)));
+}
+
+void main() {
+    int board_height = image_res.y / LEVELS;
+    int level = int(gl_FragCoord.y) / board_height;
+    vec2 pos = vec2(floor(gl_FragCoord.x), floor(gl_FragCoord.y) - float(level * board_height));
+    if(level == 0) {
+        gl_FragColor = get_tree(pos, 0, board_height); // parent links, as uploaded
+        return;
+    }
+    vec4 hop  = get_tree(pos, level - 1, board_height);
+    vec4 hop2 = get_tree(hop.xy, level - 1, board_height);
+    gl_FragColor = vec4(hop2.xy, hop.z + hop2.z, hop.w + hop2.w);
+}